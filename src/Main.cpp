@@ -3,14 +3,22 @@
 #include <stdexcept>
 
 #include "afk/Engine.hpp"
+#include "afk/debug/Benchmark.hpp"
 
-auto main([[maybe_unused]] i32 argc, [[maybe_unused]] char **argv) -> i32 {
-  auto &afk = afk::Engine::get();
+auto main(i32 argc, char **argv) -> i32 {
+  afk::Engine::set_launch_options(afk::config::parse_launch_options(argc, argv));
+  auto &afk           = afk::Engine::get();
+  const auto &options = afk::Engine::get_launch_options();
 
   while (afk.get_is_running()) {
+    const auto timer = afk::debug::Benchmark::Scope{afk.benchmark, "frame"};
     afk.update();
     afk.render();
   }
 
+  if (options.bench_out.has_value()) {
+    afk.write_benchmark_report(options.bench_out.value());
+  }
+
   return EXIT_SUCCESS;
 }
@@ -1,5 +1,7 @@
 #include "afk/Engine.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <memory>
@@ -8,7 +10,10 @@
 
 #include "afk/config/Config.hpp"
 #include "afk/debug/Assert.hpp"
+#include "afk/debug/Profiler.hpp"
+#include "afk/ecs/component/ColliderComponent.hpp"
 #include "afk/ecs/system/PhysicsSystem.hpp"
+#include "afk/ecs/system/RenderSystem.hpp"
 #include "afk/io/Json.hpp"
 #include "afk/io/JsonSerialization.hpp"
 #include "afk/io/Log.hpp"
@@ -17,12 +22,17 @@
 #include "afk/io/Unicode.hpp"
 #include "afk/render/Model.hpp"
 #include "afk/render/Renderer.hpp"
+#include "afk/scene/SceneGenerator.hpp"
+#include "cmake/Git.hpp"
+#include "cmake/Version.hpp"
 
 using namespace std::string_literals;
 
 using afk::Engine;
 using afk::config::Config;
 using afk::config::ConfigManager;
+using afk::ecs::component::ColliderComponent;
+using afk::ecs::system::RenderSystem;
 using afk::event::Event;
 using afk::io::Json;
 using std::filesystem::path;
@@ -37,54 +47,116 @@ auto Engine::get() -> Engine & {
   return instance;
 }
 
+auto Engine::set_launch_options(const config::LaunchOptions &options) -> void {
+  Engine::launch_options = options;
+}
+
+auto Engine::get_launch_options() -> const config::LaunchOptions & {
+  return Engine::launch_options;
+}
+
 auto Engine::initialize() -> void {
   afk_assert(!this->is_initialized, "Engine already initialized");
   this->is_initialized = true;
   afk::io::create_engine_dirs();
   afk::io::log << afk::io::get_date_time() << "afk engine starting...\n";
+  afk_profile_thread("Main");
   this->config_manager.initialize();
-  this->ecs.initialize();
-  this->renderer.initialize();
-  this->event_manager.initialize(this->renderer.window);
-  this->ui_manager.initialize(this->renderer.window);
-  this->collision_system.initialize();
-  this->physics_system.initialize();
+  this->job_manager.initialize();
+  // logged here, as the log depends on the engine and the job manager is linked into unit tests
+  afk::io::log << afk::io::get_date_time() << "Job subsystem initialized with "
+               << this->job_manager.get_worker_count() << " worker threads\n";
+  this->benchmark.set_is_enabled(Engine::launch_options.bench_out.has_value());
+
+  // without a window there is nothing to draw to or take input from
+  if (this->get_is_headless()) {
+    this->renderer.initialize_headless();
+  } else {
+    this->renderer.initialize();
+    this->event_manager.initialize(this->renderer.window);
+    this->ui_manager.initialize(this->renderer.window);
+  }
+
+  this->world.initialize();
   this->prefab_manager.initialize();
   this->scene_manager.initialize();
 
+  if (Engine::launch_options.generate.has_value()) {
+    const auto &settings = Engine::launch_options.generate.value();
+    afk_assert(this->prefab_manager.prefab_map.count(settings.prefab) == 1,
+               "Unknown prefab '"s + settings.prefab + "'"s);
+
+    const auto json = scene::SceneGenerator::generate(
+        settings, this->prefab_manager.prefab_map.at(settings.prefab));
+    this->scene_manager.add_scene(json);
+
+    if (Engine::launch_options.generate_out.has_value()) {
+      afk::io::write_json_to_file(Engine::launch_options.generate_out.value(), json);
+      afk::io::log << afk::io::get_date_time() << "Wrote generated scene to "
+                   << Engine::launch_options.generate_out.value() << '\n';
+    }
+  }
+
+  if (Engine::launch_options.record.has_value()) {
+    this->event_recorder.emplace(Engine::launch_options.record.value());
+    afk::io::log << afk::io::get_date_time() << "Recording input to "
+                 << Engine::launch_options.record.value() << '\n';
+  } else if (Engine::launch_options.replay.has_value()) {
+    // live input would make the replay diverge from the recording
+    this->event_replayer.emplace(Engine::launch_options.replay.value());
+    this->event_manager.set_is_input_enabled(false);
+    afk::io::log << afk::io::get_date_time() << "Replaying input from "
+                 << Engine::launch_options.replay.value() << '\n';
+  }
+
   this->event_manager.register_event(Event::Type::MouseMove,
-                                     event::EventManager::Callback{[this](Event event) {
+                                     event::EventManager::Callback{[this](const Event &event) {
                                        this->move_mouse(event);
                                      }});
 
   this->event_manager.register_event(
-      Event::Type::KeyDown, event::EventManager::Callback{[this](Event event) {
+      Event::Type::KeyDown, event::EventManager::Callback{[this](const Event &event) {
         this->move_keyboard(event);
       }});
   this->event_manager.register_event(
-      Event::Type::KeyUp, event::EventManager::Callback{[this](Event event) {
+      Event::Type::KeyUp, event::EventManager::Callback{[this](const Event &event) {
         this->move_keyboard(event);
       }});
   this->event_manager.register_event(Event::Type::KeyRepeat,
-                                     event::EventManager::Callback{[this](Event event) {
+                                     event::EventManager::Callback{[this](const Event &event) {
                                        this->move_keyboard(event);
                                      }});
 
-  this->scene_manager.instantiate_scene("default");
+  const auto &scene = Engine::launch_options.scene;
+  afk_assert(this->scene_manager.scene_map.count(scene) == 1,
+             "Unknown scene '"s + scene + "'"s);
+  this->scene_manager.instantiate_scene(scene, this->world);
 
   this->last_update = afk::Engine::get_time();
 }
 
 auto Engine::render() -> void {
+  afk_profile_scope("Engine::render");
+
+  if (this->get_is_headless()) {
+    return;
+  }
+
+  const auto timer = debug::Benchmark::Scope{this->benchmark, "render"};
+
   this->renderer.clear_screen({135.0f, 206.0f, 235.0f, 1.0f});
-  this->ecs.system_manager.display_update();
+  this->world.ecs.system_manager.display_update(this->world,
+                                                this->get_delta_time());
+
+  // the debug mesh and UI read the simulation directly, so it must be finished
+  this->job_manager.wait(this->simulation);
 
   auto mesh_model_transform        = physics::Transform{};
   mesh_model_transform.translation = glm::vec3{0.0f, 0.0f, 0.0f};
   mesh_model_transform.rotation    = glm::identity<glm::quat>();
 
   // if (this->display_debug_physics_mesh) {
-  //  auto debug_mesh = this->collision_system.get_debug_mesh();
+  //  auto debug_mesh = this->world.collision_system.get_debug_mesh();
   //  if (debug_mesh.vertices.size() > 0) {
   //    const auto shader =
   //        this->renderer.get_shader_program("res/shader/default.prog");
@@ -93,7 +165,7 @@ auto Engine::render() -> void {
   //}
 
   if (this->display_debug_physics_mesh) {
-    auto debug_mesh = this->collision_system.get_regular_debug_mesh();
+    auto debug_mesh = this->world.collision_system.get_regular_debug_mesh();
     if (!debug_mesh.vertices.empty()) {
       const auto old_wireframe_status = this->renderer.get_wireframe();
       if (!old_wireframe_status) {
@@ -127,7 +199,33 @@ auto Engine::render() -> void {
 }
 
 auto Engine::update() -> void {
-  const auto dt = this->get_delta_time();
+  // each frame starts with an update
+  afk_profile_frame();
+  afk_profile_scope("Engine::update");
+  const auto timer = debug::Benchmark::Scope{this->benchmark, "update"};
+
+  const auto &simulation = this->config_manager.config.simulation;
+
+  // when headless, run each update as a single tick as fast as possible
+  // instead of waiting for wall-clock time to pass
+  auto dt = this->get_is_headless() && simulation.fixed_timestep_enabled
+                ? 1.0f / simulation.tick_rate
+                : this->get_delta_time();
+
+  auto replayed_frame = std::optional<event::EventReplayer::Frame>{};
+
+  if (this->event_replayer.has_value()) {
+    replayed_frame = this->event_replayer->next_frame();
+
+    if (!replayed_frame.has_value()) {
+      afk::io::log << afk::io::get_date_time() << "Replay finished\n";
+      this->is_running = false;
+      return;
+    }
+
+    dt = replayed_frame->dt;
+  }
+
   if (this->camera.get_key(render::Camera::Movement::Forward)) {
     this->camera.handle_key(render::Camera::Movement::Forward, dt);
   }
@@ -141,24 +239,95 @@ auto Engine::update() -> void {
     this->camera.handle_key(render::Camera::Movement::Backward, dt);
   }
 
-  // Update physics before running collisions
-  this->physics_system.update();
-  this->collision_system.update();
-  this->ecs.system_manager.update();
-  this->event_manager.pump_events();
+  this->event_manager.poll_events();
 
-  if (glfwWindowShouldClose(this->renderer.window.get())) {
-    this->is_running = false;
+  if (replayed_frame.has_value()) {
+    for (const auto &event : replayed_frame->events) {
+      this->event_manager.push_event(event);
+    }
+  } else if (this->event_recorder.has_value()) {
+    this->event_recorder->record_frame(dt, this->event_manager.get_polled_events());
   }
 
-  if (this->ui_manager.show_menu) {
-    glfwSetInputMode(this->renderer.window.get(), GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+  // input callbacks change the camera, UI and renderer, which are drawn while
+  // the simulation runs, so they're called here rather than by the simulation
+  this->event_manager.dispatch_input_events();
+
+  if (!this->get_is_headless()) {
+    if (glfwWindowShouldClose(this->renderer.window.get())) {
+      this->is_running = false;
+    }
+
+    if (this->ui_manager.show_menu) {
+      glfwSetInputMode(this->renderer.window.get(), GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+    } else {
+      glfwSetInputMode(this->renderer.window.get(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
+  }
+
+  // ReactPhysics3D is only updated for the debug mesh while it's displayed
+  this->world.collision_system.is_debug_mesh_enabled =
+      this->display_debug_physics_mesh && !this->get_is_headless();
+
+  // there's nothing to draw alongside when headless
+  if (simulation.pipelining_enabled && !this->get_is_headless()) {
+    // rendering only reads the snapshot, so the simulation can advance while
+    // the current state is drawn
+    RenderSystem::build_snapshot(this->world, this->render_snapshot);
+    this->job_manager.submit([this, dt]() { this->simulate(dt); }, &this->simulation);
   } else {
-    glfwSetInputMode(this->renderer.window.get(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    this->simulate(dt);
+
+    if (!this->get_is_headless()) {
+      RenderSystem::build_snapshot(this->world, this->render_snapshot);
+    }
   }
 
   ++this->frame_count;
   this->last_update = afk::Engine::get_time();
+
+  const auto &frames = Engine::launch_options.frames;
+  if (frames.has_value() && this->frame_count >= frames.value()) {
+    this->is_running = false;
+  }
+}
+
+auto Engine::simulate(f32 dt) -> void {
+  afk_profile_scope("Engine::simulate");
+
+  const auto &simulation = this->config_manager.config.simulation;
+
+  if (simulation.fixed_timestep_enabled) {
+    const auto tick_dt = 1.0f / simulation.tick_rate;
+
+    // Cap how far behind the simulation can fall, otherwise a slow frame
+    // causes more ticks next frame which makes it slower still.
+    this->tick_accumulator =
+        std::min(this->tick_accumulator + dt,
+                 tick_dt * static_cast<f32>(simulation.max_ticks_per_frame));
+
+    while (this->tick_accumulator >= tick_dt) {
+      this->tick(tick_dt);
+      this->tick_accumulator -= tick_dt;
+    }
+
+    this->interpolation_alpha = this->tick_accumulator / tick_dt;
+  } else {
+    this->tick(dt);
+    this->interpolation_alpha = 1.0f;
+  }
+
+  this->event_manager.dispatch_events();
+}
+
+auto Engine::tick(f32 dt) -> void {
+  afk_profile_scope("Engine::tick");
+  const auto timer = debug::Benchmark::Scope{this->benchmark, "tick"};
+
+  this->world.step(dt);
+  this->world.collision_system.update_camera_raycast(this->camera);
+  this->event_manager.dispatch_events();
+  ++this->tick_count;
 }
 
 auto Engine::exit() -> void {
@@ -172,19 +341,68 @@ auto Engine::exit() -> void {
   this->is_running = false;
 }
 
+auto Engine::write_benchmark_report(const path &file_path) -> void {
+  // the last update may have left a simulation running
+  this->job_manager.wait(this->simulation);
+
+  auto &registry = this->world.ecs.registry;
+  auto json      = Json{};
+
+  json["scene"]    = Engine::launch_options.scene;
+  json["headless"] = this->get_is_headless();
+  json["frames"]   = this->frame_count;
+  json["ticks"]    = this->tick_count;
+  json["build"]    = {{"version", afk::io::to_cstr(AFK_VERSION)},
+                   {"commit", afk::io::to_cstr(GIT_HEAD_HASH)},
+                   {"dirty", GIT_IS_DIRTY}};
+  json["entities"]    = registry.alive();
+  json["colliders"]   = registry.view<ColliderComponent>().size();
+  json["peak_memory"] = debug::Benchmark::get_peak_memory();
+  json["timings"]     = this->benchmark.get_summaries();
+
+  const auto broad_phase = this->world.collision_system.get_broad_phase_stats();
+  json["broad_phase"]    = {{"height", broad_phase.height},
+                         {"proxies", broad_phase.proxy_count},
+                         {"nodes", broad_phase.node_count},
+                         {"area_ratio", broad_phase.area_ratio},
+                         {"refits", broad_phase.refit_count},
+                         {"reinserts", broad_phase.reinsert_count},
+                         {"rotations", broad_phase.rotation_count}};
+
+  afk::io::write_json_to_file(file_path, json);
+  afk::io::log << afk::io::get_date_time() << "Wrote benchmark report to "
+               << file_path << '\n';
+}
+
 auto Engine::get_time() -> f32 {
-  return static_cast<f32>(glfwGetTime());
+  // not using glfwGetTime() as GLFW isn't initialized when running headless
+  using Clock             = std::chrono::steady_clock;
+  static const auto start = Clock::now();
+
+  return std::chrono::duration<f32>(Clock::now() - start).count();
 }
 
 auto Engine::get_delta_time() -> f32 {
   return this->get_time() - this->last_update;
 }
 
+auto Engine::get_interpolation_alpha() const -> f32 {
+  return this->interpolation_alpha;
+}
+
+auto Engine::get_render_snapshot() const -> const render::RenderSnapshot & {
+  return this->render_snapshot;
+}
+
+auto Engine::get_is_headless() const -> bool {
+  return Engine::launch_options.headless;
+}
+
 auto Engine::get_is_running() const -> bool {
   return this->is_running;
 }
 
-auto Engine::move_mouse(Event event) -> void {
+auto Engine::move_mouse(const Event &event) -> void {
   const auto data = std::get<Event::MouseMove>(event.data);
 
   static auto last_x      = 0.0f;
@@ -204,7 +422,7 @@ auto Engine::move_mouse(Event event) -> void {
   last_y = static_cast<f32>(data.y);
 }
 
-auto Engine::move_keyboard(Event event) -> void {
+auto Engine::move_keyboard(const Event &event) -> void {
   const auto key = std::get<Event::Key>(event.data).key;
 
   // proccess key down events
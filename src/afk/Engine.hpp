@@ -1,19 +1,26 @@
 #pragma once
 
+#include <filesystem>
+#include <optional>
+
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
 
 #include "afk/NumericTypes.hpp"
+#include "afk/World.hpp"
 #include "afk/config/ConfigManager.hpp"
-#include "afk/ecs/Ecs.hpp"
+#include "afk/config/LaunchOptions.hpp"
+#include "afk/debug/Benchmark.hpp"
 #include "afk/event/EventManager.hpp"
+#include "afk/event/EventRecorder.hpp"
+#include "afk/event/EventReplayer.hpp"
+#include "afk/job/JobManager.hpp"
 #include "afk/prefab/PrefabManager.hpp"
 #include "afk/render/Camera.hpp"
+#include "afk/render/RenderSnapshot.hpp"
 #include "afk/render/Renderer.hpp"
 #include "afk/scene/SceneManager.hpp"
 #include "afk/ui/UiManager.hpp"
-#include "afk/ecs/system/CollisionSystem.hpp"
-#include "afk/ecs/system/PhysicsSystem.hpp"
 
 namespace afk {
   /**
@@ -26,8 +33,10 @@ namespace afk {
 
     /** The config subsystem. */
     config::ConfigManager config_manager = {};
-    /** The ECS subsystem. */
-    ecs::Ecs ecs = {};
+    /** The job subsystem, declared early so it outlives the subsystems using it. */
+    job::JobManager job_manager = {};
+    /** The benchmark subsystem, only enabled when a report was requested. */
+    debug::Benchmark benchmark = {};
     /** The rendering subsystem. */
     render::Renderer renderer = {};
     /** The event subsystem. */
@@ -40,10 +49,9 @@ namespace afk {
     prefab::PrefabManager prefab_manager = {};
     /** The scene subsystem. */
     scene::SceneManager scene_manager = {};
-    /** The collision subsystem. */
-    ecs::system::CollisionSystem collision_system = {};
-    /** The physics subsystem. */
-    ecs::system::PhysicsSystem physics_system = {};
+    /** The world being simulated and drawn. */
+    World world = World{this->job_manager};
+
   private:
     Engine()  = default;
     ~Engine() = default;
@@ -61,6 +69,21 @@ namespace afk {
      */
     static auto get() -> Engine &;
 
+    /**
+     * Sets the options the engine is launched with. Must be called before the
+     * engine is first accessed, as they are only read on initialization.
+     *
+     * @param options The launch options.
+     */
+    static auto set_launch_options(const config::LaunchOptions &options) -> void;
+
+    /**
+     * Returns the options the engine was launched with.
+     *
+     * @return The launch options.
+     */
+    static auto get_launch_options() -> const config::LaunchOptions &;
+
     /**
      * Initializes the afk engine.
      */
@@ -68,11 +91,24 @@ namespace afk {
 
     /**
      * Draws one frame and swaps the front and back framebuffer.
+     *
+     * When pipelining is enabled, the simulation started by the last update
+     * runs while the frame is drawn, and is finished before returning.
      */
     auto render() -> void;
 
     /**
-     * Advances the game simulation for one tick.
+     * Advances the game simulation by the time elapsed since the last update.
+     *
+     * When the fixed timestep is enabled, the simulation is advanced in whole
+     * ticks of the configured tick rate and any remaining time is carried over
+     * to the next update.
+     *
+     * When pipelining is enabled, the current state is captured for rendering
+     * and the simulation is started as a job which the next render waits on.
+     *
+     * When replaying, the input and delta time come from the recording
+     * instead, and the engine stops once the recording ends.
      */
     auto update() -> void;
 
@@ -81,10 +117,19 @@ namespace afk {
      */
     auto exit() -> void;
 
+    /**
+     * Writes a report of the benchmark timings, along with the size of the
+     * world and the peak memory usage, to the specified file.
+     *
+     * @param file_path The path to write the report to.
+     */
+    auto write_benchmark_report(const std::filesystem::path &file_path) -> void;
+
     /**
      * Returns the current time in seconds.
      *
-     * The current time is counted since the start of the engine.
+     * The current time is counted since it was first requested, which happens
+     * during engine initialization.
      *
      * @return Returns the current time in seconds.
      */
@@ -97,6 +142,28 @@ namespace afk {
      */
     auto get_delta_time() -> f32;
 
+    /**
+     * Returns how far rendering is between the previous and the current
+     * simulation tick.
+     *
+     * @return The interpolation factor, between 0 and 1.
+     */
+    auto get_interpolation_alpha() const -> f32;
+
+    /**
+     * Returns the snapshot drawn by the next render.
+     *
+     * @return The render snapshot.
+     */
+    auto get_render_snapshot() const -> const render::RenderSnapshot &;
+
+    /**
+     * Returns if the engine is running without a window, renderer or UI.
+     *
+     * @return True if the engine is headless.
+     */
+    auto get_is_headless() const -> bool;
+
     /**
      * Returns if the engine is running.
      *
@@ -110,7 +177,7 @@ namespace afk {
      *
      * @param event The mouse move event.
      */
-    auto move_mouse(event::Event event) -> void;
+    auto move_mouse(const event::Event &event) -> void;
 
     /**
      * Handles a key being pressed.
@@ -118,24 +185,50 @@ namespace afk {
      *
      * @param event The key press event.
      */
-    auto move_keyboard(event::Event event) -> void;
+    auto move_keyboard(const event::Event &event) -> void;
 
     bool display_debug_physics_mesh = false;
 
-    // todo move this to a physics class of some sort
-    bool gravity_enabled = false;
+  private:
+    /**
+     * Advances the simulation by the specified time, in whole ticks when the
+     * fixed timestep is enabled, then calls the queued event callbacks.
+     *
+     * @param dt The time to advance by, in seconds.
+     */
+    auto simulate(f32 dt) -> void;
 
-    // todo move this to a physics class of some sort
-    glm::vec3 gravity = {0.0f, -9.81f, 0.0f};
+    /**
+     * Advances the simulation by a single tick.
+     *
+     * @param dt The tick length, in seconds.
+     */
+    auto tick(f32 dt) -> void;
+
+    /** The options the engine was launched with. */
+    inline static config::LaunchOptions launch_options = {};
 
-  private:
     /** Is the engine initialized? */
     bool is_initialized = false;
     /** Is the engine running? */
     bool is_running = true;
     /** The number of frames rendered since the engine started. */
     i32 frame_count = {};
+    /** The number of simulation ticks since the engine started. */
+    i32 tick_count = {};
     /** The time, in seconds, since the last update. */
     f32 last_update = {};
+    /** The simulation time, in seconds, not yet consumed by a tick. */
+    f32 tick_accumulator = {};
+    /** How far rendering is between the previous and current tick. */
+    f32 interpolation_alpha = 1.0f;
+    /** The state captured by the last update, drawn by the next render. */
+    render::RenderSnapshot render_snapshot = {};
+    /** Counts the simulation job started by the last update, if pipelining. */
+    job::JobManager::Counter simulation = {};
+    /** Records each frame's input and delta time, if recording. */
+    std::optional<event::EventRecorder> event_recorder = std::nullopt;
+    /** Replaces each frame's input and delta time with a recording, if replaying. */
+    std::optional<event::EventReplayer> event_replayer = std::nullopt;
   };
 }
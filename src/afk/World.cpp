@@ -0,0 +1,22 @@
+#include "afk/World.hpp"
+
+#include "afk/debug/Assert.hpp"
+
+using afk::World;
+
+World::World(job::JobManager &job_manager)
+  : job_manager(job_manager), collision_system(*this), physics_system(*this) {}
+
+auto World::initialize() -> void {
+  afk_assert(!this->is_initialized, "World already initialized");
+  this->ecs.initialize();
+  this->collision_system.initialize();
+  this->physics_system.initialize();
+  this->is_initialized = true;
+}
+
+auto World::step(f32 dt) -> void {
+  afk_assert(this->is_initialized, "World not initialized");
+  this->ecs.update(*this, dt);
+  this->event_manager.dispatch_events();
+}
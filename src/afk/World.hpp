@@ -0,0 +1,68 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/ecs/Ecs.hpp"
+#include "afk/ecs/system/CollisionSystem.hpp"
+#include "afk/ecs/system/PhysicsSystem.hpp"
+#include "afk/event/EventManager.hpp"
+#include "afk/job/JobManager.hpp"
+
+namespace afk {
+  /**
+   * Encapsulates a single simulated world: its entities, collision world,
+   * physics, and the events raised while stepping it.
+   *
+   * Worlds share no simulation state with each other, so any number of worlds
+   * can be created and stepped on separate threads. Assets such as prefabs,
+   * scenes, and models are still loaded once by the engine and shared.
+   */
+  class World {
+  public:
+    /** The job manager the world's systems spread their work across. */
+    job::JobManager &job_manager;
+    /** The entities and the systems that operate on them. */
+    ecs::Ecs ecs = {};
+    /** The events raised while stepping, such as collisions. */
+    event::EventManager event_manager = {};
+    /** The collision subsystem. */
+    ecs::system::CollisionSystem collision_system;
+    /** The physics subsystem. */
+    ecs::system::PhysicsSystem physics_system;
+
+    /** Is gravity applied to rigid bodies? */
+    bool gravity_enabled = false;
+    /** The gravity acceleration applied to rigid bodies. */
+    glm::vec3 gravity = {0.0f, -9.81f, 0.0f};
+
+    /**
+     * Constructs a world.
+     *
+     * @param job_manager The job manager to spread the world's work across.
+     */
+    explicit World(job::JobManager &job_manager);
+    ~World()             = default;
+    World(World &&)      = delete;
+    World(const World &) = delete;
+    auto operator=(const World &) -> World & = delete;
+    auto operator=(World &&) -> World & = delete;
+
+    /**
+     * Initializes the world and its subsystems.
+     */
+    auto initialize() -> void;
+
+    /**
+     * Advances the world by a single step, then calls the callbacks of the
+     * events raised during it.
+     *
+     * @param dt The time to advance by, in seconds.
+     */
+    auto step(f32 dt) -> void;
+
+  private:
+    /** Is the world initialized? */
+    bool is_initialized = false;
+  };
+}
@@ -28,12 +28,28 @@ namespace afk {
       bool vsync_enabled = true;
     };
 
+    /**
+     * Encapsulates the simulation configuration options.
+     */
+    struct Simulation {
+      /** Is the simulation stepped at a fixed rate, independent of rendering? */
+      bool fixed_timestep_enabled = true;
+      /** How many simulation ticks to run per second. */
+      f32 tick_rate = 60.0f;
+      /** The maximum number of ticks to catch up on in a single frame. */
+      i32 max_ticks_per_frame = 5;
+      /** Is the simulation advanced while the previous update is drawn? */
+      bool pipelining_enabled = true;
+    };
+
     /**
      * Encapsulates the engine configuration options.
      */
     struct Config {
       /** The video configuration. */
       Video video = {};
+      /** The simulation configuration. */
+      Simulation simulation = {};
     };
   }
 }
@@ -24,9 +24,19 @@ auto ConfigManager::load_config_file() -> void {
     json      = this->config;
     afk::io::write_json_to_file(config_path, json);
   } else {
-    auto json    = afk::io::read_json_from_file(config_path);
+    // Layer the config file over the defaults, so options added since the
+    // file was written keep their default values.
+    auto json = Json{};
+    json      = this->config;
+    json.merge_patch(afk::io::read_json_from_file(config_path));
     this->config = json.get<Config>();
   }
+
+  // the tick length is one over the tick rate, and the tick accumulator is clamped to a whole number of ticks
+  afk_assert(this->config.simulation.tick_rate > 0.0f,
+             "Config simulation tick_rate must be greater than 0");
+  afk_assert(this->config.simulation.max_ticks_per_frame > 0,
+             "Config simulation max_ticks_per_frame must be greater than 0");
 }
 
 auto ConfigManager::initialize() -> void {
@@ -0,0 +1,119 @@
+#include "afk/config/LaunchOptions.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "afk/debug/Assert.hpp"
+
+using namespace std::string_literals;
+using std::string;
+
+using afk::scene::SceneGenerator;
+
+namespace afk {
+  namespace config {
+    auto parse_launch_options(i32 argc, char **argv) -> LaunchOptions {
+      auto options       = LaunchOptions{};
+      auto settings      = SceneGenerator::Settings{};
+      auto is_generating = false;
+      auto has_settings  = false;
+      auto has_scene     = false;
+
+      // The first argument is the executable path.
+      for (auto i = i32{1}; i < argc; ++i) {
+        const auto arg = string{argv[i]};
+
+        // Returns the value following the current option.
+        const auto get_value = [&]() {
+          afk_assert(i + 1 < argc, "Launch option '"s + arg + "' requires a value"s);
+          return string{argv[++i]};
+        };
+
+        // Returns the value following the current option as a whole number no larger than max.
+        const auto get_whole_number = [&](u64 max) {
+          const auto value = get_value();
+          auto is_valid    = value.find_first_not_of("0123456789") == string::npos && !value.empty();
+          auto number      = u64{0};
+
+          // report numbers too large to parse the same as any other bad value, rather than throwing
+          if (is_valid) {
+            try {
+              number = std::stoull(value);
+            } catch (const std::invalid_argument &) {
+              is_valid = false;
+            } catch (const std::out_of_range &) {
+              is_valid = false;
+            }
+          }
+
+          afk_assert(is_valid && number <= max, "Launch option '"s + arg +
+                                                    "' requires a whole number up to "s +
+                                                    std::to_string(max));
+          return number;
+        };
+
+        if (arg == "--headless") {
+          options.headless = true;
+        } else if (arg == "--scene") {
+          options.scene = get_value();
+          has_scene     = true;
+        } else if (arg == "--frames") {
+          options.frames = static_cast<i32>(get_whole_number(std::numeric_limits<i32>::max()));
+        } else if (arg == "--generate") {
+          settings.layout = SceneGenerator::parse_layout(get_value());
+          is_generating   = true;
+        } else if (arg == "--count") {
+          settings.count = static_cast<i32>(get_whole_number(std::numeric_limits<i32>::max()));
+          has_settings   = true;
+        } else if (arg == "--prefab") {
+          settings.prefab = get_value();
+          has_settings    = true;
+        } else if (arg == "--static-ratio") {
+          const auto value = get_value();
+          auto length      = usize{0};
+
+          try {
+            settings.static_ratio = std::stof(value, &length);
+          } catch (const std::invalid_argument &) {
+            length = 0;
+          } catch (const std::out_of_range &) {
+            length = 0;
+          }
+
+          afk_assert(!value.empty() && length == value.size() && settings.static_ratio >= 0.0f &&
+                         settings.static_ratio <= 1.0f,
+                     "Launch option '--static-ratio' requires a number between 0 and 1"s);
+          has_settings = true;
+        } else if (arg == "--seed") {
+          settings.seed = static_cast<u32>(get_whole_number(std::numeric_limits<u32>::max()));
+          has_settings  = true;
+        } else if (arg == "--generate-out") {
+          options.generate_out = get_value();
+        } else if (arg == "--bench-out") {
+          options.bench_out = get_value();
+        } else if (arg == "--record") {
+          options.record = get_value();
+        } else if (arg == "--replay") {
+          options.replay = get_value();
+        } else {
+          afk_assert(false, "Unknown launch option '"s + arg + "'"s);
+        }
+      }
+
+      afk_assert(!(options.record.has_value() && options.replay.has_value()),
+                 "Can't record and replay at the same time");
+      afk_assert(is_generating || (!has_settings && !options.generate_out.has_value()),
+                 "Scene generation options require '--generate'");
+      afk_assert(!(is_generating && has_scene),
+                 "Can't use '--scene' with '--generate', the generated scene is instantiated");
+
+      if (is_generating) {
+        options.generate = settings;
+        options.scene    = SceneGenerator::get_name(settings);
+      }
+
+      return options;
+    }
+  }
+}
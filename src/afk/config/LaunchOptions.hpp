@@ -0,0 +1,44 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/scene/SceneGenerator.hpp"
+
+namespace afk {
+  namespace config {
+    /**
+     * Encapsulates the options the engine was launched with. Unlike the
+     * engine config, these only last for a single run and are never saved.
+     */
+    struct LaunchOptions {
+      /** Should the engine run without a window, renderer or UI? */
+      bool headless = false;
+      /** The scene to instantiate on startup. */
+      std::string scene = "default";
+      /** The number of frames to run before exiting, if limited. */
+      std::optional<i32> frames = std::nullopt;
+      /** The path to write the benchmark report to when exiting, if benchmarking. */
+      std::optional<std::filesystem::path> bench_out = std::nullopt;
+      /** The path to record input and frame timing to, if recording. */
+      std::optional<std::filesystem::path> record = std::nullopt;
+      /** The path to replay input and frame timing from, if replaying. */
+      std::optional<std::filesystem::path> replay = std::nullopt;
+      /** The stress scene to generate and instantiate on startup, if generating. */
+      std::optional<afk::scene::SceneGenerator::Settings> generate = std::nullopt;
+      /** The path to write the generated scene to, if saving it. */
+      std::optional<std::filesystem::path> generate_out = std::nullopt;
+    };
+
+    /**
+     * Parses the launch options from the command line arguments.
+     *
+     * @param argc The number of arguments.
+     * @param argv The arguments.
+     * @return The parsed launch options.
+     */
+    auto parse_launch_options(i32 argc, char **argv) -> LaunchOptions;
+  }
+}
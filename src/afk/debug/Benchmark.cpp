@@ -0,0 +1,97 @@
+#include "afk/debug/Benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+  #include <windows.h>
+  // Must be included after windows.h.
+  #include <psapi.h>
+#else
+  #include <sys/resource.h>
+#endif
+
+using afk::debug::Benchmark;
+
+Benchmark::Scope::Scope(Benchmark &benchmark, std::string name)
+  : benchmark(benchmark), name(std::move(name)), start(Clock::now()) {}
+
+Benchmark::Scope::~Scope() {
+  if (!this->benchmark.get_is_enabled()) {
+    return;
+  }
+
+  const auto elapsed = std::chrono::duration<f64, std::milli>(Clock::now() - this->start);
+  this->benchmark.record(this->name, elapsed.count());
+}
+
+auto Benchmark::set_is_enabled(bool is_enabled) -> void {
+  this->is_enabled = is_enabled;
+}
+
+auto Benchmark::get_is_enabled() const -> bool {
+  return this->is_enabled;
+}
+
+auto Benchmark::record(const std::string &name, f64 milliseconds) -> void {
+  if (!this->is_enabled) {
+    return;
+  }
+
+  auto lock = std::lock_guard{this->mutex};
+  this->timings[name].push_back(milliseconds);
+}
+
+auto Benchmark::get_summaries() const -> Summaries {
+  auto lock      = std::lock_guard{this->mutex};
+  auto summaries = Summaries{};
+
+  for (auto [name, timings] : this->timings) {
+    if (timings.empty()) {
+      continue;
+    }
+
+    std::sort(timings.begin(), timings.end());
+
+    // nearest rank percentile
+    const auto percentile = [&timings](f64 p) {
+      const auto rank = static_cast<usize>(std::ceil(p * static_cast<f64>(timings.size())));
+      return timings[std::clamp(rank, usize{1}, timings.size()) - 1];
+    };
+
+    auto &summary = summaries[name];
+    summary.count = timings.size();
+    summary.min   = timings.front();
+    summary.mean  = std::accumulate(timings.begin(), timings.end(), 0.0) /
+                   static_cast<f64>(timings.size());
+    summary.p50 = percentile(0.50);
+    summary.p99 = percentile(0.99);
+    summary.max = timings.back();
+  }
+
+  return summaries;
+}
+
+auto Benchmark::get_peak_memory() -> usize {
+#if defined(_WIN32)
+  auto counters = PROCESS_MEMORY_COUNTERS{};
+  GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+
+  return static_cast<usize>(counters.PeakWorkingSetSize);
+#else
+  auto usage = rusage{};
+  getrusage(RUSAGE_SELF, &usage);
+
+  #if defined(__APPLE__)
+  // macOS reports bytes
+  return static_cast<usize>(usage.ru_maxrss);
+  #else
+  // Linux reports kilobytes
+  return static_cast<usize>(usage.ru_maxrss) * 1024;
+  #endif
+#endif
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "afk/NumericTypes.hpp"
+
+namespace afk {
+  namespace debug {
+    /**
+     * Collects named timings over a run, so the same scene can be compared
+     * across engine builds. Timings are only collected while enabled.
+     */
+    class Benchmark {
+    public:
+      /** The clock timings are measured with. */
+      using Clock = std::chrono::steady_clock;
+
+      /**
+       * The distribution of a named timing, in milliseconds.
+       */
+      struct Summary {
+        /** The number of timings. */
+        usize count = {};
+        /** The shortest timing. */
+        f64 min = {};
+        /** The average timing. */
+        f64 mean = {};
+        /** The median timing. */
+        f64 p50 = {};
+        /** The 99th percentile timing. */
+        f64 p99 = {};
+        /** The longest timing. */
+        f64 max = {};
+      };
+
+      /** Map of timing names to their summaries. */
+      using Summaries = std::map<std::string, Summary>;
+
+      /**
+       * Times the scope it is declared in, recording the timing under the
+       * specified name when it ends.
+       */
+      class Scope {
+      public:
+        /**
+         * Starts timing a scope.
+         *
+         * @param benchmark The benchmark to record to.
+         * @param name The timing name.
+         */
+        Scope(Benchmark &benchmark, std::string name);
+        ~Scope();
+        Scope(Scope &&)      = delete;
+        Scope(const Scope &) = delete;
+        auto operator=(const Scope &) -> Scope & = delete;
+        auto operator=(Scope &&) -> Scope & = delete;
+
+      private:
+        /** The benchmark to record to. */
+        Benchmark &benchmark;
+        /** The timing name. */
+        std::string name = {};
+        /** When the scope was entered. */
+        Clock::time_point start = {};
+      };
+
+      Benchmark()                  = default;
+      ~Benchmark()                 = default;
+      Benchmark(Benchmark &&)      = delete;
+      Benchmark(const Benchmark &) = delete;
+      auto operator=(const Benchmark &) -> Benchmark & = delete;
+      auto operator=(Benchmark &&) -> Benchmark & = delete;
+
+      /**
+       * Sets if timings are collected.
+       *
+       * @param is_enabled Should timings be collected?
+       */
+      auto set_is_enabled(bool is_enabled) -> void;
+
+      /**
+       * Returns if timings are collected.
+       *
+       * @return True if timings are collected.
+       */
+      auto get_is_enabled() const -> bool;
+
+      /**
+       * Records a timing under the specified name, if enabled. May be called
+       * from any thread.
+       *
+       * @param name The timing name.
+       * @param milliseconds The timing, in milliseconds.
+       */
+      auto record(const std::string &name, f64 milliseconds) -> void;
+
+      /**
+       * Returns the distribution of each named timing.
+       *
+       * @return The timing summaries.
+       */
+      auto get_summaries() const -> Summaries;
+
+      /**
+       * Returns the most memory the process has used at once.
+       *
+       * @return The peak resident memory, in bytes.
+       */
+      static auto get_peak_memory() -> usize;
+
+    private:
+      /** Are timings collected? */
+      bool is_enabled = false;
+      /** Map of timing names to their timings, in milliseconds. */
+      std::map<std::string, std::vector<f64>> timings = {};
+      /** Guards the timings, as systems run on any thread. */
+      mutable std::mutex mutex = {};
+    };
+  }
+}
@@ -0,0 +1,155 @@
+#include "afk/debug/Profiler.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "afk/io/Json.hpp"
+
+using afk::debug::Profiler;
+using afk::io::Json;
+using std::filesystem::path;
+
+thread_local Profiler::ThreadBuffer *Profiler::thread_buffer = nullptr;
+
+Profiler::Scope::Scope(const char *name) : name(name) {
+  auto &buffer = profiler.get_thread_buffer();
+  ++buffer.depth;
+  this->start = profiler.get_time();
+}
+
+Profiler::Scope::~Scope() {
+  const auto end = profiler.get_time();
+  auto &buffer   = *Profiler::thread_buffer;
+  --buffer.depth;
+
+  if (profiler.get_is_paused()) {
+    return;
+  }
+
+  auto lock = std::lock_guard{buffer.mutex};
+
+  buffer.samples[buffer.next] = {this->name, this->start, end, buffer.depth};
+  buffer.next                 = (buffer.next + 1) % SAMPLE_CAPACITY;
+  buffer.count                = std::min(buffer.count + 1, SAMPLE_CAPACITY);
+}
+
+Profiler::Profiler() = default;
+
+auto Profiler::set_thread_name(const std::string &name) -> void {
+  auto &buffer = this->get_thread_buffer();
+  auto lock    = std::lock_guard{buffer.mutex};
+  buffer.name  = name;
+}
+
+auto Profiler::new_frame() -> void {
+  if (this->get_is_paused()) {
+    return;
+  }
+
+  auto lock = std::lock_guard{this->frames_mutex};
+
+  this->frame_starts[this->next_frame] = this->get_time();
+  this->next_frame  = (this->next_frame + 1) % FRAME_CAPACITY;
+  this->frame_count = std::min(this->frame_count + 1, FRAME_CAPACITY);
+}
+
+auto Profiler::set_is_paused(bool is_paused) -> void {
+  this->is_paused.store(is_paused, std::memory_order_relaxed);
+}
+
+auto Profiler::get_is_paused() const -> bool {
+  return this->is_paused.load(std::memory_order_relaxed);
+}
+
+auto Profiler::get_frames() const -> std::vector<Frame> {
+  auto lock   = std::lock_guard{this->frames_mutex};
+  auto frames = std::vector<Frame>{};
+
+  if (this->frame_count < 2) {
+    return frames;
+  }
+
+  // the latest frame start has no end yet, so it isn't a complete frame
+  const auto oldest = (this->next_frame + FRAME_CAPACITY - this->frame_count) % FRAME_CAPACITY;
+  for (auto i = usize{0}; i + 1 < this->frame_count; ++i) {
+    frames.push_back({this->frame_starts[(oldest + i) % FRAME_CAPACITY],
+                      this->frame_starts[(oldest + i + 1) % FRAME_CAPACITY]});
+  }
+
+  return frames;
+}
+
+auto Profiler::get_threads(i64 start, i64 end) const -> std::vector<Thread> {
+  auto lock    = std::lock_guard{this->thread_buffers_mutex};
+  auto threads = std::vector<Thread>{};
+
+  for (const auto &buffer : this->thread_buffers) {
+    auto buffer_lock = std::lock_guard{buffer->mutex};
+    auto thread      = Thread{buffer->index, buffer->name, {}};
+
+    const auto oldest = (buffer->next + SAMPLE_CAPACITY - buffer->count) % SAMPLE_CAPACITY;
+    for (auto i = usize{0}; i < buffer->count; ++i) {
+      const auto &sample = buffer->samples[(oldest + i) % SAMPLE_CAPACITY];
+
+      if (sample.end >= start && sample.start <= end) {
+        thread.samples.push_back(sample);
+      }
+    }
+
+    threads.push_back(std::move(thread));
+  }
+
+  return threads;
+}
+
+auto Profiler::export_chrome_trace(const path &file_path) const -> void {
+  const auto threads =
+      this->get_threads(std::numeric_limits<i64>::min(), std::numeric_limits<i64>::max());
+  auto events = Json::array();
+
+  for (const auto &thread : threads) {
+    events.push_back({{"name", "thread_name"},
+                      {"ph", "M"},
+                      {"pid", 0},
+                      {"tid", thread.index},
+                      {"args", {{"name", thread.name}}}});
+
+    // trace event timestamps are in microseconds
+    for (const auto &sample : thread.samples) {
+      events.push_back({{"name", sample.name},
+                        {"ph", "X"},
+                        {"pid", 0},
+                        {"tid", thread.index},
+                        {"ts", static_cast<f64>(sample.start) / 1000.0},
+                        {"dur", static_cast<f64>(sample.end - sample.start) / 1000.0}});
+    }
+  }
+
+  auto json               = Json{};
+  json["traceEvents"]     = std::move(events);
+  json["displayTimeUnit"] = "ms";
+  afk::io::write_json_to_file(file_path, json);
+}
+
+auto Profiler::get_time() const -> i64 {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - this->epoch)
+      .count();
+}
+
+auto Profiler::get_thread_buffer() -> ThreadBuffer & {
+  if (Profiler::thread_buffer == nullptr) {
+    auto lock   = std::lock_guard{this->thread_buffers_mutex};
+    auto buffer = std::make_unique<ThreadBuffer>();
+
+    buffer->index = this->thread_buffers.size();
+    buffer->name  = "Thread " + std::to_string(buffer->index);
+
+    Profiler::thread_buffer = buffer.get();
+    this->thread_buffers.push_back(std::move(buffer));
+  }
+
+  return *Profiler::thread_buffer;
+}
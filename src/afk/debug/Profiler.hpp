@@ -0,0 +1,237 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "afk/NumericTypes.hpp"
+
+#define AFK_PROFILER_CONCAT_IMPL(a, b) a##b
+#define AFK_PROFILER_CONCAT(a, b) AFK_PROFILER_CONCAT_IMPL(a, b)
+
+#ifdef AFK_PROFILER
+  #define afk_profile_scope(name)                                              \
+    const auto AFK_PROFILER_CONCAT(afk_profile_scope_, __LINE__) =             \
+        afk::debug::Profiler::Scope { name }
+  #define afk_profile_frame() afk::debug::profiler.new_frame()
+  #define afk_profile_thread(name) afk::debug::profiler.set_thread_name(name)
+#else
+  #define afk_profile_scope(name) ((void)0)
+  #define afk_profile_frame() ((void)0)
+  #define afk_profile_thread(name) ((void)0)
+#endif
+
+namespace afk {
+  namespace debug {
+    /**
+     * Records how long named scopes take on each thread, so a frame can be
+     * broken down and inspected in game or exported for offline analysis.
+     *
+     * Scopes, frames and thread names are recorded with the afk_profile_scope,
+     * afk_profile_frame and afk_profile_thread macros, which compile to
+     * nothing unless the engine is built with the profiler enabled. Each
+     * thread records into its own fixed size ring buffer, so the oldest
+     * samples are overwritten once it fills up.
+     */
+    class Profiler {
+    public:
+      /** The clock samples are timed with. */
+      using Clock = std::chrono::steady_clock;
+
+      /** The number of samples kept per thread. */
+      static constexpr usize SAMPLE_CAPACITY = 1 << 15;
+      /** The number of frame boundaries kept. */
+      static constexpr usize FRAME_CAPACITY = 256;
+
+      /**
+       * A timed scope.
+       */
+      struct Sample {
+        /** The scope name, which must outlive the profiler. */
+        const char *name = nullptr;
+        /** When the scope was entered, in nanoseconds since the profiler started. */
+        i64 start = {};
+        /** When the scope was exited, in nanoseconds since the profiler started. */
+        i64 end = {};
+        /** The number of scopes the scope was nested in. */
+        u32 depth = {};
+      };
+
+      /**
+       * A frame, spanning from one call to new_frame to the next.
+       */
+      struct Frame {
+        /** When the frame started, in nanoseconds since the profiler started. */
+        i64 start = {};
+        /** When the frame ended, in nanoseconds since the profiler started. */
+        i64 end = {};
+      };
+
+      /**
+       * The samples recorded by a thread.
+       */
+      struct Thread {
+        /** The thread index, in the order threads first recorded a sample. */
+        usize index = {};
+        /** The thread name. */
+        std::string name = {};
+        /** The samples, ordered by when they ended. */
+        std::vector<Sample> samples = {};
+      };
+
+      /**
+       * Times the scope it is declared in. Use the afk_profile_scope macro
+       * rather than creating one directly.
+       */
+      class Scope {
+      public:
+        /**
+         * Starts timing a scope.
+         *
+         * @param name The scope name, which must outlive the profiler.
+         */
+        explicit Scope(const char *name);
+        ~Scope();
+        Scope(Scope &&)      = delete;
+        Scope(const Scope &) = delete;
+        auto operator=(const Scope &) -> Scope & = delete;
+        auto operator=(Scope &&) -> Scope & = delete;
+
+      private:
+        /** The scope name. */
+        const char *name = nullptr;
+        /** When the scope was entered. */
+        i64 start = {};
+      };
+
+      Profiler();
+      ~Profiler()                = default;
+      Profiler(Profiler &&)      = delete;
+      Profiler(const Profiler &) = delete;
+      auto operator=(const Profiler &) -> Profiler & = delete;
+      auto operator=(Profiler &&) -> Profiler & = delete;
+
+      /**
+       * Names the calling thread.
+       *
+       * @param name The thread name.
+       */
+      auto set_thread_name(const std::string &name) -> void;
+
+      /**
+       * Marks the start of a new frame, ending the current one.
+       */
+      auto new_frame() -> void;
+
+      /**
+       * Sets if samples are recorded. Pausing keeps the recorded samples
+       * around so they can be inspected.
+       *
+       * @param is_paused Should recording be paused?
+       */
+      auto set_is_paused(bool is_paused) -> void;
+
+      /**
+       * Returns if recording is paused.
+       *
+       * @return True if recording is paused.
+       */
+      auto get_is_paused() const -> bool;
+
+      /**
+       * Returns the recorded frames, oldest first.
+       *
+       * @return The recorded frames.
+       */
+      auto get_frames() const -> std::vector<Frame>;
+
+      /**
+       * Returns the samples of each thread that overlap the specified time.
+       *
+       * @param start The start of the time, in nanoseconds since the profiler started.
+       * @param end The end of the time, in nanoseconds since the profiler started.
+       * @return The samples of each thread.
+       */
+      auto get_threads(i64 start, i64 end) const -> std::vector<Thread>;
+
+      /**
+       * Writes every recorded sample to the specified file in the Chrome
+       * trace event format, which can be opened with chrome://tracing or
+       * Perfetto.
+       *
+       * @param file_path The path to write to.
+       */
+      auto export_chrome_trace(const std::filesystem::path &file_path) const -> void;
+
+      /**
+       * Returns the time since the profiler started.
+       *
+       * @return The time, in nanoseconds.
+       */
+      auto get_time() const -> i64;
+
+    private:
+      /**
+       * The samples recorded by a single thread. Only the owning thread
+       * writes to the buffer, the lock is held against readers.
+       */
+      struct ThreadBuffer {
+        /** The thread index. */
+        usize index = {};
+        /** The thread name. */
+        std::string name = {};
+        /** The sample ring buffer. */
+        std::vector<Sample> samples = std::vector<Sample>(SAMPLE_CAPACITY);
+        /** The index the next sample is written to. */
+        usize next = {};
+        /** The number of samples in the ring buffer. */
+        usize count = {};
+        /** The number of scopes currently entered. */
+        u32 depth = {};
+        /** Guards the samples and name. */
+        mutable std::mutex mutex = {};
+      };
+
+      /**
+       * Returns the calling thread's buffer, creating it if needed.
+       *
+       * @return The calling thread's buffer.
+       */
+      auto get_thread_buffer() -> ThreadBuffer &;
+
+      /**
+       * The calling thread's buffer. This is shared between profilers, so
+       * only the default profiler should be recorded to.
+       */
+      static thread_local ThreadBuffer *thread_buffer;
+
+      /** When the profiler started. */
+      Clock::time_point epoch = Clock::now();
+      /** Is recording paused? */
+      std::atomic<bool> is_paused = false;
+
+      /** The buffer of each thread that has recorded a sample. */
+      std::vector<std::unique_ptr<ThreadBuffer>> thread_buffers = {};
+      /** Guards the thread buffer list. */
+      mutable std::mutex thread_buffers_mutex = {};
+
+      /** The frame start ring buffer. */
+      std::vector<i64> frame_starts = std::vector<i64>(FRAME_CAPACITY);
+      /** The index the next frame start is written to. */
+      usize next_frame = {};
+      /** The number of frame starts in the ring buffer. */
+      usize frame_count = {};
+      /** Guards the frame starts. */
+      mutable std::mutex frames_mutex = {};
+
+      friend class Scope;
+    };
+
+    /** The default profiler. */
+    inline auto profiler = Profiler{};
+  }
+}
@@ -5,10 +5,11 @@
 
 using afk::ecs::Ecs;
 
-auto Ecs::update() -> void {
-  this->system_manager.update();
+auto Ecs::update(afk::World &world, f32 dt) -> void {
+  this->system_manager.update(world, dt);
 }
 
 auto Ecs::initialize() -> void {
+  this->system_manager.initialize();
   afk::io::log << afk::io::get_date_time() << "ECS subsystem initialized\n";
 }
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "afk/NumericTypes.hpp"
 #include "afk/ecs/Registry.hpp"
 #include "afk/ecs/SystemManager.hpp"
 
 namespace afk {
+  class World;
+
   namespace ecs {
     /**
      * Encapsulates the entity component system (ECS).
@@ -17,8 +20,11 @@ namespace afk {
 
       /**
        * Updates every registered system.
+       *
+       * @param world The world the systems belong to.
+       * @param dt The time to advance by, in seconds.
        */
-      auto update() -> void;
+      auto update(afk::World &world, f32 dt) -> void;
 
       /**
        * Initializes the ECS subsystem.
@@ -1,23 +1,152 @@
 #include "afk/ecs/SystemManager.hpp"
 
+#include <algorithm>
+
+#include "afk/Engine.hpp"
+#include "afk/World.hpp"
+#include "afk/debug/Assert.hpp"
+#include "afk/debug/Benchmark.hpp"
+#include "afk/ecs/component/ColliderComponent.hpp"
+#include "afk/ecs/component/PhysicsComponent.hpp"
+#include "afk/ecs/component/PreviousTransformComponent.hpp"
+#include "afk/ecs/component/TransformComponent.hpp"
+#include "afk/ecs/system/CollisionSystem.hpp"
+#include "afk/ecs/system/RenderSystem.hpp"
+#include "afk/io/Log.hpp"
+#include "afk/io/Time.hpp"
+
 using afk::ecs::SystemManager;
+using afk::ecs::component::ColliderComponent;
+using afk::ecs::component::PhysicsComponent;
+using afk::ecs::component::PreviousTransformComponent;
+using afk::ecs::component::TransformComponent;
+using afk::ecs::system::CollisionSystem;
+using afk::ecs::system::RenderSystem;
+using afk::job::JobManager;
+using afk::render::RenderSnapshot;
 
-auto SystemManager::register_display_update_system(const Update& update) -> void {
-  this->display_update_systems.push_back(update);
+/**
+ * Returns if any type is in both of the specified collections.
+ *
+ * @param lhs The left hand side types.
+ * @param rhs The right hand side types.
+ * @return True if the collections share a type.
+ */
+static auto intersects(const std::vector<SystemManager::TypeId> &lhs,
+                       const std::vector<SystemManager::TypeId> &rhs) -> bool {
+  return std::any_of(lhs.begin(), lhs.end(), [&rhs](const auto &type) {
+    return std::find(rhs.begin(), rhs.end(), type) != rhs.end();
+  });
 }
 
-auto SystemManager::register_update_system(const Update& update) -> void {
-  this->display_update_systems.push_back(update);
+auto SystemManager::Access::is_exclusive() const -> bool {
+  return this->reads.empty() && this->writes.empty();
 }
 
-auto SystemManager::display_update() const -> void {
-  for (const auto &system_update : this->display_update_systems) {
-    system_update();
+auto SystemManager::Access::conflicts_with(const Access &other) const -> bool {
+  if (this->is_exclusive() || other.is_exclusive()) {
+    return true;
   }
+
+  // concurrent reads are fine, anything involving a write isn't
+  return intersects(this->writes, other.writes) ||
+         intersects(this->writes, other.reads) ||
+         intersects(this->reads, other.writes);
+}
+
+auto SystemManager::initialize() -> void {
+  afk_assert(!this->is_initialized, "System manager already initialized");
+
+  // both update systems write to the collision system, as physics updates its contact cache and
+  // moves its colliders, so the collision system always runs after physics rather than alongside it
+  this->register_update_system(
+      {"physics",
+       [](afk::World &world, f32 dt) { world.physics_system.update(dt); },
+       Access{}
+           .read<ColliderComponent>()
+           .write<PhysicsComponent, TransformComponent,
+                  PreviousTransformComponent, CollisionSystem>()});
+
+  this->register_update_system(
+      {"collision",
+       [](afk::World &world, f32 dt) { world.collision_system.update(dt); },
+       Access{}
+           .read<ColliderComponent>()
+           .write<TransformComponent, CollisionSystem>()});
+
+  this->register_display_update_system(
+      {"render", [](afk::World &, f32 dt) { RenderSystem::update(dt); },
+       Access{}.read<RenderSnapshot>().on_main_thread()});
+
+  this->is_initialized = true;
+  afk::io::log << afk::io::get_date_time() << "System manager initialized\n";
+}
+
+auto SystemManager::register_display_update_system(const System &system)
+    -> void {
+  this->display_update_systems.push_back(system);
+}
+
+auto SystemManager::register_update_system(const System &system) -> void {
+  this->update_systems.push_back(system);
+}
+
+auto SystemManager::display_update(afk::World &world, f32 dt) -> void {
+  this->run(this->display_update_systems, world, dt);
+}
+
+auto SystemManager::update(afk::World &world, f32 dt) -> void {
+  this->run(this->update_systems, world, dt);
 }
 
-auto SystemManager::update() const -> void {
-  for (const auto &system_update : this->update_systems) {
-    system_update();
+auto SystemManager::run(const Systems &systems, afk::World &world, f32 dt) -> void {
+  auto &job_manager = world.job_manager;
+  auto &benchmark   = afk::Engine::get().benchmark;
+
+  // counts each system until it finishes, later conflicting systems wait on it
+  auto counters     = std::vector<JobManager::Counter>(systems.size());
+  auto dependencies = std::vector<JobManager::Dependencies>(systems.size());
+
+  for (auto i = usize{0}; i < systems.size(); ++i) {
+    const auto &system = systems[i];
+
+    for (auto j = usize{0}; j < i; ++j) {
+      if (system.access.conflicts_with(systems[j].access)) {
+        dependencies[i].push_back(&counters[j]);
+      }
+    }
+
+    if (system.access.main_thread) {
+      // run below, once the main thread gets to it
+      counters[i].increment();
+    } else {
+      job_manager.submit(
+          [&system, &world, &benchmark, dt]() {
+            const auto timer = afk::debug::Benchmark::Scope{benchmark, system.name};
+            system.update(world, dt);
+          },
+          &counters[i], dependencies[i]);
+    }
+  }
+
+  for (auto i = usize{0}; i < systems.size(); ++i) {
+    if (!systems[i].access.main_thread) {
+      continue;
+    }
+
+    for (const auto *dependency : dependencies[i]) {
+      job_manager.wait(*dependency);
+    }
+
+    {
+      const auto timer = afk::debug::Benchmark::Scope{benchmark, systems[i].name};
+      systems[i].update(world, dt);
+    }
+
+    job_manager.finish(counters[i]);
+  }
+
+  for (const auto &counter : counters) {
+    job_manager.wait(counter);
   }
 }
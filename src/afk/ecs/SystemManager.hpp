@@ -1,52 +1,182 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <typeindex>
 #include <vector>
 
-#include "afk/ecs/system/CollisionSystem.hpp"
-#include "afk/ecs/system/RenderSystem.hpp"
-#include "afk/ecs/system/PhysicsSystem.hpp"
+#include "afk/NumericTypes.hpp"
 
 namespace afk {
+  class World;
+
   namespace ecs {
     /**
      * Manages the systems which operate on entities.
+     *
+     * Each cycle the systems are scheduled by the components they access.
+     * Systems that don't conflict with each other run concurrently as jobs,
+     * while conflicting systems run in the order they were registered in.
      */
     class SystemManager {
     public:
-      /** The system update function. */
-      using Update = std::function<void()>;
+      /**
+       * The system update function, given the world to update and the time to
+       * advance by in seconds.
+       */
+      using Update = std::function<void(afk::World &, f32)>;
+      /** Identifies a type accessed by a system. */
+      using TypeId = std::type_index;
+
+      /**
+       * Declares which components a system reads and writes.
+       *
+       * Any type may be declared, which allows systems to also declare access
+       * to shared resources such as the collision world. A system without any
+       * declared access is exclusive and never runs alongside another system.
+       */
+      struct Access {
+        /** The types read by the system. */
+        std::vector<TypeId> reads = {};
+        /** The types written by the system. */
+        std::vector<TypeId> writes = {};
+        /** Does the system need to run on the main thread, e.g. to draw? */
+        bool main_thread = false;
+
+        /**
+         * Declares the specified types as read by the system.
+         *
+         * @tparam T The types read.
+         * @return This access declaration.
+         */
+        template<typename... T>
+        auto read() -> Access & {
+          (this->reads.push_back(TypeId{typeid(T)}), ...);
+          return *this;
+        }
+
+        /**
+         * Declares the specified types as written by the system.
+         *
+         * @tparam T The types written.
+         * @return This access declaration.
+         */
+        template<typename... T>
+        auto write() -> Access & {
+          (this->writes.push_back(TypeId{typeid(T)}), ...);
+          return *this;
+        }
+
+        /**
+         * Declares that the system must run on the main thread.
+         *
+         * @return This access declaration.
+         */
+        auto on_main_thread() -> Access & {
+          this->main_thread = true;
+          return *this;
+        }
+
+        /**
+         * Returns if the system is exclusive, as it declares no access.
+         *
+         * @return True if the system is exclusive.
+         */
+        auto is_exclusive() const -> bool;
+
+        /**
+         * Returns if a system with this access can't run alongside a system
+         * with the specified access.
+         *
+         * @param other The access of the other system.
+         * @return True if the systems conflict.
+         */
+        auto conflicts_with(const Access &other) const -> bool;
+      };
+
+      /**
+       * Encapsulates a registered system.
+       *
+       * Systems that may run off the main thread must not create or destroy
+       * entities, or add or remove components, as the registry is not
+       * synchronised.
+       */
+      struct System {
+        /** The system name, used for diagnostics. */
+        std::string name = {};
+        /** The system update function. */
+        Update update = {};
+        /** The components accessed by the system. */
+        Access access = {};
+      };
+
+      /** A collection of systems. */
+      using Systems = std::vector<System>;
+
+      SystemManager()                      = default;
+      ~SystemManager()                     = default;
+      SystemManager(SystemManager &&)      = delete;
+      SystemManager(const SystemManager &) = delete;
+      auto operator=(const SystemManager &) -> SystemManager & = delete;
+      auto operator=(SystemManager &&) -> SystemManager & = delete;
+
+      /**
+       * Initializes the system manager, registering the engine systems.
+       */
+      auto initialize() -> void;
 
       /**
        * Registers a system to be called on each display update.
        *
-       * @param update The update function to be called.
+       * When pipelining is enabled, display update systems run while the
+       * simulation advances, so they must only read the render snapshot.
+       *
+       * @param system The system to register.
        */
-      auto register_display_update_system(const Update &update) -> void;
+      auto register_display_update_system(const System &system) -> void;
 
       /**
        * Registers a system to be called on each update.
        *
-       * @param update The update function to be called.
+       * @param system The system to register.
        */
-      auto register_update_system(const Update &update) -> void;
+      auto register_update_system(const System &system) -> void;
 
       /**
        * Updates every registered system that should be tied to the render update cycle.
+       *
+       * @param world The world to update.
+       * @param dt The time since the last display update, in seconds.
        */
-      auto display_update() const -> void;
+      auto display_update(afk::World &world, f32 dt) -> void;
 
       /**
        * Updates every registered system that should be tied to the update cycle.
+       *
+       * @param world The world to update.
+       * @param dt The time to advance by, in seconds.
        */
-      auto update() const -> void;
+      auto update(afk::World &world, f32 dt) -> void;
 
     private:
-      /** The container of system update functions to run on each display update cycle. */
-      std::vector<Update> display_update_systems = {afk::ecs::system::RenderSystem::update};
+      /**
+       * Runs the specified systems, running non-conflicting systems concurrently.
+       * Returns once every system has finished.
+       *
+       * @param systems The systems to run.
+       * @param world The world to pass to the systems.
+       * @param dt The time to pass to the systems, in seconds.
+       */
+      auto run(const Systems &systems, afk::World &world, f32 dt) -> void;
+
+      /** Is the system manager initialized? */
+      bool is_initialized = false;
+
+      /** The container of systems to run on each display update cycle. */
+      Systems display_update_systems = {};
 
-      /** The container of system update functions to run on each update cycle. */
-      std::vector<Update> update_systems = { };
+      /** The container of systems to run on each update cycle. */
+      Systems update_systems = {};
     };
   }
 }
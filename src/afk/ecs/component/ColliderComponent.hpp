@@ -10,6 +10,10 @@
 #include "afk/physics/shape/Box.hpp"
 #include "afk/physics/shape/Sphere.hpp"
 
+namespace reactphysics3d {
+  class CollisionBody;
+}
+
 namespace afk {
   namespace ecs {
     namespace component {
@@ -21,6 +25,15 @@ namespace afk {
         using ColliderShape =
             std::variant<afk::physics::shape::Box, afk::physics::shape::Sphere>;
 
+        /** Collision layers, one bit per layer */
+        using Layers = u8;
+
+        /** Layer colliders are in when none is specified */
+        static constexpr Layers DEFAULT_LAYER = 0x01;
+
+        /** Every layer */
+        static constexpr Layers ALL_LAYERS = 0xFF;
+
         /** A collider body is made up of a collision body as well as a transform local to the entity */
         struct Collider {
           /** Shape of the collider */
@@ -29,6 +42,12 @@ namespace afk {
           afk::physics::Transform transform = {};
           /** Mass of the collider */
           f32 mass = {};
+          /** Layers the collider is in */
+          Layers category = ColliderComponent::DEFAULT_LAYER;
+          /** Layers the collider can touch, two colliders only touch if each is in a layer the other can touch */
+          Layers mask = ColliderComponent::ALL_LAYERS;
+          /** If the collider is a trigger, which detects overlaps without being resolved */
+          bool is_trigger = false;
         };
 
         /** Defining a collection of colliders */
@@ -36,6 +55,18 @@ namespace afk {
 
         /** Collection of colliders for the entity */
         ColliderCollection colliders = {};
+
+        /**
+         * ReactPhysics3D body made from the colliders, owned by the collision system
+         * Set when the component is instantiated, the body's user data is the entity it belongs to
+         */
+        reactphysics3d::CollisionBody *body = nullptr;
+
+        /**
+         * Index of each collider in the collision system's world colliders, in the same order as the colliders
+         * Set when the component is instantiated, owned by the collision system
+         */
+        std::vector<u32> world_colliders = {};
       };
     }
   }
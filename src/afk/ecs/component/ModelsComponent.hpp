@@ -14,8 +14,11 @@ namespace afk {
        * Represents a single model to draw for the entity
        */
       struct Model {
-        /** The entity model. */
-        afk::render::ModelHandle model_handle = {};
+        /**
+         * The entity model, owned by the renderer, or null if no model has
+         * been loaded for it.
+         */
+        const afk::render::ModelHandle *model_handle = nullptr;
         /** The model transform. */
         afk::physics::Transform transform = {};
       };
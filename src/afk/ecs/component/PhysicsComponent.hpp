@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include <variant>
 
 #include <glm/glm.hpp>
@@ -21,6 +22,12 @@ namespace afk {
          */
         bool is_static = true;
 
+        /**
+         * if the component is swept for collisions when it moves far in a single update, so it can't pass through thin colliders
+         * is constant after initialisation
+         */
+        bool continuous_collision = false;
+
         /**
          * center of mass local to the entity
          * is constant after initialisation
@@ -96,6 +103,28 @@ namespace afk {
          * constant value after initialisation, derived from local inertial tensor
          */
         glm::vec3 local_inverse_inertial_tensor = glm::zero<glm::vec3>();
+
+        /** --- sleeping --- */
+
+        /**
+         * if the rigid body is asleep
+         * sleeping bodies aren't integrated, synchronised or tested against each other until their island is woken
+         */
+        bool is_sleeping = false;
+
+        /**
+         * how long the rigid body has been moving slowly enough to sleep, in seconds
+         * updated on each cycle
+         */
+        f32 sleep_time = 0.0f;
+
+        /** --- integration --- */
+
+        /**
+         * the slot of the rigid body in the physics system's body batch
+         * only meaningful while it's dynamic and awake, updated by the physics system
+         */
+        usize batch_slot = std::numeric_limits<usize>::max();
       };
     }
   }
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "afk/physics/Transform.hpp"
+
+namespace afk {
+  namespace ecs {
+    namespace component {
+      /**
+       * Encapsulates the transform of an entity as of the previous simulation
+       * tick, used to interpolate rendering between ticks.
+       */
+      struct PreviousTransformComponent {
+        /** The transform before the latest tick. */
+        afk::physics::Transform transform = {};
+      };
+    }
+  }
+}
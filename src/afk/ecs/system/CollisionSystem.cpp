@@ -1,10 +1,16 @@
 #include "afk/ecs/system/CollisionSystem.hpp"
 
-#include "afk/Engine.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "afk/World.hpp"
 #include "afk/debug/Assert.hpp"
+#include "afk/debug/Profiler.hpp"
 #include "afk/ecs/component/PhysicsComponent.hpp"
 #include "afk/io/Log.hpp"
 #include "afk/io/Time.hpp"
+#include "afk/render/Camera.hpp"
 #include "afk/render/WireframeMesh.hpp"
 #include "afk/utility/Visitor.hpp"
 
@@ -15,13 +21,23 @@ using afk::ecs::component::ColliderComponent;
 using afk::ecs::component::PhysicsComponent;
 using afk::ecs::component::TransformComponent;
 using afk::ecs::system::CollisionSystem;
+using afk::physics::ContactBuffer;
+using afk::physics::Aabb;
+using afk::physics::AabbTree;
+using afk::physics::WorldBox;
+using afk::physics::WorldShape;
+using afk::physics::WorldSphere;
 using afk::render::Index;
 using afk::render::WireframeMesh;
 
-CollisionSystem::CollisionSystem() {
+CollisionSystem::CollisionSystem(afk::World &owner) : owner(owner) {
 
   // Set the debug logger for events in ReactPhysics3D
-  this->physics_common.setLogger(&(this->logger));
+  this->physics_common.setLogger(&CollisionSystem::logger);
+
+  // let the ReactPhysics3D callbacks find the world they're reporting on
+  this->event_listener.collision_system     = this;
+  this->collision_callback.collision_system = this;
 }
 
 auto CollisionSystem::initialize() -> void {
@@ -29,88 +45,106 @@ auto CollisionSystem::initialize() -> void {
   afk::io::log << afk::io::get_date_time() << "Collision System initialized\n";
 
   // setup callback for when a ColliderComponent is destroyed so it can cleanup data related to the component
-  auto &registry = afk::Engine::get().ecs.registry;
-  registry.on_destroy<ColliderComponent>().connect<&CollisionSystem::on_collider_destroy>();
+  auto &registry = this->owner.ecs.registry;
+  registry.on_destroy<ColliderComponent>().connect<&CollisionSystem::on_collider_destroy>(*this);
 
   // instantiate the reactphysics3d world
   this->world = this->create_rp3d_physics_world();
 
+  this->broad_phase.set_fat_margin(CollisionSystem::BROAD_PHASE_FAT_MARGIN);
+
   this->is_initialized = true;
 }
 
 auto CollisionSystem::on_collider_destroy(afk::ecs::Registry &registry,
                                           afk::ecs::Entity entity) -> void {
-  auto &engine           = afk::Engine::get();
-  auto &collision_system = engine.collision_system;
-
-  afk_assert(collision_system.ecs_entity_to_rp3d_body_index_map.count(entity) == 1,
-             "rp3d body index not mapped to ecs entity");
-  const auto collider_index =
-      collision_system.ecs_entity_to_rp3d_body_index_map.at(entity);
-  auto collider = collision_system.world->getCollisionBody(collider_index);
+  auto &collider = registry.get<ColliderComponent>(entity);
+  afk_assert(collider.body != nullptr, "Collider component has no rp3d body");
 
-  // grab the reactphysics3d internal entity for later when we want to delete the mappings
-  auto rp3d_id_entity = collider->getEntity().id;
+  // grab the shapes before destroying the body, as destroying it destroys its colliders
+  auto shapes = std::vector<rp3d::CollisionShape *>{};
+  shapes.reserve(collider.body->getNbColliders());
 
-  // destroy the body in reactphysics3d
-  collision_system.world->destroyCollisionBody(collider);
+  for (auto i = u32{0}; i < collider.body->getNbColliders(); ++i) {
+    shapes.push_back(collider.body->getCollider(i)->getCollisionShape());
+  }
 
-  // destroy the mappings of reactphysics3d objects
-  collision_system.ecs_entity_to_rp3d_body_index_map.erase(
-      entity); // already guarenteed to be present earlier in the method, so no need to check if it exists again
+  // take the colliders out of the broad phase, leaving their world colliders for the next colliders made
+  for (const auto index : collider.world_colliders) {
+    auto &world_collider = this->world_colliders[index];
+    this->broad_phase.remove(world_collider.proxy);
 
-  // while the program *may* run fine if these mappings are not deleted, it may run into undefined behaviour and possibly fail elsewhere, hence the use of assertions
-  // if the mappings are not deleted, only chuck a fuss in debug mode, but still log it as an error as it is concerning
-  if (collision_system.rp3d_body_index_to_ecs_entity_map.count(collider_index) == 1) {
-    collision_system.rp3d_body_index_to_ecs_entity_map.erase(collider_index);
-  } else {
-    afk::io::log << "Warning: Failed to find rp3d body index in "
-                    "rp3d_boxy_index_to_ecs_entity_map\n";
-    afk_assert_debug(false, "Warning: Failed to find rp3d body index in "
-                            "rp3d_boxy_index_to_ecs_entity_map\n");
+    world_collider = WorldCollider{};
+    this->free_world_colliders.push_back(index);
   }
-  if (collision_system.rp3d_body_id_to_ecs_entity_map.count(rp3d_id_entity) == 1) {
-    collision_system.rp3d_body_id_to_ecs_entity_map.erase(rp3d_id_entity);
-  } else {
-    afk::io::log << "Warning: Failed to find rp3d id in "
-                    "rp3d_body_id_to_ecs_entity_map\n";
-    afk_assert_debug(false, "Warning: Failed to find rp3d id in "
-                            "rp3d_body_id_to_ecs_entity_map\n");
+
+  collider.world_colliders.clear();
+
+  // destroy the body in reactphysics3d
+  this->world->destroyCollisionBody(collider.body);
+  collider.body = nullptr;
+
+  for (const auto shape : shapes) {
+    this->release_shape(shape);
   }
 
   // if the entity also has a PhysicsComponent, also delete that component as the PhysicsComponent should always have a ColliderComponent
   registry.remove_if_exists<PhysicsComponent>(entity);
 }
 
-auto CollisionSystem::update() -> void {
-  auto &afk = afk::Engine::get();
+auto CollisionSystem::update(f32 dt) -> void {
+  afk_profile_scope("CollisionSystem::update");
 
   this->syncronize_colliders();
 
-  this->update_camera_raycast();
+  // the native narrow phase already found this update's contacts while updating the contact cache,
+  // and trigger overlaps are found from the broad phase, so ReactPhysics3D only needs updating for
+  // what it still provides: its own contacts and trigger events as a fallback, and the debug mesh
+  this->world->setIsDebugRenderingEnabled(this->is_debug_mesh_enabled);
+
+  if (this->is_native_narrow_phase_enabled) {
+    this->update_trigger_overlaps();
+  }
 
-  // update React3DPhysics world
-  // this method calls to update the debug render data
-  // this method fires collision events
-  // this method also unnecessarily does physics calculations for any rigid bodies, though none should be created in the game engine
-  this->world->update(afk.get_delta_time());
+  if (!this->is_native_narrow_phase_enabled || this->is_debug_mesh_enabled) {
+    // update React3DPhysics world
+    // this method calls to update the debug render data
+    // this method fires collision events
+    // this method also unnecessarily does physics calculations for any rigid bodies, though none should be created in the game engine
+    this->collision_contacts.clear();
+    this->world->update(dt);
+  }
+
+  const auto &contacts =
+      this->is_native_narrow_phase_enabled ? this->cache_contacts : this->collision_contacts;
+
+  // send every collision of the step as a single event, rather than one per pair
+  if (!contacts.is_empty()) {
+    this->owner.event_manager.push_event(
+        afk::event::Event{contacts.get_event_data(), afk::event::Event::Type::Collision});
+  }
 }
 
 auto CollisionSystem::syncronize_colliders() -> void {
-  auto &afk      = afk::Engine::get();
-  auto &registry = afk.ecs.registry;
+  afk_profile_scope("CollisionSystem::syncronize_colliders");
 
-  // update every collider component, regardless if it has a physics component or not (transform for an entity may need to be moved regardless)
-  auto collider_view = registry.view<ColliderComponent, TransformComponent>();
+  auto &registry = this->owner.ecs.registry;
+
+  // only update colliders whose transform has changed since they were last synchronised, regardless if it has a physics component or not
+  // most colliders are static level geometry that never moves, so this is usually a small fraction of them
+  this->remove_duplicate_dirty_entities();
 
   // update translation and rotation in react physics 3d representation
   // @todo apply scale dynamically, most likely need to trigger a change and at that point make new rp3d shapes that are scaled
-  for (auto &entity : collider_view) {
-    auto &transform = collider_view.get<TransformComponent>(entity);
-    afk_assert(this->ecs_entity_to_rp3d_body_index_map.count(entity) == 1,
-               "ECS entity is not mapped to a rp3d body");
-    const auto rp3d_body_index = this->ecs_entity_to_rp3d_body_index_map.at(entity);
-    const auto rp3d_body       = this->world->getCollisionBody(rp3d_body_index);
+  for (const auto entity : this->dirty_entities) {
+    // the entity may have been destroyed, or lost its collider, since it moved
+    if (!registry.valid(entity) || !registry.has<ColliderComponent, TransformComponent>(entity)) {
+      continue;
+    }
+
+    auto &transform      = registry.get<TransformComponent>(entity);
+    const auto rp3d_body = registry.get<ColliderComponent>(entity).body;
+    afk_assert(rp3d_body != nullptr, "ECS entity is not mapped to a rp3d body");
 
     const auto rp3d_transform = rp3d::Transform(
         rp3d::Vector3(transform.translation.x, transform.translation.y,
@@ -123,57 +157,290 @@ auto CollisionSystem::syncronize_colliders() -> void {
     // normalize rotation
     transform.rotation = glm::normalize(transform.rotation);
   }
+
+  this->refit_world_colliders();
+
+  this->dirty_entities.clear();
+}
+
+auto CollisionSystem::set_transform_dirty(afk::ecs::Entity entity) -> void {
+  this->dirty_entities.push_back(entity);
+}
+
+auto CollisionSystem::remove_duplicate_dirty_entities() -> void {
+  std::sort(this->dirty_entities.begin(), this->dirty_entities.end());
+  this->dirty_entities.erase(std::unique(this->dirty_entities.begin(), this->dirty_entities.end()),
+                             this->dirty_entities.end());
 }
 
-auto CollisionSystem::update_camera_raycast() -> void {
-  auto &afk = afk::Engine::get();
+/**
+ * Get the shape of a collider in world space
+ *
+ * @param collider the collider
+ * @param transform transform of the entity the collider belongs to
+ *
+ * @return the collider's shape in world space
+ */
+static auto get_world_shape(const ColliderComponent::Collider &collider,
+                            const TransformComponent &transform) -> WorldShape {
+  // match how instantiate_collider_component() places the rp3d collider,
+  // scale only applies to the shape's dimensions
+  const auto center   = transform.translation + transform.rotation * collider.transform.translation;
+  const auto rotation = transform.rotation * collider.transform.rotation;
+  const auto scale    = collider.transform.scale * transform.scale;
+
+  auto visitor = afk::utility::Visitor{
+      [&](afk::physics::shape::Box box) -> WorldShape {
+        return WorldBox{center, rotation, box * scale};
+      },
+      [&](afk::physics::shape::Sphere sphere) -> WorldShape {
+        return WorldSphere{center, sphere * ((scale.x + scale.y + scale.z) / 3.0f)};
+      },
+      [](auto) -> WorldShape { afk_unreachable(); }};
+
+  return std::visit(visitor, collider.shape);
+}
 
-  // set camera raycast entity to nothing
-  afk.camera.set_raycast_entity(std::nullopt);
+/**
+ * Get the bounding box of a shape in world space
+ *
+ * @param shape the shape
+ *
+ * @return the bounding box
+ */
+static auto get_shape_bounds(const WorldShape &shape) -> Aabb {
+  return std::visit([](const auto &volume) { return afk::physics::get_bounds(volume); }, shape);
+}
 
-  // throw away unnecessary raycast info left ovver
-  this->camera_raycast_info.clear();
+auto CollisionSystem::refit_world_colliders() -> void {
+  auto &registry = this->owner.ecs.registry;
 
-  // build camera raycast
-  const auto camera_front = afk.camera.get_front();
-  const auto camera_front_rp3d =
-      rp3d::Vector3(camera_front.x, camera_front.y, camera_front.z);
-  const auto camera_pos = afk.camera.get_position();
-  const auto camera_pos_rp3d =
-      rp3d::Vector3(camera_pos.x, camera_pos.y, camera_pos.z);
+  // only colliders whose transform has changed can have moved, every other
+  // collider keeps its place in the broad phase
+  if (this->dirty_entities.empty()) {
+    return;
+  }
 
-  auto camera_ray =
-      rp3d::Ray(camera_front_rp3d * afk.camera.get_near() + camera_pos_rp3d,
-                camera_front_rp3d * afk.camera.get_far() + camera_pos_rp3d);
+  afk_profile_scope("CollisionSystem::refit_world_colliders");
 
-  // populate raycast info
-  this->world->raycast(camera_ray, &raycast_callback);
+  this->remove_duplicate_dirty_entities();
 
-  // process raycast hit data if any exists, get the closest one to set in the camera, then delete the data
-  if (!this->camera_raycast_info.empty()) {
-    auto shortest_raycast_index = size_t{0};
-    for (auto i = size_t{0}; i < this->camera_raycast_info.size(); ++i) {
-      // if hit fraction is lower, that means it is closer to the camera, hence set that as the shortest raycast
-      if (this->camera_raycast_info[i].hit_fraction <
-          this->camera_raycast_info[shortest_raycast_index].hit_fraction) {
-        shortest_raycast_index = i;
-      }
+  for (const auto entity : this->dirty_entities) {
+    if (!registry.valid(entity) || !registry.has<ColliderComponent, TransformComponent>(entity)) {
+      continue;
+    }
+
+    const auto &collider_component = registry.get<ColliderComponent>(entity);
+    const auto &transform          = registry.get<TransformComponent>(entity);
+    afk_assert(collider_component.world_colliders.size() == collider_component.colliders.size(),
+               "Collider component has not been instantiated");
+
+    for (auto i = usize{0}; i < collider_component.colliders.size(); ++i) {
+      auto &world_collider  = this->world_colliders[collider_component.world_colliders[i]];
+      world_collider.volume = get_world_shape(collider_component.colliders[i], transform);
+      world_collider.bounds = get_shape_bounds(world_collider.volume);
+
+      // most colliders barely move between steps, so stay inside their leaf of the tree
+      this->broad_phase.move(world_collider.proxy, world_collider.bounds);
     }
+  }
+}
+
+template<typename Query, typename Fn>
+auto CollisionSystem::run_queries(std::span<const Query> queries,
+                                  std::vector<QueryResult> &results, Fn &&run_query) -> void {
+  // ReactPhysics3D's queries aren't safe to run from multiple threads, so
+  // queries are run against the broad phase and world colliders instead
+  this->refit_world_colliders();
 
-    const auto &shortest_raycast = this->camera_raycast_info[shortest_raycast_index];
-    afk_assert(shortest_raycast.collision_body != nullptr,
-               "Raycast body is null");
-    const auto hit_body_id = shortest_raycast.collision_body->getEntity().id;
+  results.resize(queries.size());
 
-    afk_assert(this->rp3d_body_id_to_ecs_entity_map.count(hit_body_id) == 1,
-               "Raycast hit a collider that is not mapped");
+  // each query only reads the broad phase and writes its own result, so they can run in any order on any thread
+  this->owner.job_manager.parallel_for(queries.size(), [&](usize i) {
+    const auto &query = queries[i];
+    auto &result      = results[i];
 
-    const auto hit_entity = this->rp3d_body_id_to_ecs_entity_map.at(hit_body_id);
+    result.clear();
 
-    afk.camera.set_raycast_entity(hit_entity);
+    auto collector =
+        HitCollector{query.mode, query.mask, query.is_hitting_triggers, query.ignored, &result};
+    run_query(i, collector);
+
+    if (query.mode == QueryMode::All) {
+      std::stable_sort(result.begin(), result.end(), [](const QueryHit &lhs, const QueryHit &rhs) {
+        return lhs.fraction < rhs.fraction;
+      });
+    }
+  });
+}
 
-    // throw away unnecessary raycast info
-    this->camera_raycast_info.clear();
+auto CollisionSystem::HitCollector::is_testing(const WorldCollider &collider) const -> bool {
+  return (collider.category & this->mask) != 0 &&
+         (!collider.is_trigger || this->is_hitting_triggers) &&
+         !(this->ignored.has_value() && collider.entity == *this->ignored);
+}
+
+auto CollisionSystem::HitCollector::add(const QueryHit &hit) -> void {
+  auto &hits = *this->result;
+
+  if (this->mode == QueryMode::All) {
+    hits.push_back(hit);
+    return;
+  }
+
+  if (hits.empty()) {
+    hits.push_back(hit);
+  } else if (hit.fraction < hits.front().fraction) {
+    hits.front() = hit;
+  }
+
+  this->closest = hits.front().fraction;
+
+  // nothing can be closer than a hit at the start, which every overlap is
+  this->is_done = this->mode == QueryMode::Any || this->closest <= 0.0f;
+}
+
+auto CollisionSystem::update_camera_raycast(afk::render::Camera &camera) -> void {
+  // cast a ray along the camera's view, from its near plane to its far plane
+  const auto camera_front = camera.get_front();
+  const auto camera_pos   = camera.get_position();
+
+  const auto query = RaycastQuery{camera_front * camera.get_near() + camera_pos,
+                                  camera_front * camera.get_far() + camera_pos};
+
+  auto results = std::vector<QueryResult>{};
+  this->raycast(std::span{&query, 1}, results);
+
+  if (results.front().empty()) {
+    camera.set_raycast_entity(std::nullopt);
+  } else {
+    camera.set_raycast_entity(results.front().front().entity);
+  }
+}
+
+auto CollisionSystem::raycast(std::span<const RaycastQuery> queries,
+                              std::vector<QueryResult> &results) -> void {
+  afk_profile_scope("CollisionSystem::raycast");
+
+  this->run_queries(queries, results, [&](usize i, HitCollector &collector) {
+    const auto &query = queries[i];
+
+    // the tree skips every collider the ray reaches after the closest hit so far
+    this->broad_phase.raycast(query.from, query.to, glm::vec3{0.0f}, [&](usize index) {
+      const auto &collider = this->world_colliders[index];
+
+      // the tree's boxes are grown, so reject by the collider's own bounding box before its shape
+      const auto entry = afk::physics::intersect_segment(query.from, query.to, collider.bounds);
+
+      if (!collector.is_testing(collider) || !entry.has_value() || *entry > collector.closest) {
+        return collector.closest;
+      }
+
+      const auto hit = std::visit(
+          [&query](const auto &volume) {
+            return afk::physics::intersect_segment(query.from, query.to, volume);
+          },
+          collider.volume);
+
+      if (hit.has_value()) {
+        const auto point = query.from + (query.to - query.from) * hit->fraction;
+        collector.add(QueryHit{collider.entity, point, hit->normal, hit->fraction});
+      }
+
+      return collector.is_done ? -1.0f : collector.closest;
+    });
+  });
+}
+
+auto CollisionSystem::sweep(std::span<const SweepQuery> queries,
+                            std::vector<QueryResult> &results) -> void {
+  afk_profile_scope("CollisionSystem::sweep");
+
+  this->run_queries(queries, results, [&](usize i, HitCollector &collector) {
+    const auto &query  = queries[i];
+    const auto padding = glm::vec3{query.radius};
+
+    // sweeping a sphere against a shape is the same as casting its centre
+    // against the shape grown by its radius
+    this->broad_phase.raycast(query.from, query.to, padding, [&](usize index) {
+      const auto &collider = this->world_colliders[index];
+
+      const auto bounds = Aabb{collider.bounds.min - padding, collider.bounds.max + padding};
+      const auto entry  = afk::physics::intersect_segment(query.from, query.to, bounds);
+
+      if (!collector.is_testing(collider) || !entry.has_value() || *entry > collector.closest) {
+        return collector.closest;
+      }
+
+      const auto hit =
+          afk::physics::sweep_sphere(query.from, query.to, query.radius, collider.volume);
+
+      // a sphere resting against a collider starts inside it, and would otherwise hit it straight away
+      if (hit.has_value() && (hit->fraction > 0.0f || query.is_hitting_initial_overlaps)) {
+        const auto center = query.from + (query.to - query.from) * hit->fraction;
+        collector.add(QueryHit{collider.entity, center, hit->normal, hit->fraction});
+      }
+
+      return collector.is_done ? -1.0f : collector.closest;
+    });
+  });
+}
+
+auto CollisionSystem::overlap(std::span<const OverlapQuery> queries,
+                              std::vector<QueryResult> &results) -> void {
+  afk_profile_scope("CollisionSystem::overlap");
+
+  this->run_queries(queries, results, [&](usize i, HitCollector &collector) {
+    const auto &query = queries[i];
+    const auto bounds = get_shape_bounds(query.volume);
+
+    this->broad_phase.query(bounds, [&](usize index) {
+      const auto &collider = this->world_colliders[index];
+
+      if (collector.is_testing(collider) &&
+          afk::physics::is_overlapping(bounds, collider.bounds) &&
+          afk::physics::is_overlapping(query.volume, collider.volume)) {
+        collector.add(QueryHit{collider.entity});
+      }
+
+      return !collector.is_done;
+    });
+  });
+}
+
+auto CollisionSystem::get_bounds(afk::ecs::Entity entity) -> std::pair<glm::vec3, glm::vec3> {
+  const auto rp3d_body = this->owner.ecs.registry.get<ColliderComponent>(entity).body;
+  afk_assert(rp3d_body != nullptr, "ECS entity is not mapped to a rp3d body");
+
+  const auto aabb = rp3d_body->getAABB();
+  const auto min  = aabb.getMin();
+  const auto max  = aabb.getMax();
+
+  return {glm::vec3{min.x, min.y, min.z}, glm::vec3{max.x, max.y, max.z}};
+}
+
+auto CollisionSystem::get_broad_phase_stats() const -> AabbTree::Stats {
+  return this->broad_phase.get_stats();
+}
+
+auto CollisionSystem::set_is_resting(afk::ecs::Entity entity, bool is_resting) -> void {
+  const auto &collider_component = this->owner.ecs.registry.get<ColliderComponent>(entity);
+  const auto rp3d_body           = collider_component.body;
+  afk_assert(rp3d_body != nullptr, "ECS entity is not mapped to a rp3d body");
+
+  // rp3d colliders are added in the same order as the component's colliders
+  for (auto i = u32{0}; i < rp3d_body->getNbColliders(); ++i) {
+    const auto [category, mask] =
+        CollisionSystem::get_collision_filter(collider_component.colliders[i], is_resting);
+
+    auto collider = rp3d_body->getCollider(i);
+    collider->setCollisionCategoryBits(category);
+    collider->setCollideWithMaskBits(mask);
+
+    auto &world_collider           = this->world_colliders[collider_component.world_colliders[i]];
+    world_collider.is_resting      = is_resting && !world_collider.is_trigger;
+    world_collider.filter_category = category;
+    world_collider.filter_mask     = mask;
   }
 }
 
@@ -181,9 +448,8 @@ auto CollisionSystem::instantiate_collider_component(
     const afk::ecs::Entity &entity, afk::ecs::component::ColliderComponent &collider_component,
     const afk::ecs::component::TransformComponent &transform_component) -> void {
   // check if entity has already had a collider component loaded
-  afk_assert(
-      this->ecs_entity_to_rp3d_body_index_map.count(entity) == 0,
-      "Collider component has already being loaded for the given entity");
+  afk_assert(collider_component.body == nullptr,
+             "Collider component has already being loaded for the given entity");
 
   const auto rp3d_parent_transform =
       rp3d::Transform(rp3d::Vector3(transform_component.translation.x,
@@ -198,27 +464,9 @@ auto CollisionSystem::instantiate_collider_component(
   // note that the scale is not included in rp3d transform, so collision bodies will be manually scaled later
   auto body = this->world->createCollisionBody(rp3d_parent_transform);
 
-  // find the index of the collision body
-  const auto no_collision_bodies = this->world->getNbCollisionBodies();
-  for (auto i = u32{0}; i < no_collision_bodies; ++i) {
-    if (this->world->getCollisionBody(i)->getEntity().id == body->getEntity().id) {
-      // check that the rp3d body has not already been mapped to a afk ecs entity
-      afk_assert(this->rp3d_body_index_to_ecs_entity_map.count(i) == 0,
-                 "ReactPhysics3D body index has already being mapped to an AFK "
-                 "ECS entity");
-
-      // add associations between rp3d body id and afk ecs entity
-      this->ecs_entity_to_rp3d_body_index_map.insert({entity, i});
-      this->rp3d_body_index_to_ecs_entity_map.insert({i, entity});
-
-      break;
-    }
-  }
-
-  afk_assert(
-      this->rp3d_body_id_to_ecs_entity_map.count(body->getEntity().id) == 0,
-      "ReactPhysics body id has already being mapped to an AFK ECS Entity");
-  this->rp3d_body_id_to_ecs_entity_map.insert({body->getEntity().id, entity});
+  // associate the body and the entity with each other, so either can be found from the other
+  body->setUserData(CollisionSystem::get_user_data(entity));
+  collider_component.body = body;
 
   for (const auto &collision_body : collider_component.colliders) {
     // combine collider transform scale with parent transform
@@ -236,21 +484,37 @@ auto CollisionSystem::instantiate_collider_component(
                                          collision_transform.rotation.z,
                                          collision_transform.rotation.w));
 
-    // add collider based on collider type
-    auto visitor = afk::utility::Visitor{
-        [this, &collision_transform, &rp3d_transform, &body](afk::physics::shape::Box shape) {
-          // add rp3d shape and rp3d transform to collider
-          body->addCollider(this->create_shape_box(shape, collision_transform.scale),
-                            rp3d_transform);
-        },
-        [this, &collision_transform, &rp3d_transform, &body](afk::physics::shape::Sphere shape) {
-          // add rp3d shape and rp3d transform to collider
-          body->addCollider(this->create_shape_sphere(shape, collision_transform.scale),
-                            rp3d_transform);
-        },
-        [](auto) { afk_unreachable(); }};
+    // add rp3d shape and rp3d transform to collider
+    auto collider =
+        body->addCollider(this->acquire_shape(collision_body.shape, collision_transform.scale),
+                          rp3d_transform);
+
+    // filter out pairs that can never touch before ReactPhysics3D tests them
+    const auto [category, mask] = CollisionSystem::get_collision_filter(collision_body, false);
+    collider->setCollisionCategoryBits(category);
+    collider->setCollideWithMaskBits(mask);
+    collider->setIsTrigger(collision_body.is_trigger);
+
+    // reuse the world collider of a destroyed collider if there is one
+    auto index = u32{0};
+
+    if (this->free_world_colliders.empty()) {
+      index = static_cast<u32>(this->world_colliders.size());
+      this->world_colliders.emplace_back();
+    } else {
+      index = this->free_world_colliders.back();
+      this->free_world_colliders.pop_back();
+    }
+
+    const auto volume = get_world_shape(collision_body, transform_component);
+    const auto bounds = get_shape_bounds(volume);
+
+    auto &world_collider = this->world_colliders[index];
+    world_collider       = WorldCollider{entity, collision_body.category, collision_body.is_trigger,
+                                         false,  category, mask, volume, bounds};
+    world_collider.proxy = this->broad_phase.insert(bounds, index);
 
-    std::visit(visitor, collision_body.shape);
+    collider_component.world_colliders.push_back(index);
   }
 }
 
@@ -340,22 +604,159 @@ auto CollisionSystem::get_debug_mesh() -> WireframeMesh {
   return mesh;
 }
 
-[[nodiscard]] std::vector<afk::event::Event::Collision> CollisionSystem::get_current_collisions() {
-  // make srue colliders are up to date
+auto CollisionSystem::update_contact_cache() -> void {
+  afk_profile_scope("CollisionSystem::update_contact_cache");
+
+  // make sure colliders are up to date
   this->syncronize_colliders();
 
-  // clear and initialise temporary store
-  this->temporary_collisions.clear();
+  // clear the contacts of the last step, keeping their memory for this one
+  this->cache_contacts.clear();
+
+  // perform tests
+  if (this->is_native_narrow_phase_enabled) {
+    this->find_contacts();
+  } else {
+    this->world->testCollision(this->collision_callback);
+  }
+
+  this->contact_cache.rebuild(this->cache_contacts);
+}
+
+auto CollisionSystem::find_contacts() -> void {
+  afk_profile_scope("CollisionSystem::find_contacts");
 
-  //// perform tests
-  this->world->testCollision(this->collision_callback);
+  this->narrow_phase.clear();
 
-  //// empty the temporary store
-  auto collisions            = std::move(CollisionSystem::temporary_collisions);
-  this->temporary_collisions = {};
+  // resting colliders never touch each other, so every pair has a collider
+  // that isn't resting, and only those need to look for what they touch
+  for (auto i = usize{0}; i < this->world_colliders.size(); ++i) {
+    const auto &lhs = this->world_colliders[i];
 
-  // return the collisions
-  return collisions;
+    // triggers are never resolved, so aren't given contacts
+    if (lhs.proxy == AabbTree::NULL_NODE || lhs.is_trigger || lhs.is_resting) {
+      continue;
+    }
+
+    this->broad_phase.query(lhs.bounds, [&](usize j) {
+      const auto &rhs = this->world_colliders[j];
+
+      // pairs where neither collider is resting are found from both sides, so only keep one
+      if (j == i || (!rhs.is_resting && j < i)) {
+        return true;
+      }
+
+      // the same filter ReactPhysics3D applies, so pairs in layers that can't touch are skipped
+      const auto is_filtered = (lhs.filter_category & rhs.filter_mask) == 0 ||
+                               (rhs.filter_category & lhs.filter_mask) == 0;
+
+      if (rhs.is_trigger || is_filtered || lhs.entity == rhs.entity ||
+          !afk::physics::is_overlapping(lhs.bounds, rhs.bounds)) {
+        return true;
+      }
+
+      this->narrow_phase.add_pair(lhs.entity, lhs.volume, rhs.entity, rhs.volume);
+
+      return true;
+    });
+  }
+
+  this->narrow_phase.generate(this->cache_contacts);
+}
+
+auto CollisionSystem::update_trigger_overlaps() -> void {
+  afk_profile_scope("CollisionSystem::update_trigger_overlaps");
+
+  auto &registry = this->owner.ecs.registry;
+
+  this->new_trigger_overlaps.clear();
+
+  for (auto i = usize{0}; i < this->world_colliders.size(); ++i) {
+    const auto &lhs = this->world_colliders[i];
+
+    if (lhs.proxy == AabbTree::NULL_NODE || !lhs.is_trigger) {
+      continue;
+    }
+
+    this->broad_phase.query(lhs.bounds, [&](usize j) {
+      const auto &rhs = this->world_colliders[j];
+
+      // the same filter ReactPhysics3D applies, triggers are never resting so they still see resting colliders
+      const auto is_filtered = (lhs.filter_category & rhs.filter_mask) == 0 ||
+                               (rhs.filter_category & lhs.filter_mask) == 0;
+
+      if (is_filtered || lhs.entity == rhs.entity ||
+          !afk::physics::is_overlapping(lhs.bounds, rhs.bounds) ||
+          !afk::physics::is_overlapping(lhs.volume, rhs.volume)) {
+        return true;
+      }
+
+      // two triggers find each other from both sides, so keep them in one order
+      if (rhs.is_trigger) {
+        this->new_trigger_overlaps.push_back(std::minmax(lhs.entity, rhs.entity));
+      } else {
+        this->new_trigger_overlaps.emplace_back(lhs.entity, rhs.entity);
+      }
+
+      return true;
+    });
+  }
+
+  // entities with several colliders overlap more than once
+  auto &overlaps = this->new_trigger_overlaps;
+  std::sort(overlaps.begin(), overlaps.end());
+  overlaps.erase(std::unique(overlaps.begin(), overlaps.end()), overlaps.end());
+
+  const auto push_event = [&](const TriggerOverlap &overlap, afk::event::Event::Type type) {
+    // an entity destroyed since the last update has nothing left to report
+    if (registry.valid(overlap.first) && registry.valid(overlap.second)) {
+      this->owner.event_manager.push_event(
+          afk::event::Event{afk::event::Event::Trigger{overlap.first, overlap.second}, type});
+    }
+  };
+
+  // both are sorted, so walk them together to find the overlaps that started and stopped
+  auto last    = this->trigger_overlaps.cbegin();
+  auto current = overlaps.cbegin();
+
+  while (last != this->trigger_overlaps.cend() || current != overlaps.cend()) {
+    if (current == overlaps.cend() || (last != this->trigger_overlaps.cend() && *last < *current)) {
+      push_event(*last, afk::event::Event::Type::TriggerExit);
+      ++last;
+    } else if (last == this->trigger_overlaps.cend() || *current < *last) {
+      push_event(*current, afk::event::Event::Type::TriggerEnter);
+      ++current;
+    } else {
+      ++last;
+      ++current;
+    }
+  }
+
+  std::swap(this->trigger_overlaps, this->new_trigger_overlaps);
+}
+
+auto CollisionSystem::get_collision_filter(const ColliderComponent::Collider &collider,
+                                           bool is_resting) -> std::pair<u16, u16> {
+  const auto category = static_cast<u16>(collider.category);
+  const auto mask     = static_cast<u16>(collider.mask);
+
+  // triggers report overlaps with anything, so a trigger on a body that falls asleep
+  // must keep testing against other resting colliders, or every overlap would exit
+  if (is_resting && !collider.is_trigger) {
+    return {static_cast<u16>(category << CollisionSystem::RESTING_LAYER_SHIFT), mask};
+  }
+
+  return {category, static_cast<u16>(mask | (mask << CollisionSystem::RESTING_LAYER_SHIFT))};
+}
+
+auto CollisionSystem::get_user_data(afk::ecs::Entity entity) -> void * {
+  return reinterpret_cast<void *>(static_cast<std::uintptr_t>(static_cast<u32>(entity)));
+}
+
+auto CollisionSystem::get_entity(const rp3d::CollisionBody &body) -> afk::ecs::Entity {
+  const auto user_data = reinterpret_cast<std::uintptr_t>(body.getUserData());
+
+  return static_cast<afk::ecs::Entity>(static_cast<u32>(user_data));
 }
 
 rp3d::PhysicsWorld *CollisionSystem::create_rp3d_physics_world() {
@@ -365,18 +766,15 @@ rp3d::PhysicsWorld *CollisionSystem::create_rp3d_physics_world() {
   physics_world->setIsGravityEnabled(false);
 
   // Turn off sleeping of collisions.
-  // Then bodies are colliding but aren't really changing their state for a while, they will be put to 'sleep' to stop testing collisions.
-  // Putting a body to sleep will make it no longer appear to be colliding externally.
-  // Temporarily, we will be disabling this optimisation for simplicity's sake, so we can process every collision
-  // @todo remove the need to turn off the sleeping optimisation in ReactPhysics3D
+  // ReactPhysics3D only puts its own rigid bodies to sleep, and putting a body to sleep will make it no longer appear to be colliding externally.
+  // The physics system puts islands to sleep itself instead, marking their colliders as resting so they aren't tested against each other
   physics_world->enableSleeping(false);
 
   // Set event listener used for firing collision events that occur in the ReactPhysics3D world
   physics_world->setEventListener(&this->event_listener);
 
-  // turn on debug renderer so ReactPhysics3D creates render data
-  // @todo turn off debug ReactPhysics3D data to be generated in ReactPhysics3D when debug rendering is not being used
-  physics_world->setIsDebugRenderingEnabled(true);
+  // ReactPhysics3D only creates render data while the debug mesh is displayed, see update()
+  physics_world->setIsDebugRenderingEnabled(false);
 
   // Set all debug items to be displayed
   // @todo set which debug items to generate display data for in GUI
@@ -394,6 +792,72 @@ rp3d::PhysicsWorld *CollisionSystem::create_rp3d_physics_world() {
   return physics_world;
 }
 
+rp3d::CollisionShape *CollisionSystem::acquire_shape(const ColliderComponent::ColliderShape &shape,
+                                                     const glm::vec3 &scale) {
+  // key by the dimensions the shape is created with, as that's all that makes two shapes different
+  auto visitor = afk::utility::Visitor{
+      [&scale](afk::physics::shape::Box box) {
+        return glm::vec3{box.x * scale.x, box.y * scale.y, box.z * scale.z};
+      },
+      [&scale](afk::physics::shape::Sphere sphere) {
+        return glm::vec3{sphere * ((scale.x + scale.y + scale.z) / 3.0f), 0.0f, 0.0f};
+      },
+      [](auto) -> glm::vec3 { afk_unreachable(); }};
+
+  const auto key = ShapeKey{shape.index(), std::visit(visitor, shape)};
+  auto &shared   = this->shapes[key];
+
+  if (shared.shape == nullptr) {
+    auto create_visitor = afk::utility::Visitor{
+        [this, &scale](afk::physics::shape::Box box) -> rp3d::CollisionShape * {
+          return this->create_shape_box(box, scale);
+        },
+        [this, &scale](afk::physics::shape::Sphere sphere) -> rp3d::CollisionShape * {
+          return this->create_shape_sphere(sphere, scale);
+        },
+        [](auto) -> rp3d::CollisionShape * { afk_unreachable(); }};
+
+    shared.shape = std::visit(create_visitor, shape);
+    this->shape_to_key_map.insert({shared.shape, key});
+  }
+
+  ++shared.reference_count;
+
+  return shared.shape;
+}
+
+auto CollisionSystem::release_shape(rp3d::CollisionShape *shape) -> void {
+  const auto key_it = this->shape_to_key_map.find(shape);
+  afk_assert(key_it != this->shape_to_key_map.end(), "Shape was not acquired from the shape cache");
+
+  const auto key = key_it->second;
+  auto &shared   = this->shapes.at(key);
+
+  afk_assert(shared.reference_count > 0, "Shape released more times than it was acquired");
+  --shared.reference_count;
+
+  if (shared.reference_count > 0) {
+    return;
+  }
+
+  this->shape_to_key_map.erase(key_it);
+  this->shapes.erase(key);
+
+  switch (shape->getName()) {
+    case rp3d::CollisionShapeName::BOX: {
+      this->physics_common.destroyBoxShape(static_cast<rp3d::BoxShape *>(shape));
+      break;
+    }
+    case rp3d::CollisionShapeName::SPHERE: {
+      this->physics_common.destroySphereShape(static_cast<rp3d::SphereShape *>(shape));
+      break;
+    }
+    default: {
+      afk_unreachable();
+    }
+  }
+}
+
 rp3d::BoxShape *CollisionSystem::create_shape_box(const afk::physics::shape::Box &box,
                                                   const glm::vec3 &scale) {
   return this->physics_common.createBoxShape(
@@ -406,153 +870,115 @@ rp3d::SphereShape *CollisionSystem::create_shape_sphere(const afk::physics::shap
   return this->physics_common.createSphereShape(sphere * scale_factor);
 }
 
+auto CollisionSystem::add_contact_pair(const rp3d::CollisionCallback::ContactPair &contact_pair,
+                                       ContactBuffer &buffer) -> void {
+  // get the AFK ECS entities of the colliders
+  const auto object1 = CollisionSystem::get_entity(*contact_pair.getBody1());
+  const auto object2 = CollisionSystem::get_entity(*contact_pair.getBody2());
+
+  // check that the colliders do not belong to the same entity in react physics 3d
+  if (object1 == object2) {
+    return;
+  }
+
+  // note that if a collision body is "sleeping" in reactphysics3d, a
+  // collision event of type ContactStay will not fire at the moment,
+  // "sleeping" is disabled treat contact enter and contact stay as "impulses"
+  const auto event_type = contact_pair.getEventType();
+
+  if (event_type != rp3d::CollisionCallback::ContactPair::EventType::ContactStart &&
+      event_type != rp3d::CollisionCallback::ContactPair::EventType::ContactStay) {
+    return;
+  }
+
+  afk_assert(contact_pair.getNbContactPoints() > 0, "No contact points found on collision");
+
+  const auto collider1_transform = contact_pair.getCollider1()->getLocalToWorldTransform();
+  const auto collider2_transform = contact_pair.getCollider2()->getLocalToWorldTransform();
+
+  buffer.add_pair(object1, object2);
+
+  for (auto i = u32{0}; i < contact_pair.getNbContactPoints(); ++i) {
+    const auto &contact_point = contact_pair.getContactPoint(i);
+    const auto collider1_rp3d_point =
+        collider1_transform * contact_point.getLocalPointOnCollider1();
+    const auto collider2_rp3d_point =
+        collider2_transform * contact_point.getLocalPointOnCollider2();
+    const auto contact_normal = contact_point.getWorldNormal();
+
+    buffer.add_contact(ContactBuffer::Contact{
+        glm::vec3{collider1_rp3d_point.x, collider1_rp3d_point.y, collider1_rp3d_point.z},
+        glm::vec3{collider2_rp3d_point.x, collider2_rp3d_point.y, collider2_rp3d_point.z},
+        glm::vec3{contact_normal.x, contact_normal.y, contact_normal.z},
+        contact_point.getPenetrationDepth()});
+  }
+}
+
 void CollisionSystem::CollisionEventListener::onContact(
     const rp3d::CollisionCallback::CallbackData &callback_data) {
+  // the collision event is built from the native narrow phase's contacts instead
+  if (this->collision_system->is_native_narrow_phase_enabled) {
+    return;
+  }
+
+  auto &collision_contacts = this->collision_system->collision_contacts;
+
   // On collision event, there will be two colliders colliding
   // Iterate over all these pairs
   for (rp3d::uint p = 0; p < callback_data.getNbContactPairs(); p++) {
+    CollisionSystem::add_contact_pair(callback_data.getContactPair(p), collision_contacts);
+  }
+}
 
-    // Get the contact pair
-    const auto contact_pair = callback_data.getContactPair(p);
+void CollisionSystem::CollisionEventListener::onTrigger(
+    const rp3d::OverlapCallback::CallbackData &callback_data) {
+  // trigger events are found from the broad phase instead, see update_trigger_overlaps()
+  if (this->collision_system->is_native_narrow_phase_enabled) {
+    return;
+  }
+
+  auto &event_manager = this->collision_system->owner.event_manager;
+
+  for (auto p = u32{0}; p < callback_data.getNbOverlappingPairs(); ++p) {
+    const auto overlap_pair = callback_data.getOverlappingPair(p);
+    const auto event_type   = overlap_pair.getEventType();
 
-    auto &engine = afk::Engine::get();
+    // only report overlaps starting and stopping, nothing has changed while they're still overlapping
+    if (event_type == rp3d::OverlapCallback::OverlapPair::EventType::OverlapStay) {
+      continue;
+    }
 
     // get the AFK ECS entities of the colliders
-    const auto body_to_ecs_map = &engine.collision_system.rp3d_body_id_to_ecs_entity_map;
-    const auto body1IdMapIterator =
-        body_to_ecs_map->find(contact_pair.getBody1()->getEntity().id);
-    afk_assert(body1IdMapIterator != body_to_ecs_map->end(),
-               "Could not find body 1 id in rp3d_body_to_ecs_map");
-    const auto object1 = body1IdMapIterator->second;
-
-    auto body2IdMapIterator =
-        body_to_ecs_map->find(contact_pair.getBody2()->getEntity().id);
-    afk_assert(body2IdMapIterator != body_to_ecs_map->end(),
-               "Could not find body 2 id in rp3d_body_to_ecs_map");
-    auto object2 = body2IdMapIterator->second;
+    const auto object1 = CollisionSystem::get_entity(*overlap_pair.getBody1());
+    const auto object2 = CollisionSystem::get_entity(*overlap_pair.getBody2());
 
     // check that the colliders do not belong to the same entity in react physics 3d
-    if (object1 != object2) {
-
-      auto &event_manager = engine.event_manager;
-
-      // fire collision events
-      // note that if a collision body is "sleeping" in reactphysics3d, a
-      // collision event of type ContactStay will not fire at the moment,
-      // "sleeping" is disabled treat contact enter and contact stay as "impulses"
-
-      if (contact_pair.getEventType() == CollisionCallback::ContactPair::EventType::ContactStart ||
-          contact_pair.getEventType() == CollisionCallback::ContactPair::EventType::ContactStay) {
-        auto data = afk::event::Event::Collision{object1, object2, {}};
-
-        afk_assert(contact_pair.getNbContactPoints() > 0,
-                   "No contact points found on collision");
-
-        data.contacts.reserve(contact_pair.getNbContactPoints());
-        for (auto i = u32{0}; i < contact_pair.getNbContactPoints(); ++i) {
-          const auto &contact_point = contact_pair.getContactPoint(i);
-          const auto collider1_transform =
-              contact_pair.getCollider1()->getLocalToWorldTransform();
-          const auto collider2_transform =
-              contact_pair.getCollider2()->getLocalToWorldTransform();
-          const auto collider1_rp3d_point =
-              collider1_transform * contact_point.getLocalPointOnCollider1();
-          const auto collider2_rp3d_point =
-              collider2_transform * contact_point.getLocalPointOnCollider2();
-
-          const auto collider1_local_point =
-              glm::vec3{collider1_rp3d_point.x, collider1_rp3d_point.y,
-                        collider1_rp3d_point.z};
-          const auto collider2_local_point =
-              glm::vec3{collider2_rp3d_point.x, collider2_rp3d_point.y,
-                        collider2_rp3d_point.z};
-          const auto contact_normal = glm::vec3{contact_point.getWorldNormal().x,
-                                                contact_point.getWorldNormal().y,
-                                                contact_point.getWorldNormal().z};
-
-          data.contacts.push_back(afk::event::Event::Collision::Contact{
-              collider1_local_point, collider2_local_point, contact_normal,
-              contact_point.getPenetrationDepth()});
-        }
-
-        event_manager.push_event(afk::event::Event{data, afk::event::Event::Type::Collision});
-      }
+    if (object1 == object2) {
+      continue;
     }
+
+    const auto type = event_type == rp3d::OverlapCallback::OverlapPair::EventType::OverlapStart
+                          ? afk::event::Event::Type::TriggerEnter
+                          : afk::event::Event::Type::TriggerExit;
+
+    event_manager.push_event(afk::event::Event{afk::event::Event::Trigger{object1, object2}, type});
   }
 }
 
 void CollisionSystem::CollisionCallback::onContact(const rp3d::CollisionCallback::CallbackData &callback_data) {
-  auto &engine = afk::Engine::get();
-  engine.collision_system.temporary_collisions.resize(callback_data.getNbContactPairs());
+  auto &cache_contacts = this->collision_system->cache_contacts;
 
   // On collision event, there will be two colliders colliding
   // Iterate over all these pairs
   for (rp3d::uint p = 0; p < callback_data.getNbContactPairs(); p++) {
-
-    // Get the contact pair
     const auto contact_pair = callback_data.getContactPair(p);
 
-    // get the AFK ECS entities of the colliders
-    const auto body_to_ecs_map = &engine.collision_system.rp3d_body_id_to_ecs_entity_map;
-    const auto body1IdMapIterator =
-        body_to_ecs_map->find(contact_pair.getBody1()->getEntity().id);
-    afk_assert(body1IdMapIterator != body_to_ecs_map->end(),
-               "Could not find body 1 id in rp3d_body_to_ecs_map");
-    const auto object1 = body1IdMapIterator->second;
-
-    auto body2IdMapIterator =
-        body_to_ecs_map->find(contact_pair.getBody2()->getEntity().id);
-    afk_assert(body2IdMapIterator != body_to_ecs_map->end(),
-               "Could not find body 2 id in rp3d_body_to_ecs_map");
-    auto object2 = body2IdMapIterator->second;
-
-    // check that the colliders do not belong to the same entity in react physics 3d
-    if (object1 != object2) {
-
-      // fire collision events
-      // note that if a collision body is "sleeping" in reactphysics3d, a
-      // collision event of type ContactStay will not fire at the moment,
-      // "sleeping" is disabled treat contact enter and contact stay as "impulses"
-
-      if (contact_pair.getEventType() == CollisionCallback::ContactPair::EventType::ContactStart ||
-          contact_pair.getEventType() == CollisionCallback::ContactPair::EventType::ContactStay) {
-        auto data = afk::event::Event::Collision{object1, object2, {}};
-
-        afk_assert(contact_pair.getNbContactPoints() > 0,
-                   "No contact points found on collision");
-
-        data.contacts.reserve(contact_pair.getNbContactPoints());
-        for (auto i = u32{0}; i < contact_pair.getNbContactPoints(); ++i) {
-          const auto &contact_point = contact_pair.getContactPoint(i);
-          const auto collider1_transform =
-              contact_pair.getCollider1()->getLocalToWorldTransform();
-          const auto collider2_transform =
-              contact_pair.getCollider2()->getLocalToWorldTransform();
-          const auto collider1_rp3d_point =
-              collider1_transform * contact_point.getLocalPointOnCollider1();
-          const auto collider2_rp3d_point =
-              collider2_transform * contact_point.getLocalPointOnCollider2();
-
-          const auto collider1_local_point =
-              glm::vec3{collider1_rp3d_point.x, collider1_rp3d_point.y,
-                        collider1_rp3d_point.z};
-          const auto collider2_local_point =
-              glm::vec3{collider2_rp3d_point.x, collider2_rp3d_point.y,
-                        collider2_rp3d_point.z};
-          const auto contact_normal = glm::vec3{contact_point.getWorldNormal().x,
-                                                contact_point.getWorldNormal().y,
-                                                contact_point.getWorldNormal().z};
-
-          data.contacts.push_back(afk::event::Event::Collision::Contact{
-              collider1_local_point, collider2_local_point, contact_normal,
-              contact_point.getPenetrationDepth()});
-        }
-
-        // this is outright abuse of making the engine static and should not be encouraged
-        // @todo pass data into the collision system neatly
-        engine.collision_system.temporary_collisions.push_back(data);
-      }
+    // triggers are never resolved, so there's no need to keep their contacts
+    if (contact_pair.getCollider1()->getIsTrigger() || contact_pair.getCollider2()->getIsTrigger()) {
+      continue;
     }
+
+    CollisionSystem::add_contact_pair(contact_pair, cache_contacts);
   }
 }
 
@@ -566,13 +992,3 @@ void CollisionSystem::Logger::log(rp3d::Logger::Level level,
     afk::io::log << "[rp3d " << getLevelName(level) << "] " << message << "\n";
   }
 }
-
-rp3d::decimal CollisionSystem::RaycastCallback::notifyRaycastHit(const rp3d::RaycastInfo &info) {
-  auto &afk = afk::Engine::get();
-  // copy info
-  afk.collision_system.camera_raycast_info.push_back(RaycastHitInfo{info.body, info.hitFraction});
-
-  // return 1.0 so that rp3d knows to process more raycasts
-  // this is necessary because the order of raycast hits is not guarenteed
-  return 1.0f;
-}
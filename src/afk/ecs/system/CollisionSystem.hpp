@@ -1,6 +1,11 @@
 #pragma once
 
+#include <functional>
+#include <optional>
+#include <span>
 #include <unordered_map>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include <reactphysics3d/reactphysics3d.h>
@@ -10,10 +15,21 @@
 #include "afk/ecs/component/ColliderComponent.hpp"
 #include "afk/ecs/component/TransformComponent.hpp"
 #include "afk/event/Event.hpp"
+#include "afk/physics/AabbTree.hpp"
+#include "afk/physics/ContactBuffer.hpp"
+#include "afk/physics/ContactCache.hpp"
+#include "afk/physics/Geometry.hpp"
+#include "afk/physics/NarrowPhase.hpp"
 #include "afk/render/Mesh.hpp"
 #include "afk/render/WireframeMesh.hpp"
 
 namespace afk {
+  class World;
+
+  namespace render {
+    class Camera;
+  }
+
   namespace ecs {
     namespace system {
       class CollisionSystem {
@@ -21,8 +37,9 @@ namespace afk {
         /**
          * Constructor
          *
+         * @param owner the world this system belongs to
          */
-        CollisionSystem();
+        explicit CollisionSystem(afk::World &owner);
 
         /**
          * Destructor
@@ -49,29 +66,190 @@ namespace afk {
          * @param registry ECS registry
          * @param entity entity being destroyed
          */
-        static auto on_collider_destroy(afk::ecs::Registry &registry,
-                                        afk::ecs::Entity entity) -> void;
+        auto on_collider_destroy(afk::ecs::Registry &registry, afk::ecs::Entity entity)
+            -> void;
 
         /**
          * Update collisions for firing events and generating physics debug mesh, and sync ReactPhysics3D world with the TransformComponent
+         * The collision event holds the contacts found by update_contact_cache() when the native narrow phase is enabled
+         * Trigger events are found by update_trigger_overlaps() when the native narrow phase is enabled
+         * The ReactPhysics3D world is only updated when it generates the contacts and trigger events, or the debug mesh is enabled
+         *
+         * @param dt the time to advance the ReactPhysics3D world by, in seconds
+         */
+        auto update(f32 dt) -> void;
+
+        /**
+         * Update which entity the camera is looking at
+         *
+         * @param camera the camera to cast a ray from
+         */
+        auto update_camera_raycast(afk::render::Camera &camera) -> void;
+
+        /** How a query picks which hits to report */
+        enum class QueryMode {
+          /** Report the closest hit */
+          Closest,
+          /** Report the first hit found, stopping as soon as there is one */
+          Any,
+          /** Report every hit, closest first */
+          All
+        };
+
+        /** Represents a hit found by a query, one per collider hit */
+        struct QueryHit {
+          /** Entity that was hit */
+          afk::ecs::Entity entity = {};
+          /** Point the ray hit, or the centre of the swept sphere when it hit, in world space, zero for overlaps */
+          glm::vec3 point = {};
+          /** Surface normal at the hit, facing against the query, zero for overlaps */
+          glm::vec3 normal = {};
+          /** Fraction of the distance from the start of the query to its end that the hit is at, zero for overlaps */
+          f32 fraction = {};
+        };
+
+        /** Every hit found by a single query */
+        using QueryResult = std::vector<QueryHit>;
+
+        /** A ray from one point to another */
+        struct RaycastQuery {
+          /** Start of the ray, in world space */
+          glm::vec3 from = {};
+          /** End of the ray, in world space */
+          glm::vec3 to = {};
+          /** Which hits to report */
+          QueryMode mode = QueryMode::Closest;
+          /** Collision layers to test against */
+          afk::ecs::component::ColliderComponent::Layers mask =
+              afk::ecs::component::ColliderComponent::ALL_LAYERS;
+          /** If trigger colliders can be hit */
+          bool is_hitting_triggers = false;
+          /** Entity whose colliders are passed through, such as the entity making the query */
+          std::optional<afk::ecs::Entity> ignored = std::nullopt;
+        };
+
+        /** A sphere swept from one point to another */
+        struct SweepQuery {
+          /** Start of the sphere's centre, in world space */
+          glm::vec3 from = {};
+          /** End of the sphere's centre, in world space */
+          glm::vec3 to = {};
+          /** Radius of the sphere */
+          f32 radius = {};
+          /** Which hits to report */
+          QueryMode mode = QueryMode::Closest;
+          /** Collision layers to test against */
+          afk::ecs::component::ColliderComponent::Layers mask =
+              afk::ecs::component::ColliderComponent::ALL_LAYERS;
+          /** If trigger colliders can be hit */
+          bool is_hitting_triggers = false;
+          /** Entity whose colliders are passed through, such as the entity making the query */
+          std::optional<afk::ecs::Entity> ignored = std::nullopt;
+          /** If colliders the sphere starts inside are hit at the start, rather than passed through */
+          bool is_hitting_initial_overlaps = true;
+        };
+
+        /** A volume to find overlapping colliders of */
+        struct OverlapQuery {
+          /** The volume, in world space */
+          afk::physics::WorldShape volume = {};
+          /** Which hits to report, overlaps have no distance so closest reports any of them */
+          QueryMode mode = QueryMode::All;
+          /** Collision layers to test against */
+          afk::ecs::component::ColliderComponent::Layers mask =
+              afk::ecs::component::ColliderComponent::ALL_LAYERS;
+          /** If trigger colliders can be hit */
+          bool is_hitting_triggers = false;
+          /** Entity whose colliders are ignored, such as the entity making the query */
+          std::optional<afk::ecs::Entity> ignored = std::nullopt;
+        };
+
+        /**
+         * Cast a batch of rays against every collider, running the queries in parallel
+         * A ray that starts inside a collider hits it at the start
+         * Only colliders whose broad phase box the ray crosses before its closest hit so far are tested
+         *
+         * @param queries the rays to cast
+         * @param results the hits of each ray, resized to match the queries
+         */
+        auto raycast(std::span<const RaycastQuery> queries, std::vector<QueryResult> &results)
+            -> void;
+
+        /**
+         * Sweep a batch of spheres against every collider, running the queries in parallel
+         * A sphere that starts inside a collider hits it at the start, unless the query passes through initial overlaps
+         * Sweeps against boxes are tested against the box grown by the sphere's radius, so may report hits slightly early near its edges
+         *
+         * @param queries the spheres to sweep
+         * @param results the hits of each sweep, resized to match the queries
+         */
+        auto sweep(std::span<const SweepQuery> queries, std::vector<QueryResult> &results)
+            -> void;
+
+        /**
+         * Find the colliders overlapping a batch of volumes, running the queries in parallel
+         * Only colliders whose broad phase box overlaps the volume's bounding box are tested
+         *
+         * @param queries the volumes to test
+         * @param results the hits of each volume, resized to match the queries
+         */
+        auto overlap(std::span<const OverlapQuery> queries, std::vector<QueryResult> &results)
+            -> void;
+
+        /**
+         * Get the bounding box of an entity's colliders as of their last synchronisation
+         *
+         * @param entity entity with a collider component
+         *
+         * @return the minimum and maximum corners of the bounding box, in world space
          */
-        auto update() -> void;
+        auto get_bounds(afk::ecs::Entity entity) -> std::pair<glm::vec3, glm::vec3>;
 
         /**
-         * Synchronises colliders with their transform components
+         * Get statistics on the broad phase tree, such as its height and how often colliders are refit and reinserted
          *
+         * @return the broad phase statistics
+         */
+        auto get_broad_phase_stats() const -> afk::physics::AabbTree::Stats;
+
+        /**
+         * Synchronises colliders with their transform components, in both ReactPhysics3D and the broad phase
+         *
+         * Only entities marked with set_transform_dirty() are synchronised, and the marks are removed afterwards
          * This will NOT trigger collision events
          */
         auto syncronize_colliders() -> void;
 
+        /**
+         * Mark an entity's transform as changed since its colliders were last synchronised
+         *
+         * Anything that moves an entity with a collider after it's been instantiated must call this, otherwise its colliders stay where they were
+         * Not thread safe, only call it from whatever is currently allowed to write to the collision system
+         *
+         * @param entity the entity that moved
+         */
+        auto set_transform_dirty(afk::ecs::Entity entity) -> void;
+
+        /**
+         * Set if an entity is resting, such as static and sleeping rigid bodies
+         *
+         * Resting colliders are only tested against colliders that aren't resting, as two resting bodies can't start touching
+         * Colliders still have to be in layers each other can touch, see get_collision_filter()
+         * Trigger colliders are never resting, see get_collision_filter()
+         *
+         * @param entity entity to set the collision filter of
+         * @param is_resting if the entity is resting
+         */
+        auto set_is_resting(afk::ecs::Entity entity, bool is_resting) -> void;
+
         /**
          * Load a collision component associated to an entity
          * 
          * @param entity entity the component is getting instantiated with
-         * @param collider_component component to instantiate
+         * @param collider_component component to instantiate, which the created body is stored in
          * @param transform_component transform component of the entity
          *
-         * @todo instead of creating new shapes for each entity, check if the prefab has already been instantiated and use shapes from the previous instantiation
+         * Shapes are shared with every other collider of the same type and scaled dimensions
          */
         auto instantiate_collider_component(const afk::ecs::Entity &entity,
                                             afk::ecs::component::ColliderComponent &collider_component,
@@ -97,11 +275,23 @@ namespace afk {
         auto get_debug_mesh() -> afk::render::WireframeMesh;
 
         /**
-         * Test and return current collisions, this will not trigger collision events in the event system
-         * 
-         * @return collision data
+         * Test current collisions and store them in the contact cache, this will not trigger collision events in the event system
+         *
+         * Should be called once per step, bodies moved afterwards should be moved in the contact cache too
+         */
+        auto update_contact_cache() -> void;
+
+        /** Contact manifolds found by the last call to update_contact_cache() */
+        afk::physics::ContactCache contact_cache = {};
+
+        /**
+         * If contacts for the contact cache are generated by the engine's own sphere and box narrow phase
+         * Otherwise they're generated by ReactPhysics3D, which is slower but kept as a fallback
          */
-        [[nodiscard]] std::vector<afk::event::Event::Collision> get_current_collisions();
+        bool is_native_narrow_phase_enabled = true;
+
+        /** If ReactPhysics3D generates the data for get_debug_mesh() and get_regular_debug_mesh() on each update */
+        bool is_debug_mesh_enabled = false;
 
       private:
         /** Is the CollisionSystem initialized? */
@@ -112,29 +302,62 @@ namespace afk {
          * 
          * @return pointer to the physics world
          *
-         * @todo turn off debug ReactPhysics3D data to be generated in ReactPhysics3D when debug rendering is not being used
          * @todo set which debug items to generate display data for in GUI
          */
         rp3d::PhysicsWorld *create_rp3d_physics_world();
 
         /**
-         * Update camera raycast
+         * Get the user data to store in the ReactPhysics3D body of an entity
+         *
+         * @param entity the entity the body belongs to
+         *
+         * @return the entity packed into user data
          */
-        auto update_camera_raycast() -> void;
+        static auto get_user_data(afk::ecs::Entity entity) -> void *;
 
-        /** alias to ReactPhysics3D ids for their internal rp3d ECS */
-        using rp3d_id = rp3d::uint;
+        /**
+         * Get the entity a ReactPhysics3D body belongs to
+         *
+         * @param body the body, which must have been made by instantiate_collider_component()
+         *
+         * @return the entity stored in the body's user data
+         */
+        static auto get_entity(const rp3d::CollisionBody &body) -> afk::ecs::Entity;
 
-        /** Represents raycast hit collision data*/
-        struct RaycastHitInfo {
-          /** Body that was hit */
-          rp3d::CollisionBody *collision_body = nullptr;
-          /**
-           * Fraction distance of the hit point between point1 and point2 of the ray
-           * The hit point "p" is such that p = point1 + hitFraction * (point2 - point1)
-           */
-          f32 hit_fraction = {};
-        };
+        /**
+         * Add a ReactPhysics3D contact pair and its contacts to a contact buffer, with the contact points in world space
+         * Pairs between colliders of the same entity and pairs that have stopped touching are skipped
+         *
+         * @param contact_pair the contact pair
+         * @param buffer the buffer to add to
+         */
+        static auto add_contact_pair(const rp3d::CollisionCallback::ContactPair &contact_pair,
+                                     afk::physics::ContactBuffer &buffer) -> void;
+
+        /** How far the layers of resting colliders are shifted within a ReactPhysics3D collision category */
+        static constexpr u16 RESTING_LAYER_SHIFT = 8;
+
+        /**
+         * How far each collider's bounding box is grown in the broad phase, in world units
+         * Slow bodies stay inside their leaf for several ticks, so they're only reinserted every so often rather than on every tick
+         */
+        static constexpr f32 BROAD_PHASE_FAT_MARGIN = 0.1f;
+
+        /**
+         * Get the ReactPhysics3D collision category and mask of a collider
+         *
+         * ReactPhysics3D tests a pair if each one's category shares a bit with the other's mask, which can't check both layers and resting at once
+         * Instead the low byte of a category holds the layers of colliders that aren't resting, and the high byte holds the layers of resting colliders
+         * Colliders that aren't resting touch layers in either byte, resting colliders only touch layers in the low byte, so resting pairs are never tested
+         * Triggers are never treated as resting, so a trigger's overlaps don't end when its body falls asleep
+         *
+         * @param collider the collider
+         * @param is_resting if the collider is resting
+         *
+         * @return the collision category and mask
+         */
+        static auto get_collision_filter(const afk::ecs::component::ColliderComponent::Collider &collider,
+                                         bool is_resting) -> std::pair<u16, u16>;
 
         /** Logger class for logging ReactPhysics3D events
         * 
@@ -155,7 +378,18 @@ namespace afk {
          * @todo process collision information and send the processed data rather than the more raw data
          */
         class CollisionEventListener : public rp3d::EventListener {
+        public:
+          /** The collision system the listener belongs to */
+          CollisionSystem *collision_system = nullptr;
+
+        private:
           virtual void onContact(const rp3d::CollisionCallback::CallbackData &callback_data) override;
+
+          /**
+           * Fires an event when a collider starts or stops overlapping a trigger collider
+           * Triggers have no contact points, so only the entities and whether they started or stopped overlapping are sent
+           */
+          virtual void onTrigger(const rp3d::OverlapCallback::CallbackData &callback_data) override;
         };
 
         /**
@@ -163,17 +397,168 @@ namespace afk {
          * The intent for this class is to store the current collisions without routing it through the event system
          */
         class CollisionCallback : public rp3d::CollisionCallback {
+        public:
+          /** The collision system the callback belongs to */
+          CollisionSystem *collision_system = nullptr;
+
+        private:
           virtual void onContact(const rp3d::CollisionCallback::CallbackData &callback_data) override;
         };
 
+        /** An entity overlapping a trigger, with the trigger's entity first unless both are triggers */
+        using TriggerOverlap = std::pair<afk::ecs::Entity, afk::ecs::Entity>;
+
+        /** A collider in world space, as seen by queries and the native narrow phase */
+        struct WorldCollider {
+          /** Entity the collider belongs to */
+          afk::ecs::Entity entity = {};
+          /** Layers the collider is in */
+          afk::ecs::component::ColliderComponent::Layers category = {};
+          /** If the collider is a trigger */
+          bool is_trigger = false;
+          /** If the collider is resting, see set_is_resting() */
+          bool is_resting = false;
+          /** ReactPhysics3D collision category of the collider, see get_collision_filter() */
+          u16 filter_category = {};
+          /** ReactPhysics3D collision mask of the collider, see get_collision_filter() */
+          u16 filter_mask = {};
+          /** Shape of the collider */
+          afk::physics::WorldShape volume = {};
+          /** Bounding box of the collider */
+          afk::physics::Aabb bounds = {};
+          /** Proxy of the collider in the broad phase, NULL_NODE if the world collider isn't in use */
+          i32 proxy = afk::physics::AabbTree::NULL_NODE;
+        };
+
+        /** Collects the hits of a single query as the broad phase finds colliders for it */
+        struct HitCollector {
+          /** Which hits to report */
+          QueryMode mode = QueryMode::Closest;
+          /** Collision layers to test against */
+          afk::ecs::component::ColliderComponent::Layers mask =
+              afk::ecs::component::ColliderComponent::ALL_LAYERS;
+          /** If trigger colliders can be hit */
+          bool is_hitting_triggers = false;
+          /** Entity whose colliders are skipped */
+          std::optional<afk::ecs::Entity> ignored = std::nullopt;
+          /** Result to add hits to */
+          QueryResult *result = nullptr;
+          /** Fraction of the closest hit so far, one when every hit is reported */
+          f32 closest = 1.0f;
+          /** If no more hits are needed */
+          bool is_done = false;
+
+          /**
+           * Check if a collider should be tested at all, by its layers, if it's a trigger and its entity
+           *
+           * @param collider the collider
+           *
+           * @return if the collider should be tested
+           */
+          auto is_testing(const WorldCollider &collider) const -> bool;
+
+          /**
+           * Add a hit, keeping only the closest unless every hit is reported
+           *
+           * @param hit the hit
+           */
+          auto add(const QueryHit &hit) -> void;
+        };
+
         /**
-         * Callback class for each raycast hit
-         * Will store raycast information in this->camera_raycast_info
+         * Move the world colliders and broad phase proxies of every entity marked with set_transform_dirty()
+         * The marks are left for syncronize_colliders() to remove
          */
-        class RaycastCallback : public rp3d::RaycastCallback {
-          virtual rp3d::decimal notifyRaycastHit(const rp3d::RaycastInfo &info) override;
+        auto refit_world_colliders() -> void;
+
+        /**
+         * Sort the dirty entities and remove any duplicates, so each entity is only refit once
+         */
+        auto remove_duplicate_dirty_entities() -> void;
+
+        /**
+         * Find the contacts between every pair of colliders that can touch with the native narrow phase, adding them to cache_contacts
+         *
+         * Candidate pairs are found by querying the broad phase with the bounding box of each collider that isn't resting
+         */
+        auto find_contacts() -> void;
+
+        /**
+         * Find every entity overlapping a trigger collider, and fire a trigger event for each overlap that started or stopped since the last call
+         *
+         * Candidates are found by querying the broad phase with the bounding box of each trigger, then tested against its shape
+         * Replaces ReactPhysics3D's trigger events when the native narrow phase is enabled, so its world doesn't need updating
+         */
+        auto update_trigger_overlaps() -> void;
+
+        /**
+         * Run a batch of queries in parallel against the broad phase
+         *
+         * @param queries the queries
+         * @param results the hits of each query, resized to match the queries
+         * @param run_query function taking the index of a query and the hit collector for it, which adds every hit it finds to the collector
+         */
+        template<typename Query, typename Fn>
+        auto run_queries(std::span<const Query> queries, std::vector<QueryResult> &results,
+                         Fn &&run_query) -> void;
+
+        /** Identifies a shape by its type and dimensions with scale applied, so identical shapes can be shared */
+        struct ShapeKey {
+          /** Index of the shape's type in ColliderComponent::ColliderShape */
+          usize type = {};
+          /** Dimensions of the shape with scale applied, unused dimensions are zero */
+          glm::vec3 dimensions = {};
+
+          auto operator==(const ShapeKey &) const -> bool = default;
         };
 
+        /**
+         * Struct responsible for hashing shape keys.
+         */
+        struct ShapeKeyHash {
+          /**
+           * Hashes a shape key.
+           * @param key The key to hash.
+           * @return The resulting hash.
+           */
+          auto operator()(const ShapeKey &key) const -> usize {
+            auto hash = std::hash<usize>{}(key.type);
+
+            for (auto i = glm::vec3::length_type{0}; i < 3; ++i) {
+              hash = hash * 31 + std::hash<f32>{}(key.dimensions[i]);
+            }
+
+            return hash;
+          }
+        };
+
+        /** A shape shared between colliders */
+        struct SharedShape {
+          /** The ReactPhysics3D shape */
+          rp3d::CollisionShape *shape = nullptr;
+          /** The number of colliders using the shape */
+          u32 reference_count = {};
+        };
+
+        /**
+         * Get a shape shared with every other collider of the same type and scaled dimensions, creating it if there are none
+         * Every shape acquired must be released with release_shape() once its collider is destroyed
+         *
+         * @param shape the shape
+         * @param scale scale of the shape
+         *
+         * @return shape pointer
+         */
+        rp3d::CollisionShape *acquire_shape(const afk::ecs::component::ColliderComponent::ColliderShape &shape,
+                                            const glm::vec3 &scale);
+
+        /**
+         * Release a shape acquired with acquire_shape(), destroying it once no colliders use it
+         *
+         * @param shape shape pointer
+         */
+        auto release_shape(rp3d::CollisionShape *shape) -> void;
+
         /**
          * Create a ReactPhysics3D box shape
          *
@@ -205,11 +590,14 @@ namespace afk {
         /** Callback for testing collisions when called */
         CollisionCallback collision_callback = {};
 
-        /** Raycast callback used for determining raycast hits from the camera that occur in teh react physics 3d world */
-        RaycastCallback raycast_callback = {};
+        /**
+         * Logger used for displaying ReactPhysics3D events
+         * Shared between every world, as ReactPhysics3D only has a single logger
+         */
+        inline static Logger logger = {};
 
-        /** Logger used for displaying ReactPhysics3D events */
-        Logger logger = {};
+        /** The world this system belongs to */
+        afk::World &owner;
 
         /** ReactPhysics3D library resource manager */
         rp3d::PhysicsCommon physics_common = {};
@@ -217,24 +605,41 @@ namespace afk {
         /** ReactPhysics3D representation of the world */
         rp3d::PhysicsWorld *world = nullptr;
 
-        /** Map to point the AFK ECS entity to the ReactPhysics3D collision body index */
-        std::unordered_map<ecs::Entity, u32> ecs_entity_to_rp3d_body_index_map = {};
+        /** Shapes shared between colliders, by type and scaled dimensions */
+        std::unordered_map<ShapeKey, SharedShape, ShapeKeyHash> shapes = {};
 
-        /** Map to point the ReactPhysics3D collision body index to an AFK ECS entity */
-        std::unordered_map<u32, ecs::Entity> rp3d_body_index_to_ecs_entity_map = {};
+        /** Map to point a shared shape to its key */
+        std::unordered_map<rp3d::CollisionShape *, ShapeKey> shape_to_key_map = {};
 
-        /** Map to point the ReactPhysics3D collision body identifier an AFK ECS entity */
-        std::unordered_map<rp3d_id, ecs::Entity> rp3d_body_id_to_ecs_entity_map = {};
+        /** Colliders in world space, indexed by ColliderComponent::world_colliders, refit when their transform changes */
+        std::vector<WorldCollider> world_colliders = {};
 
-        /** Stores raycast collision data for the camera's raycast */
-        std::vector<RaycastHitInfo> camera_raycast_info = {};
+        /** Indices of world colliders that aren't in use, reused before new ones are added */
+        std::vector<u32> free_world_colliders = {};
 
         /**
-         * Temporary store of collision data, might need to move this elsewhere
-         * @todo don't make this static
-         * @todo think of a better way to temporarily store the collision data
+         * Entities whose transform has changed since their colliders were last synchronised, may hold duplicates
+         * Kept here rather than as a tag component, as the systems that move entities can run off the main thread and can't change the registry
          */
-        std::vector<afk::event::Event::Collision> temporary_collisions = {};
+        std::vector<afk::ecs::Entity> dirty_entities = {};
+
+        /** Tree of the world colliders' bounding boxes, which each stores the index of its world collider */
+        afk::physics::AabbTree broad_phase = {};
+
+        /** Entities overlapping each trigger on the last update, sorted, see update_trigger_overlaps() */
+        std::vector<TriggerOverlap> trigger_overlaps = {};
+
+        /** Entities overlapping each trigger on this update, swapped into trigger_overlaps once they've been compared */
+        std::vector<TriggerOverlap> new_trigger_overlaps = {};
+
+        /** Contacts found while updating the ReactPhysics3D world, sent in the collision event of the step when the native narrow phase is disabled */
+        afk::physics::ContactBuffer collision_contacts = {};
+
+        /** Contacts found while testing collisions, before they're moved to the contact cache */
+        afk::physics::ContactBuffer cache_contacts = {};
+
+        /** Generates contacts between candidate pairs of colliders */
+        afk::physics::NarrowPhase narrow_phase = {};
       };
     }
   }
@@ -1,44 +1,78 @@
 #include "afk/ecs/system/PhysicsSystem.hpp"
 
+#include <algorithm>
 #include <limits>
 
 #include "afk/Engine.hpp"
+#include "afk/World.hpp"
 #include "afk/debug/Assert.hpp"
+#include "afk/debug/Profiler.hpp"
+#include "afk/ecs/Entity.hpp"
 #include "afk/ecs/component/ColliderComponent.hpp"
 #include "afk/ecs/component/PhysicsComponent.hpp"
+#include "afk/ecs/component/PreviousTransformComponent.hpp"
 #include "afk/ecs/component/TransformComponent.hpp"
 #include "afk/io/Log.hpp"
 #include "afk/io/Time.hpp"
+#include "afk/physics/ContinuousCollision.hpp"
 #include "afk/utility/Visitor.hpp"
 
 using afk::ecs::component::ColliderComponent;
 using afk::ecs::component::PhysicsComponent;
+using afk::ecs::component::PreviousTransformComponent;
 using afk::ecs::component::TransformComponent;
 using afk::ecs::system::PhysicsSystem;
-using afk::event::Event;
 using afk::physics::Transform;
 using afk::physics::shape::Box;
 using afk::physics::shape::Sphere;
 using afk::utility::Visitor;
 
+PhysicsSystem::PhysicsSystem(afk::World &owner)
+  : owner(owner), body_batch(owner.job_manager), contact_solver(owner.job_manager) {}
+
 auto PhysicsSystem::initialize() -> void {
   afk_assert(!this->is_initialized, "Physics system already initialized");
-  auto &engine = afk::Engine::get();
-
-  engine.event_manager.register_event(
-      Event::Type::Collision,
-      event::EventManager::Callback{ecs::system::PhysicsSystem::collision_resolution_callback});
 
   this->is_initialized = true;
   afk::io::log << afk::io::get_date_time() << "Physics subsystem initialized\n";
 }
 
-auto PhysicsSystem::update() -> void {
-  auto &afk              = afk::Engine::get();
-  auto &collision_system = afk.collision_system;
-  auto dt                = afk.get_delta_time();
+auto PhysicsSystem::update(f32 dt) -> void {
+  afk_profile_scope("PhysicsSystem::update");
+
+  auto &collision_system = this->owner.collision_system;
+  auto &registry         = this->owner.ecs.registry;
+
+  this->save_previous_transforms();
+
+  // sleeping islands touched by awake bodies on the last update are woken before the contacts are
+  // tested, as resting colliders aren't tested against each other and the woken bodies need theirs
+  this->islands.build(registry, collision_system.contact_cache);
+  this->wake_islands();
+
+  // collisions are only tested once, everything after works from the cached contacts
+  collision_system.update_contact_cache();
+  this->islands.build(registry, collision_system.contact_cache);
 
-  this->apply_rigid_body_changes(dt);
+  this->integrate_velocities(dt);
+
+  // resolve every contact together before anything moves
+  this->contact_solver.solve(registry, collision_system.contact_cache, this->islands);
+
+  this->integrate_positions(dt);
+
+  // stop fast bodies at the first thing in their path, before the contacts are moved with them
+  this->sweep_continuous_bodies();
+
+  // move the cached contacts along with the bodies that just moved, so depenetration sees where they are now
+  for (const auto entity : collision_system.contact_cache.get_entities()) {
+    if (registry.has<PhysicsComponent, PreviousTransformComponent>(entity) &&
+        !registry.get<PhysicsComponent>(entity).is_static) {
+      const auto &transform = registry.get<TransformComponent>(entity);
+      const auto &previous  = registry.get<PreviousTransformComponent>(entity).transform;
+      collision_system.contact_cache.translate(entity, transform.translation - previous.translation);
+    }
+  }
 
   // run depenetration AFTER applying queued rigid body changes
   auto i                       = size_t{0};
@@ -51,7 +85,9 @@ auto PhysicsSystem::update() -> void {
   } while (i < PhysicsSystem::DEPENETRATION_MAXIMUM_ITERATIONS &&
            depenetrations_resolved > 0);
 
-  // ensure the colliders are always syncronised
+  this->sleep_islands(dt);
+
+  // ensure the colliders of every body moved this update are syncronised
   collision_system.syncronize_colliders();
 }
 
@@ -94,249 +130,216 @@ auto PhysicsSystem::initialize_physics_component(PhysicsComponent &physics_compo
       physics_component.local_inverse_inertial_tensor, transform_component.rotation);
 }
 
-auto PhysicsSystem::collision_resolution_callback(Event event) -> void {
-  // this method should only be processing Collision events and will assume the event is a collision event
-  afk_assert(event.type == Event::Type::Collision,
-             "event type was not 'Collision'");
+auto PhysicsSystem::save_previous_transforms() -> void {
+  auto &registry = this->owner.ecs.registry;
+  // only assign here, the component is added when the entity is instantiated
+  // as this may run off the main thread where the registry can't be modified
+  const auto view =
+      registry.view<PhysicsComponent, TransformComponent, PreviousTransformComponent>();
 
-  auto &afk      = afk::Engine::get();
-  auto &registry = afk.ecs.registry;
+  for (const auto entity : view) {
+    view.get<PreviousTransformComponent>(entity).transform =
+        view.get<TransformComponent>(entity);
+  }
+}
 
-  auto visitor = Visitor{
-      [&registry](Event::Collision &c) {
-        // only do physics resolution on entities that are not static
-        if (registry.has<PhysicsComponent>(c.entity1) &&
-            registry.has<PhysicsComponent>(c.entity2)) {
+auto PhysicsSystem::integrate_velocities(f32 dt) -> void {
+  afk_profile_scope("PhysicsSystem::integrate_velocities");
 
-          auto &physics1 = registry.get<PhysicsComponent>(c.entity1);
-          auto &physics2 = registry.get<PhysicsComponent>(c.entity2);
+  auto &registry = this->owner.ecs.registry;
+  auto &world    = this->owner;
 
-          const auto &transform1 = registry.get<TransformComponent>(c.entity1);
-          const auto &transform2 = registry.get<TransformComponent>(c.entity2);
+  // static and sleeping bodies are left out of the batch entirely, their
+  // inverse inertia tensor can't change as they don't rotate
+  const auto gravity = world.gravity_enabled ? world.gravity : glm::vec3{0.0f};
 
-          // only do resolution if at least one of the entities has a non-static physics component
-          if (!physics1.is_static || !physics2.is_static) {
+  // the batch keeps each body between updates, only the velocities and forces can change from outside
+  this->body_batch.sync(registry);
+  this->body_batch.load_velocities(registry);
+  this->body_batch.integrate_velocities(dt, gravity);
+  this->body_batch.store_velocities(registry);
+}
 
-            auto avg_normal = glm::vec3{0.0f};
-            for (auto i = size_t{0}; i < c.contacts.size(); ++i) {
-              avg_normal += c.contacts[i].normal;
-            }
+auto PhysicsSystem::integrate_positions(f32 dt) -> void {
+  afk_profile_scope("PhysicsSystem::integrate_positions");
 
-            // normal from item one to item two
-            avg_normal /= c.contacts.size();
+  auto &registry = this->owner.ecs.registry;
 
-            // average points of collision in world space
-            auto avg_collision_point1 = glm::vec3{0.0f};
-            auto avg_collision_point2 = glm::vec3{0.0f};
-            for (auto i = size_t{0}; i < c.contacts.size(); ++i) {
-              avg_collision_point1 += c.contacts[i].collider1_point;
-              avg_collision_point2 += c.contacts[i].collider2_point;
-            }
-            avg_collision_point1 /= c.contacts.size();
-            avg_collision_point2 /= c.contacts.size();
-
-            // vectors from center of mass to collision points
-            const auto r1 = avg_collision_point1 -
-                            (physics1.center_of_mass + transform1.translation);
-            const auto r2 = avg_collision_point2 -
-                            (physics2.center_of_mass + transform2.translation);
-
-            const auto impulse_coefficient =
-                PhysicsSystem::get_impulse_coefficient(c, avg_normal, r1, r2);
-
-            const auto impulse = impulse_coefficient * avg_normal;
-
-            // update forces and torque for collider 1 if it is not static
-            if (!physics1.is_static) {
-              physics1.external_forces +=
-                  impulse; // applying inverse mass is handled in a different function
-              physics1.external_torques +=
-                  physics1.inverse_inertial_tensor * (glm::cross(r1, impulse));
-            }
-            // update forces and torque for collider 2 if it is not static
-            if (!physics2.is_static) {
-              physics2.external_forces -=
-                  impulse; // applying inverse mass is handled in a different function
-              physics2.external_torques -=
-                  physics2.inverse_inertial_tensor * (glm::cross(r2, impulse));
-            }
-          }
-        }
-      },
-      [](auto) { afk_assert(false, "Event data must be of type Collision"); }};
+  // the same bodies as the velocity integration, with the velocities the contacts were solved to
+  this->body_batch.load_velocities(registry);
+  this->body_batch.integrate_positions(dt);
+  this->body_batch.store_transforms(registry);
 
-  std::visit(visitor, event.data);
+  for (const auto entity : this->body_batch.get_entities()) {
+    this->owner.collision_system.set_transform_dirty(entity);
+  }
 }
 
-auto PhysicsSystem::apply_rigid_body_changes(f32 dt) -> void {
-  auto &afk      = afk::Engine::get();
-  auto &registry = afk.ecs.registry;
-  // only bother updating rigid bodies
+auto PhysicsSystem::sweep_continuous_bodies() -> void {
+  afk_profile_scope("PhysicsSystem::sweep_continuous_bodies");
+
+  auto &collision_system = this->owner.collision_system;
+  auto &registry         = this->owner.ecs.registry;
   const auto view =
-      registry.view<ColliderComponent, PhysicsComponent, TransformComponent>();
+      registry.view<ColliderComponent, PhysicsComponent, TransformComponent, PreviousTransformComponent>();
+
+  this->continuous_entities.clear();
+  this->continuous_queries.clear();
 
-  // process updates to each dynamic rigid body using semi-implicit euler integration
   for (const auto entity : view) {
-    auto &physics   = registry.get<PhysicsComponent>(entity);
-    auto &transform = registry.get<TransformComponent>(entity);
+    const auto &physics = view.get<PhysicsComponent>(entity);
 
-    // update interia tensor
-    physics.inverse_inertial_tensor = PhysicsSystem::get_inverse_inertia_tensor(
-        physics.local_inverse_inertial_tensor, transform.rotation);
+    if (!physics.continuous_collision || physics.is_static || physics.is_sleeping) {
+      continue;
+    }
 
-    // skip anything that is static
-    if (!physics.is_static) {
+    const auto &transform               = view.get<TransformComponent>(entity);
+    const auto &previous                = view.get<PreviousTransformComponent>(entity).transform;
+    const auto motion                   = transform.translation - previous.translation;
+    const auto [bounds_min, bounds_max] = collision_system.get_bounds(entity);
 
-      // integrate constant gravity acceleration
-      if (afk.gravity_enabled) {
-        physics.linear_velocity += dt * afk.gravity;
-      }
+    // the colliders haven't been synchronised yet, so the bounds are still where the body started
+    // the smallest half extent is the furthest the body can move without possibly skipping over something
+    const auto half_extents = (bounds_max - bounds_min) * 0.5f;
+    const auto radius       = std::min({half_extents.x, half_extents.y, half_extents.z});
 
-      // add new linear velocity
-      // external forces is just force, so need to divide mass out (a = F/m)
-      // a = F/m
-      physics.linear_velocity += physics.total_inverse_mass * physics.external_forces;
+    if (glm::length(motion) <= radius * PhysicsSystem::CONTINUOUS_COLLISION_THRESHOLD) {
+      continue;
+    }
 
-      // add new angular velocity
-      physics.angular_velocity += physics.external_torques;
+    const auto from = (bounds_min + bounds_max) * 0.5f;
 
-      // integrate velocity to translation AFTER it has been calculated for semi-implicit euler integration
-      transform.translation += physics.linear_velocity * dt;
+    this->continuous_entities.push_back(entity);
+    this->continuous_queries.push_back(afk::ecs::system::CollisionSystem::SweepQuery{
+        from, from + motion, radius, afk::ecs::system::CollisionSystem::QueryMode::Closest,
+        ColliderComponent::ALL_LAYERS, false, entity, false});
+  }
 
-      // integrate rotation AFTER it has been calculated for semi-implicit euler integration
-      transform.rotation +=
-          glm::quat(0.0f, physics.angular_velocity) * transform.rotation * 0.5f * dt;
+  // every body is swept in one batch, so the sweeps are tested in parallel
+  collision_system.sweep(this->continuous_queries, this->continuous_results);
 
-      // get linear dampening
-      const auto linear_dampening =
-          std::clamp(std::pow(1.0f - physics.linear_dampening, dt), 0.0f, 1.0f);
+  for (auto i = usize{0}; i < this->continuous_entities.size(); ++i) {
+    const auto &result = this->continuous_results[i];
 
-      // apply linear dampening
-      physics.linear_velocity *= linear_dampening;
+    if (result.empty()) {
+      continue;
+    }
 
-      // get angular dampening
-      const auto angular_dampening =
-          std::clamp(std::pow(1.0f - physics.angular_dampening, dt), 0.0f, 1.0f);
+    const auto entity    = this->continuous_entities[i];
+    const auto &hit      = result.front();
+    auto &physics        = view.get<PhysicsComponent>(entity);
+    auto &transform      = view.get<TransformComponent>(entity);
+    const auto &previous = view.get<PreviousTransformComponent>(entity).transform;
 
-      physics.angular_dampening *= angular_dampening;
+    // stop where the sphere touched what it hit, sliding along it rather than stopping dead
+    const auto stop = afk::physics::stop_at_hit(
+        previous.translation, transform.translation - previous.translation,
+        physics.linear_velocity, afk::physics::SegmentHit{hit.fraction, hit.normal});
 
-      // reset external forces and torque for the next update cycle
-      // these only represent "moments" in acceleration
-      physics.external_forces  = glm::vec3{0.0f};
-      physics.external_torques = glm::vec3{0.0f};
-    }
+    transform.translation   = stop.translation;
+    physics.linear_velocity = stop.linear_velocity;
+    this->body_batch.set_transform_dirty(entity);
   }
 }
 
-auto PhysicsSystem::get_impulse_coefficient(const Event::Collision &data,
-                                            const glm::vec3 &contact_normal,
-                                            const glm::vec3 &r1,
-                                            const glm::vec3 &r2) -> f32 {
+auto PhysicsSystem::wake_islands() -> void {
+  auto &registry = this->owner.ecs.registry;
+  auto &world    = this->owner;
 
-  auto &registry = afk::Engine::get().ecs.registry;
-  auto collider1 = registry.get<ColliderComponent>(data.entity1);
-  auto collider2 = registry.get<ColliderComponent>(data.entity2);
+  // gravity is changed from outside the simulation, and changes how every body should be moving
+  const auto is_gravity_changed =
+      world.gravity_enabled != this->was_gravity_enabled || world.gravity != this->last_gravity;
+  this->was_gravity_enabled = world.gravity_enabled;
+  this->last_gravity        = world.gravity;
 
-  const auto collider_1_physics = registry.get<PhysicsComponent>(data.entity1);
-  const auto collider_2_physics = registry.get<PhysicsComponent>(data.entity2);
+  auto &collision_system = world.collision_system;
 
-  // velocity before collision
-  const auto v1 = collider_1_physics.linear_velocity;
-  const auto v2 = collider_2_physics.linear_velocity;
-
-  // rotational speed before collision
-  const auto omega1 = collider_1_physics.angular_velocity;
-  const auto omega2 = collider_2_physics.angular_velocity;
-
-  // 1/(inertia tensor)
-  const auto j1 = collider_1_physics.inverse_inertial_tensor;
-  const auto j2 = collider_2_physics.inverse_inertial_tensor;
-
-  // inverse mass
-  // make the number as low as possible for static entities to make it appear like they're very heavy
-  const auto &inverse_mass1 = collider_1_physics.total_inverse_mass;
-  const auto &inverse_mass2 = collider_2_physics.total_inverse_mass;
-
-  // -(1+e)(n + (v1 - v2) + w1.(r1 * n1) - w2.(r2 * n2))
-  f32 numerator = glm::dot(contact_normal, v1 - v2);
-  numerator += glm::dot(omega1, glm::cross(r1, contact_normal));
-  numerator -= glm::dot(omega2, glm::cross(r2, contact_normal));
-  numerator *= -(1 + PhysicsSystem::COEFFICENT_OF_RESTITUTION);
+  // sleeping colliders are resting, so they're no longer tested against each other
+  this->sleeping_islands.wake(registry, this->islands, is_gravity_changed,
+                              [&collision_system](afk::ecs::Entity entity, bool is_sleeping) {
+                                collision_system.set_is_resting(entity, is_sleeping);
+                              });
+}
 
-  f32 denominator =
-      glm::dot(glm::cross(r1, contact_normal), j1 * glm::cross(r1, contact_normal));
-  denominator +=
-      glm::dot(glm::cross(r2, contact_normal), j2 * glm::cross(r2, contact_normal));
-  denominator += inverse_mass1 + inverse_mass2;
+auto PhysicsSystem::sleep_islands(f32 dt) -> void {
+  auto &collision_system = this->owner.collision_system;
 
-  return numerator / denominator;
+  this->sleeping_islands.sleep(this->owner.ecs.registry, this->islands,
+                               collision_system.contact_cache, dt,
+                               [&collision_system](afk::ecs::Entity entity, bool is_sleeping) {
+                                 collision_system.set_is_resting(entity, is_sleeping);
+                               });
 }
 
 auto PhysicsSystem::depenetrate_dynamic_rigid_bodies() -> u32 {
-  auto &afk              = afk::Engine::get();
-  auto &collision_system = afk.collision_system;
-  auto &registry         = afk.ecs.registry;
+  afk_profile_scope("PhysicsSystem::depenetrate_dynamic_rigid_bodies");
 
-  auto penetrations_resolved = u32{0};
-
-  auto collisions = collision_system.get_current_collisions();
+  auto &collision_system = this->owner.collision_system;
+  auto &contact_cache    = collision_system.contact_cache;
+  auto &registry         = this->owner.ecs.registry;
 
-  for (const auto &collision : collisions) {
-    // check that the collision isn't occuring between the same entity
-    if (collision.entity1 != collision.entity2) {
+  auto penetrations_resolved = u32{0};
 
-      // only bother processing the event if both items are rigid bodies
-      if (registry.has<PhysicsComponent>(collision.entity1) &&
-          registry.has<PhysicsComponent>(collision.entity2)) {
+  // the cache never holds collisions between the same entity
+  for (const auto &collision : contact_cache.get_collisions()) {
+    // only bother processing the event if both items are rigid bodies
+    if (registry.has<PhysicsComponent>(collision.entity1) &&
+        registry.has<PhysicsComponent>(collision.entity2)) {
 
-        const auto &entity1_physics = registry.get<PhysicsComponent>(collision.entity1);
-        const auto &entity2_physics = registry.get<PhysicsComponent>(collision.entity2);
+      const auto &entity1_physics = registry.get<PhysicsComponent>(collision.entity1);
+      const auto &entity2_physics = registry.get<PhysicsComponent>(collision.entity2);
 
-        // only bother processing if at least one of the items is not static
-        if (!entity1_physics.is_static || !entity2_physics.is_static) {
+      // only bother processing if at least one of the items is not static
+      if (!entity1_physics.is_static || !entity2_physics.is_static) {
 
-          const auto &contacts = collision.contacts;
-          if (contacts.size() > 0) {
+        const auto &contacts = collision.contacts;
+        if (contacts.size() > 0) {
 
-            // get deepest penetration
-            auto deepest_penetration_index = size_t{0};
-            for (auto i = size_t{1}; i < contacts.size(); ++i) {
-              if (contacts[i].penetration_depth >
-                  contacts[deepest_penetration_index].penetration_depth) {
-                deepest_penetration_index = i;
-              }
+          // get deepest penetration
+          auto deepest_penetration_index = size_t{0};
+          for (auto i = size_t{1}; i < contacts.size(); ++i) {
+            if (contacts[i].penetration_depth >
+                contacts[deepest_penetration_index].penetration_depth) {
+              deepest_penetration_index = i;
             }
+          }
 
-            // contact normal is from the first object to the second, so needs to be inversed when applying to the second object
-            const auto &contact_normal = contacts[deepest_penetration_index].normal;
-            auto penetration = contacts[deepest_penetration_index].penetration_depth;
-
-            // move the object backwards from the max penetration value
-            if (penetration > PhysicsSystem::MAXIMUM_PENETRATION) {
-              penetration -= PhysicsSystem::MAXIMUM_PENETRATION;
-
-              const auto offset = contact_normal * penetration;
-
-              // determine which transform to edit
-              // prefer the non static object
-              // if both are non static, prefer the first object
-              if (!entity1_physics.is_static) {
-                auto &transform = registry.get<TransformComponent>(collision.entity1);
-                // move the transform in the opposite direction of the contact with the magnitude of the penetration
-                transform.translation -= offset;
-              } else {
-                auto &transform = registry.get<TransformComponent>(collision.entity2);
-                // move the transform in the opposite direction of the contact with the magnitude of the penetration
-                transform.translation += offset;
-              }
-
-              ++penetrations_resolved;
+          // contact normal is from the first object to the second, so needs to be inversed when applying to the second object
+          // copied as moving an entity updates the cached contacts
+          const auto contact_normal = contacts[deepest_penetration_index].normal;
+          auto penetration = contacts[deepest_penetration_index].penetration_depth;
+
+          // move the object backwards from the max penetration value
+          if (penetration > PhysicsSystem::MAXIMUM_PENETRATION) {
+            penetration -= PhysicsSystem::MAXIMUM_PENETRATION;
+
+            const auto offset = contact_normal * penetration;
+
+            // determine which transform to edit
+            // prefer the non static object
+            // if both are non static, prefer the first object
+            if (!entity1_physics.is_static) {
+              auto &transform = registry.get<TransformComponent>(collision.entity1);
+              // move the transform in the opposite direction of the contact with the magnitude of the penetration
+              transform.translation -= offset;
+              contact_cache.translate(collision.entity1, -offset);
+              collision_system.set_transform_dirty(collision.entity1);
+              this->body_batch.set_transform_dirty(collision.entity1);
+            } else {
+              auto &transform = registry.get<TransformComponent>(collision.entity2);
+              // move the transform in the opposite direction of the contact with the magnitude of the penetration
+              transform.translation += offset;
+              contact_cache.translate(collision.entity2, offset);
+              collision_system.set_transform_dirty(collision.entity2);
+              this->body_batch.set_transform_dirty(collision.entity2);
             }
 
-          } else {
-            // shouldn't be able to reach a collisioni that has no points
-            afk_unreachable_debug();
+            ++penetrations_resolved;
           }
+
+        } else {
+          // shouldn't be able to reach a collisioni that has no points
+          afk_unreachable_debug();
         }
       }
     }
@@ -1,16 +1,25 @@
 #pragma once
 
+#include <vector>
+
 #include <glm/glm.hpp>
 
+#include "afk/ecs/Entity.hpp"
 #include "afk/ecs/component/ColliderComponent.hpp"
 #include "afk/ecs/component/PhysicsComponent.hpp"
 #include "afk/ecs/component/TransformComponent.hpp"
-#include "afk/event/Event.hpp"
+#include "afk/ecs/system/CollisionSystem.hpp"
+#include "afk/physics/BodyBatch.hpp"
+#include "afk/physics/ContactSolver.hpp"
+#include "afk/physics/Islands.hpp"
+#include "afk/physics/SleepingIslands.hpp"
 #include "afk/physics/Transform.hpp"
 #include "afk/physics/shape/Box.hpp"
 #include "afk/physics/shape/Sphere.hpp"
 
 namespace afk {
+  class World;
+
   namespace ecs {
     namespace system {
       /**
@@ -18,13 +27,22 @@ namespace afk {
        */
       class PhysicsSystem {
       public:
+        /**
+         * Constructor
+         *
+         * @param owner the world this system belongs to
+         */
+        explicit PhysicsSystem(afk::World &owner);
+
         /** Initialise the physics system */
         auto initialize() -> void;
 
         /**
          * Update physics resolution
+         *
+         * @param dt the time to advance the simulation by, in seconds
          */
-        auto update() -> void;
+        auto update(f32 dt) -> void;
 
         /**
          * Initialize values for physics component
@@ -33,51 +51,66 @@ namespace afk {
          * @param collider_component collider component used to generate the physics component's data
          * @param transform_component transform component used to generate the phhysics component's data
          */
-        auto initialize_physics_component(
+        static auto initialize_physics_component(
             afk::ecs::component::PhysicsComponent &physics_component,
             const afk::ecs::component::ColliderComponent &collider_component,
             const afk::ecs::component::TransformComponent &transform_component) -> void;
 
+      private:
         /**
-         * Callback to call when a collision occurs
-         *
-         * Should only pass in event of type Collision
+         * Store the current transform of every dynamic rigid body so rendering can interpolate from it
+         */
+        auto save_previous_transforms() -> void;
+
+        /**
+         * Apply gravity, queued forces and dampening to the velocity of each dynamic rigid body
          *
-         * @param event event information
+         * @param dt the time to advance by, in seconds
+         */
+        auto integrate_velocities(f32 dt) -> void;
+
+        /**
+         * Move each dynamic rigid body by its velocity
+         * Must follow integrate_velocities on the same update, as it moves the bodies synced there
          *
-         * @todo copy event parameter by reference not value
+         * @param dt the time to advance by, in seconds
          */
-        static auto collision_resolution_callback(afk::event::Event event) -> void;
+        auto integrate_positions(f32 dt) -> void;
 
-      private:
         /**
-         * Apply changes queued for rigid bodies
+         * Stop each rigid body with continuous collision at the first collider in its path, if it moved far enough to pass through one
+         * The part of its velocity heading into what it hit is removed, or reflected if it hit fast enough to bounce
+         * Must be called after integrate_positions and before the colliders are synchronised, as the sweep starts from the colliders
          */
-        auto apply_rigid_body_changes(f32 dt) -> void;
+        auto sweep_continuous_bodies() -> void;
+
+        /**
+         * Wake every sleeping island that has an awake body in it, as that body is touching the island
+         * Must be called before the contacts are tested, with the islands built from the last update's contacts, so the woken bodies' contacts are tested
+         * Sleeping islands are woken whole, as contacts between resting colliders aren't tested so the islands rebuilt each update don't hold them together
+         * Every island is woken when gravity changes, and an island is woken when one of its bodies, or anything it was resting on, is destroyed
+         */
+        auto wake_islands() -> void;
+
+        /**
+         * Put islands to sleep once all of their bodies have been moving slowly for long enough
+         * The island's bodies, and everything they're touching, are kept so the island can be woken together
+         *
+         * @param dt the time advanced by, in seconds
+         */
+        auto sleep_islands(f32 dt) -> void;
 
         /**
          * Method depenetrates non-static rigid bodies from other colliders
          * May cause new, different penetrations so it is recommende to run this multiple times
          *
+         * Works from the collision system's contact cache, moving cached contacts along with the bodies rather than testing collisions again
          * Does NOT re-syncronise the transform components and the colliders, so be sure to syncronise them after calling this
          *
          * @return number of rigid bodies de-penetrated
          */
         auto depenetrate_dynamic_rigid_bodies() -> u32;
 
-        /**
-         * Get the coefficient of the impulse vector
-         *
-         * @param data collision event data
-         * @param contact_normal the contact normal from the first body to the second
-         * @param r1 the first body's vector from center of mass to its collision point in local space
-         * @param r2 the second body's vector from center of mass to its collision point in local space
-         */
-        static auto get_impulse_coefficient(const afk::event::Event::Collision &data,
-                                            const glm::vec3 &contact_normal,
-                                            const glm::vec3 &r1,
-                                            const glm::vec3 &r2) -> f32;
-
         /**
          * Get inertia tensor of a sphere shape in its own local space
          *
@@ -169,17 +202,44 @@ namespace afk {
         /** Is the physics system initialized? */
         bool is_initialized = false;
 
+        /** The world this system belongs to */
+        afk::World &owner;
+
         /** maximum number of times to run depenetration per update */
         static constexpr u32 DEPENETRATION_MAXIMUM_ITERATIONS = 10;
 
         /** maximum penetration value */
         static constexpr f32 MAXIMUM_PENETRATION = 0.1f;
 
-        /**
-         * coefficient of restitution
-         * 1 for perfectly elastic collisions, 0 for all energy lost
-         */
-        static constexpr f32 COEFFICENT_OF_RESTITUTION = 0.9f;
+        /** how far a rigid body with continuous collision must move in one update to be swept, as a fraction of its smallest half extent */
+        static constexpr f32 CONTINUOUS_COLLISION_THRESHOLD = 0.5f;
+
+        /** Packed state of the moving rigid bodies, integrated several at a time */
+        afk::physics::BodyBatch body_batch;
+
+        /** Resolves contacts between rigid bodies, keeping impulses between steps for warm starting */
+        afk::physics::ContactSolver contact_solver;
+
+        /** Islands of touching dynamic rigid bodies, rebuilt on each update */
+        afk::physics::Islands islands = {};
+
+        /** Islands that are asleep, kept so they're woken whole */
+        afk::physics::SleepingIslands sleeping_islands = {};
+
+        /** Bodies swept by continuous collision on the last update */
+        std::vector<afk::ecs::Entity> continuous_entities = {};
+
+        /** Sphere swept for each swept body, from the centre of its bounds along its motion with its smallest half extent as the radius */
+        std::vector<afk::ecs::system::CollisionSystem::SweepQuery> continuous_queries = {};
+
+        /** Hits of each swept body's sphere */
+        std::vector<afk::ecs::system::CollisionSystem::QueryResult> continuous_results = {};
+
+        /** If gravity was enabled on the last update, to wake every body when it changes */
+        bool was_gravity_enabled = false;
+
+        /** The gravity on the last update, to wake every body when it changes */
+        glm::vec3 last_gravity = glm::vec3{0.0f};
       };
     }
   }
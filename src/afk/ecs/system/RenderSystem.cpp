@@ -1,28 +1,78 @@
 #include "afk/ecs/system/RenderSystem.hpp"
 
+#include <vector>
+
 #include "afk/Engine.hpp"
+#include "afk/World.hpp"
+#include "afk/debug/Profiler.hpp"
+#include "afk/ecs/Entity.hpp"
 #include "afk/ecs/component/ModelsComponent.hpp"
+#include "afk/ecs/component/PreviousTransformComponent.hpp"
 #include "afk/ecs/component/TransformComponent.hpp"
 #include "afk/io/Log.hpp"
 
 using afk::ecs::component::ModelsComponent;
+using afk::ecs::component::PreviousTransformComponent;
 using afk::ecs::component::TransformComponent;
 using afk::ecs::system::RenderSystem;
+using afk::render::RenderSnapshot;
 
-auto RenderSystem::update() -> void {
-  auto &afk       = afk::Engine::get();
-  auto &registry  = afk.ecs.registry;
-  const auto view = registry.view<ModelsComponent, TransformComponent>();
+auto RenderSystem::update([[maybe_unused]] f32 dt) -> void {
+  afk_profile_scope("RenderSystem::update");
 
-  for (const auto entity : view) {
-    auto &models     = registry.get<ModelsComponent>(entity);
-    auto &parent_transform = registry.get<TransformComponent>(entity);
+  auto &afk = afk::Engine::get();
 
-    auto shader = afk.renderer.get_shader_program(
-        afk::io::get_resource_path("res/shader/default.prog"));
-    for (const auto &model : models.models) {
-      const auto transform = parent_transform.combined_transform_to_mat4(model.transform);
-      afk.renderer.draw_model(model.model_handle, shader, transform);
-    }
+  afk.renderer.draw_snapshot(afk.get_render_snapshot());
+}
+
+auto RenderSystem::build_snapshot(afk::World &world, RenderSnapshot &snapshot) -> void {
+  afk_profile_scope("RenderSystem::build_snapshot");
+
+  auto &afk        = afk::Engine::get();
+  auto &registry   = world.ecs.registry;
+  const auto view  = registry.view<ModelsComponent, TransformComponent>();
+  const auto alpha = afk.get_interpolation_alpha();
+
+  // lay the draw items out by entity so each entity can be filled in
+  // independently of the others
+  const auto entities = std::vector<afk::ecs::Entity>(view.begin(), view.end());
+  auto offsets        = std::vector<usize>(entities.size() + 1);
+
+  for (auto i = usize{0}; i < entities.size(); ++i) {
+    offsets[i + 1] = offsets[i] + view.get<ModelsComponent>(entities[i]).models.size();
   }
+
+  auto &draw_items = snapshot.draw_items;
+  draw_items.resize(offsets.back());
+
+  // building the matrices doesn't touch OpenGL, so it can be done in parallel
+  afk.job_manager.parallel_for(entities.size(), [&](usize i) {
+    const auto entity     = entities[i];
+    const auto &models    = view.get<ModelsComponent>(entity);
+    auto parent_transform = view.get<TransformComponent>(entity);
+
+    // draw moving entities between their previous and current tick
+    if (registry.has<PreviousTransformComponent>(entity)) {
+      parent_transform = afk::physics::interpolate(
+          registry.get<PreviousTransformComponent>(entity).transform,
+          parent_transform, alpha);
+    }
+
+    for (auto j = usize{0}; j < models.models.size(); ++j) {
+      const auto &model = models.models[j];
+
+      draw_items[offsets[i] + j] = {
+          model.model_handle,
+          parent_transform.combined_transform_to_mat4(model.transform)};
+    }
+  });
+
+  const auto window_size  = afk.renderer.get_window_size();
+  snapshot.shader_program = afk.renderer.get_shader_program(
+      afk::io::get_resource_path("res/shader/default.prog"));
+
+  // capture the camera now, as it may move while the snapshot is drawn
+  snapshot.projection =
+      afk.camera.get_projection_matrix(window_size.x, window_size.y);
+  snapshot.view = afk.camera.get_view_matrix();
 }
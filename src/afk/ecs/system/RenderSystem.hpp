@@ -1,6 +1,11 @@
 #pragma once
 
+#include "afk/NumericTypes.hpp"
+#include "afk/render/RenderSnapshot.hpp"
+
 namespace afk {
+  class World;
+
   namespace ecs {
     namespace system {
       /**
@@ -8,9 +13,22 @@ namespace afk {
        */
       struct RenderSystem {
         /**
-         * Draws all entities with a model and position component.
+         * Draws the engine's current render snapshot.
+         *
+         * @param dt The time since the last display update, in seconds.
+         */
+        static auto update(f32 dt) -> void;
+
+        /**
+         * Captures every entity in the specified world with a model and
+         * position component, along with the camera, into the specified
+         * snapshot. Must not be called while the world is being stepped.
+         *
+         * @param world The world to capture.
+         * @param snapshot The snapshot to fill.
          */
-        static auto update() -> void;
+        static auto build_snapshot(afk::World &world, afk::render::RenderSnapshot &snapshot)
+            -> void;
       };
     }
   }
@@ -0,0 +1,23 @@
+#include "afk/event/Event.hpp"
+
+#include "afk/debug/Assert.hpp"
+
+using afk::event::Event;
+
+auto Event::get_is_input(Type type) -> bool {
+  switch (type) {
+    case Type::MouseDown:
+    case Type::MouseUp:
+    case Type::MouseMove:
+    case Type::KeyDown:
+    case Type::KeyUp:
+    case Type::KeyRepeat:
+    case Type::TextEnter:
+    case Type::MouseScroll: return true;
+    case Type::Collision:
+    case Type::TriggerEnter:
+    case Type::TriggerExit: return false;
+  }
+
+  afk_unreachable();
+}
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <span>
 #include <string>
 #include <variant>
+#include <vector>
 
 #include <glm/glm.hpp>
 #include "afk/NumericTypes.hpp"
@@ -72,7 +74,7 @@ namespace afk {
       };
 
       /**
-       * Encapsulates a collision event.
+       * Encapsulates a collision between two entities.
        */
       struct Collision {
         /** Representation of a single contact in a collision */
@@ -97,6 +99,55 @@ namespace afk {
         ContactCollection contacts = {};
       };
 
+      /**
+       * A pair of colliding entities in a collision event, which refers to
+       * its range of the event's contacts.
+       */
+      struct ContactPair {
+        /** The first entity in the collision */
+        ecs::Entity entity1;
+        /** The second entity in the collision */
+        ecs::Entity entity2;
+        /** The index of the pair's first contact. */
+        u32 first_contact = {};
+        /** The number of contacts the pair has. */
+        u32 contact_count = {};
+      };
+
+      /**
+       * Encapsulates a collision event, holding every collision of a single
+       * physics step. The spans refer to memory owned by the collision
+       * system, so they're only valid while the event is being dispatched.
+       */
+      struct Contacts {
+        /** The colliding pairs. */
+        std::span<const ContactPair> pairs = {};
+        /** The contacts of every pair, one pair after another. */
+        std::span<const Collision::Contact> contacts = {};
+
+        /**
+         * Returns the contacts of the specified pair.
+         *
+         * @param pair The pair, which must belong to this event.
+         * @return The pair's contacts.
+         */
+        auto get_contacts(const ContactPair &pair) const
+            -> std::span<const Collision::Contact> {
+          return this->contacts.subspan(pair.first_contact, pair.contact_count);
+        }
+      };
+
+      /**
+       * Encapsulates a trigger event, when a collider starts or stops
+       * overlapping a trigger collider.
+       */
+      struct Trigger {
+        /** The first entity in the overlap. */
+        ecs::Entity entity1;
+        /** The second entity in the overlap. */
+        ecs::Entity entity2;
+      };
+
       /**
        * Denotes an event type.
        */
@@ -110,12 +161,24 @@ namespace afk {
         TextEnter,
         MouseScroll,
         Collision,
+        TriggerEnter,
+        TriggerExit,
       };
 
+      /**
+       * Returns if the specified event type comes from user input. Input
+       * events are dispatched on the main thread and recorded for replays,
+       * anything else is produced by the engine itself.
+       *
+       * @param type The event type.
+       * @return True if the event type comes from user input.
+       */
+      static auto get_is_input(Type type) -> bool;
+
       /**
        * Encapsulates all possible event data.
        */
-      using Data = std::variant<std::monostate, MouseMove, MouseButton, Key, Text, MouseScroll, Collision>;
+      using Data = std::variant<std::monostate, MouseMove, MouseButton, Key, Text, MouseScroll, Contacts, Trigger>;
 
       /**
        * Returns the data contained in this event.
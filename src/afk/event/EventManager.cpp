@@ -3,12 +3,14 @@
 #include "afk/Engine.hpp"
 #include "afk/NumericTypes.hpp"
 #include "afk/debug/Assert.hpp"
+#include "afk/debug/Profiler.hpp"
 #include "afk/event/Event.hpp"
 #include "afk/io/Log.hpp"
 #include "afk/io/Time.hpp"
 
 // Must be included after GLAD.
 #include <algorithm>
+#include <utility>
 
 #include <GLFW/glfw3.h>
 
@@ -36,21 +38,83 @@ auto EventManager::initialize(WindowHandle window_handle) -> void {
 }
 
 auto EventManager::pump_events() -> void {
-  glfwPollEvents();
+  afk_profile_scope("EventManager::pump_events");
 
-  while (this->events.size() > 0) {
-    const auto &current_event = this->events.front();
+  this->poll_events();
+  this->dispatch_input_events();
+  this->dispatch_events();
+}
+
+auto EventManager::poll_events() -> void {
+  afk_profile_scope("EventManager::poll_events");
+
+  this->polled_events.clear();
+
+  // there is no window to poll when running headless
+  if (this->is_initialized) {
+    glfwPollEvents();
+  }
+}
+
+auto EventManager::get_polled_events() const -> const std::vector<Event> & {
+  return this->polled_events;
+}
+
+auto EventManager::set_is_input_enabled(bool is_input_enabled) -> void {
+  this->is_input_enabled = is_input_enabled;
+}
+
+auto EventManager::push_input_event(Event event) -> void {
+  if (!this->is_input_enabled) {
+    return;
+  }
+
+  this->polled_events.push_back(event);
+  this->push_event(std::move(event));
+}
+
+auto EventManager::dispatch_input_events() -> void {
+  afk_profile_scope("EventManager::dispatch_input_events");
+
+  this->dispatch_queue(this->input_events);
+}
+
+auto EventManager::dispatch_events() -> void {
+  afk_profile_scope("EventManager::dispatch_events");
+
+  this->dispatch_queue(this->events);
+}
+
+auto EventManager::dispatch_queue(std::queue<Event> &queue) -> void {
+  while (true) {
+    auto current_event = Event{};
+
+    // callbacks may push events, so don't hold the lock while calling them
+    {
+      auto lock = std::lock_guard{this->events_mutex};
+
+      if (queue.empty()) {
+        return;
+      }
+
+      current_event = std::move(queue.front());
+      queue.pop();
+    }
 
     for (const auto &event_callback : this->callbacks[current_event.type]) {
       event_callback(current_event);
     }
-
-    this->events.pop();
   }
 }
 
 auto EventManager::push_event(Event event) -> void {
-  this->events.push(event);
+  auto lock = std::lock_guard{this->events_mutex};
+
+  if (Event::get_is_input(event.type)) {
+    this->input_events.push(std::move(event));
+  } else {
+    this->events.push(std::move(event));
+  }
 }
 
 auto EventManager::register_event(Type type, Callback callback) -> void {
@@ -93,7 +157,7 @@ auto EventManager::key_callback([[maybe_unused]] GLFWwindow *window, i32 key,
     case GLFW_REPEAT: type = Type::KeyRepeat; break;
   }
 
-  afk.event_manager.events.push({Event::Key{key, scancode, control, alt, shift}, type});
+  afk.event_manager.push_input_event({Event::Key{key, scancode, control, alt, shift}, type});
 
   // FIXME: Move to keyboard manager.
   // if (action != GLFW_REPEAT) {
@@ -123,14 +187,14 @@ auto EventManager::key_callback([[maybe_unused]] GLFWwindow *window, i32 key,
 auto EventManager::char_callback([[maybe_unused]] GLFWwindow *window, u32 codepoint) -> void {
   auto &afk = Engine::get();
 
-  afk.event_manager.events.push({Event::Text{codepoint}, Type::TextEnter});
+  afk.event_manager.push_input_event({Event::Text{codepoint}, Type::TextEnter});
 }
 
 auto EventManager::mouse_pos_callback([[maybe_unused]] GLFWwindow *window,
                                       f64 x, f64 y) -> void {
   auto &afk = Engine::get();
 
-  afk.event_manager.events.push({Event::MouseMove{x, y}, Type::MouseMove});
+  afk.event_manager.push_input_event({Event::MouseMove{x, y}, Type::MouseMove});
 }
 
 auto EventManager::mouse_press_callback([[maybe_unused]] GLFWwindow *window, i32 button,
@@ -142,14 +206,14 @@ auto EventManager::mouse_press_callback([[maybe_unused]] GLFWwindow *window, i32
   const auto shift   = (mods & GLFW_MOD_SHIFT) == GLFW_MOD_SHIFT;
   const auto type    = action == GLFW_PRESS ? Type::MouseDown : Type::MouseUp;
 
-  afk.event_manager.events.push({Event::MouseButton{button, control, alt, shift}, type});
+  afk.event_manager.push_input_event({Event::MouseButton{button, control, alt, shift}, type});
 }
 
 auto EventManager::mouse_scroll_callback([[maybe_unused]] GLFWwindow *window,
                                          f64 dx, f64 dy) -> void {
   auto &afk = Engine::get();
 
-  afk.event_manager.events.push({Event::MouseScroll{dx, dy}, Type::MouseScroll});
+  afk.event_manager.push_input_event({Event::MouseScroll{dx, dy}, Type::MouseScroll});
 }
 
 auto EventManager::error_callback([[maybe_unused]] i32 error, const char *msg) -> void {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <mutex>
 #include <queue>
 #include <unordered_map>
 #include <vector>
@@ -25,7 +26,7 @@ namespace afk {
       class Callback {
       public:
         /** The underlying function type. */
-        using Function = std::function<void(Event)>;
+        using Function = std::function<void(const Event &)>;
 
         /**
          * Constructs a new callback from the specified function.
@@ -76,6 +77,42 @@ namespace afk {
        */
       auto pump_events() -> void;
 
+      /**
+       * Polls for new window events and queues them, without calling any
+       * callbacks.
+       */
+      auto poll_events() -> void;
+
+      /**
+       * Returns the input events queued by the last poll.
+       *
+       * @return The polled input events.
+       */
+      auto get_polled_events() const -> const std::vector<Event> &;
+
+      /**
+       * Sets if input from the window is queued. Disabling it lets input be
+       * fed in from elsewhere, such as a recording, without live input
+       * getting mixed in.
+       *
+       * @param is_input_enabled Should window input be queued?
+       */
+      auto set_is_input_enabled(bool is_input_enabled) -> void;
+
+      /**
+       * Calls the callbacks of every queued input event, without polling for
+       * new window events. Input callbacks change state owned by the main
+       * thread, such as the camera and UI, so this is only called from it.
+       */
+      auto dispatch_input_events() -> void;
+
+      /**
+       * Calls the callbacks of every queued simulation event, such as
+       * collisions. Input events are left queued, so this is safe to call
+       * from the simulation while it runs off the main thread.
+       */
+      auto dispatch_events() -> void;
+
       /**
        * Pushes an event to the event queue.
        *
@@ -155,6 +192,20 @@ namespace afk {
        */
       static auto mouse_scroll_callback(GLFWwindow *window, f64 dx, f64 dy) -> void;
 
+      /**
+       * Queues an input event from the window, if window input is enabled.
+       *
+       * @param event The input event.
+       */
+      auto push_input_event(Event event) -> void;
+
+      /**
+       * Pops and calls the callbacks of every event in a queue.
+       *
+       * @param queue The queue to dispatch.
+       */
+      auto dispatch_queue(std::queue<Event> &queue) -> void;
+
       /**
        * Reports GLFW error events.
        *
@@ -165,8 +216,16 @@ namespace afk {
 
       /** Is the event manager initialized? */
       bool is_initialized = false;
-      /** The event queue. */
+      /** Is input from the window queued? */
+      bool is_input_enabled = true;
+      /** The input events queued by the last poll. */
+      std::vector<Event> polled_events = {};
+      /** The input event queue, only dispatched on the main thread. */
+      std::queue<Event> input_events = {};
+      /** The simulation event queue. */
       std::queue<Event> events = {};
+      /** Guards the event queues, as systems may push events from any thread. */
+      std::mutex events_mutex = {};
 
       /** Maps each event type to a collection of callbacks. */
       std::unordered_map<Event::Type, std::vector<Callback>> callbacks = {
@@ -174,6 +233,7 @@ namespace afk {
           {Event::Type::MouseMove, {}},   {Event::Type::KeyDown, {}},
           {Event::Type::KeyUp, {}},       {Event::Type::TextEnter, {}},
           {Event::Type::MouseScroll, {}}, {Event::Type::Collision, {}},
+          {Event::Type::TriggerEnter, {}}, {Event::Type::TriggerExit, {}},
       };
     };
   }
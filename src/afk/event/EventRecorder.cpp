@@ -0,0 +1,91 @@
+#include "afk/event/EventRecorder.hpp"
+
+#include <filesystem>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "afk/debug/Assert.hpp"
+#include "afk/utility/Visitor.hpp"
+
+using namespace std::string_literals;
+
+using afk::event::Event;
+using afk::event::EventRecorder;
+using afk::utility::Visitor;
+using std::filesystem::path;
+
+/**
+ * Writes the specified value to the specified stream as raw bytes.
+ *
+ * @param stream The stream to write to.
+ * @param value The value to write.
+ */
+template<typename T>
+static auto write(std::ostream &stream, const T &value) -> void {
+  static_assert(std::is_trivially_copyable_v<T>, "Only raw values can be written");
+  stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * Packs the specified modifier key states into bits.
+ *
+ * @param control Was the control key held?
+ * @param alt Was the alt key held?
+ * @param shift Was the shift key held?
+ * @return The packed modifiers.
+ */
+static auto pack_modifiers(bool control, bool alt, bool shift) -> u8 {
+  return static_cast<u8>((control ? 1 : 0) | (alt ? 2 : 0) | (shift ? 4 : 0));
+}
+
+EventRecorder::EventRecorder(const path &file_path)
+  : file(file_path, std::ios::binary | std::ios::trunc) {
+  afk_assert(this->file.is_open(), "Unable to open recording file "s + file_path.string());
+
+  this->file.write(EventRecorder::MAGIC.data(), EventRecorder::MAGIC.size());
+  write(this->file, EventRecorder::VERSION);
+}
+
+auto EventRecorder::record_frame(f32 dt, const std::vector<Event> &events) -> void {
+  auto count = u32{0};
+  for (const auto &event : events) {
+    count += Event::get_is_input(event.type) ? 1 : 0;
+  }
+
+  write(this->file, dt);
+  write(this->file, count);
+
+  for (const auto &event : events) {
+    if (!Event::get_is_input(event.type)) {
+      continue;
+    }
+
+    write(this->file, static_cast<u8>(event.type));
+
+    auto visitor = Visitor{
+        [this](const Event::MouseMove &data) {
+          write(this->file, data.x);
+          write(this->file, data.y);
+        },
+        [this](const Event::MouseButton &data) {
+          write(this->file, data.button);
+          write(this->file, pack_modifiers(data.control, data.alt, data.shift));
+        },
+        [this](const Event::Key &data) {
+          write(this->file, data.key);
+          write(this->file, data.scancode);
+          write(this->file, pack_modifiers(data.control, data.alt, data.shift));
+        },
+        [this](const Event::Text &data) { write(this->file, data.codepoint); },
+        [this](const Event::MouseScroll &data) {
+          write(this->file, data.x);
+          write(this->file, data.y);
+        },
+        [](const auto &) { afk_unreachable(); }};
+
+    std::visit(visitor, event.data);
+  }
+
+  afk_assert(this->file.good(), "Failed to write recording");
+}
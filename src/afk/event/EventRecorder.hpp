@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/event/Event.hpp"
+
+namespace afk {
+  namespace event {
+    /**
+     * Records the input events and delta time of each frame to a compact
+     * binary file, so a run can be replayed exactly with an EventReplayer.
+     *
+     * A recording starts with the magic bytes and format version. Each
+     * frame is then stored as its delta time, its event count, and each
+     * event's type followed by its data. Values are stored in native byte
+     * order, so recordings are only portable between machines of the same
+     * endianness.
+     */
+    class EventRecorder {
+    public:
+      /** The bytes every recording starts with. */
+      static constexpr auto MAGIC = std::array<char, 4>{'a', 'f', 'k', 'r'};
+      /** The recording format version, bumped whenever the format changes. */
+      static constexpr u32 VERSION = 1;
+
+      /**
+       * Starts a recording at the specified path, overwriting any existing
+       * file.
+       *
+       * @param file_path The path to record to.
+       */
+      explicit EventRecorder(const std::filesystem::path &file_path);
+      ~EventRecorder()                     = default;
+      EventRecorder(EventRecorder &&)      = delete;
+      EventRecorder(const EventRecorder &) = delete;
+      auto operator=(const EventRecorder &) -> EventRecorder & = delete;
+      auto operator=(EventRecorder &&) -> EventRecorder & = delete;
+
+      /**
+       * Records a single frame.
+       *
+       * @param dt The frame delta time, in seconds.
+       * @param events The input events polled during the frame.
+       */
+      auto record_frame(f32 dt, const std::vector<Event> &events) -> void;
+
+    private:
+      /** The recording file. */
+      std::ofstream file = {};
+    };
+  }
+}
@@ -0,0 +1,103 @@
+#include "afk/event/EventReplayer.hpp"
+
+#include <array>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "afk/debug/Assert.hpp"
+#include "afk/event/EventRecorder.hpp"
+
+using namespace std::string_literals;
+
+using afk::event::Event;
+using afk::event::EventRecorder;
+using afk::event::EventReplayer;
+using std::filesystem::path;
+
+/**
+ * Reads a value written as raw bytes from the specified stream.
+ *
+ * @param stream The stream to read from.
+ * @return The value read.
+ */
+template<typename T>
+static auto read(std::istream &stream) -> T {
+  static_assert(std::is_trivially_copyable_v<T>, "Only raw values can be read");
+  auto value = T{};
+  stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+
+  return value;
+}
+
+EventReplayer::EventReplayer(const path &file_path) : file(file_path, std::ios::binary) {
+  afk_assert(this->file.is_open(), "Unable to open recording file "s + file_path.string());
+
+  auto magic = std::array<char, EventRecorder::MAGIC.size()>{};
+  this->file.read(magic.data(), magic.size());
+  afk_assert(this->file.good() && magic == EventRecorder::MAGIC,
+             file_path.string() + " is not a recording"s);
+
+  const auto version = read<u32>(this->file);
+  afk_assert(version == EventRecorder::VERSION,
+             "Recording version "s + std::to_string(version) + " is unsupported"s);
+}
+
+auto EventReplayer::next_frame() -> std::optional<Frame> {
+  auto frame = Frame{};
+  frame.dt   = read<f32>(this->file);
+
+  // the recording ends on a frame boundary
+  if (this->file.eof()) {
+    return std::nullopt;
+  }
+
+  const auto count = read<u32>(this->file);
+
+  for (auto i = u32{0}; i < count; ++i) {
+    auto event = Event{};
+    event.type = static_cast<Event::Type>(read<u8>(this->file));
+
+    switch (event.type) {
+      case Event::Type::MouseMove:
+      case Event::Type::MouseScroll: {
+        const auto x = read<f64>(this->file);
+        const auto y = read<f64>(this->file);
+        event.data   = event.type == Event::Type::MouseMove
+                         ? Event::Data{Event::MouseMove{x, y}}
+                         : Event::Data{Event::MouseScroll{x, y}};
+        break;
+      }
+      case Event::Type::MouseDown:
+      case Event::Type::MouseUp: {
+        const auto button    = read<i32>(this->file);
+        const auto modifiers = read<u8>(this->file);
+        event.data           = Event::MouseButton{button, (modifiers & 1) != 0,
+                                        (modifiers & 2) != 0, (modifiers & 4) != 0};
+        break;
+      }
+      case Event::Type::KeyDown:
+      case Event::Type::KeyUp:
+      case Event::Type::KeyRepeat: {
+        const auto key       = read<i32>(this->file);
+        const auto scancode  = read<i32>(this->file);
+        const auto modifiers = read<u8>(this->file);
+        event.data = Event::Key{key, scancode, (modifiers & 1) != 0,
+                                (modifiers & 2) != 0, (modifiers & 4) != 0};
+        break;
+      }
+      case Event::Type::TextEnter: {
+        event.data = Event::Text{read<u32>(this->file)};
+        break;
+      }
+      default: afk_assert(false, "Recording contains an unknown event type");
+    }
+
+    frame.events.push_back(std::move(event));
+  }
+
+  afk_assert(this->file.good(), "Recording ended part way through a frame");
+
+  return frame;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <vector>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/event/Event.hpp"
+
+namespace afk {
+  namespace event {
+    /**
+     * Plays back a recording made by an EventRecorder, one frame at a time.
+     */
+    class EventReplayer {
+    public:
+      /**
+       * A recorded frame.
+       */
+      struct Frame {
+        /** The frame delta time, in seconds. */
+        f32 dt = {};
+        /** The input events polled during the frame. */
+        std::vector<Event> events = {};
+      };
+
+      /**
+       * Opens the recording at the specified path.
+       *
+       * @param file_path The recording path.
+       */
+      explicit EventReplayer(const std::filesystem::path &file_path);
+      ~EventReplayer()                     = default;
+      EventReplayer(EventReplayer &&)      = delete;
+      EventReplayer(const EventReplayer &) = delete;
+      auto operator=(const EventReplayer &) -> EventReplayer & = delete;
+      auto operator=(EventReplayer &&) -> EventReplayer & = delete;
+
+      /**
+       * Reads the next recorded frame.
+       *
+       * @return The next frame, or nothing once the recording has ended.
+       */
+      auto next_frame() -> std::optional<Frame>;
+
+    private:
+      /** The recording file. */
+      std::ifstream file = {};
+    };
+  }
+}
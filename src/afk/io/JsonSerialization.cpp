@@ -1,6 +1,7 @@
 #include "afk/io/JsonSerialization.hpp"
 
 #include <iostream>
+#include <string>
 
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
@@ -81,6 +82,30 @@ namespace afk {
         }
 
         c.mass = j.at("mass").get<f32>();
+
+        // layers are one bit each, so a value that doesn't fit would silently lose layers
+        const auto get_layers = [&j](const std::string &key) {
+          const auto &value = j.at(key);
+          afk_assert(value.is_number_integer() && value.get<i64>() >= 0 &&
+                         value.get<i64>() <= ColliderComponent::ALL_LAYERS,
+                     "Collider " + key + " must be a whole number between 0 and " +
+                         std::to_string(ColliderComponent::ALL_LAYERS));
+
+          return static_cast<ColliderComponent::Layers>(value.get<i64>());
+        };
+
+        // colliders are in the default layer and touch every layer unless specified
+        if (j.find("category") != j.end()) {
+          c.category = get_layers("category");
+        }
+
+        if (j.find("mask") != j.end()) {
+          c.mask = get_layers("mask");
+        }
+
+        if (j.find("is_trigger") != j.end()) {
+          c.is_trigger = j.at("is_trigger").get<bool>();
+        }
       }
 
       auto from_json(const Json &j, ColliderComponent &c) -> void {
@@ -127,6 +152,13 @@ namespace afk {
           // initialise external forces/torque to 0
           c.external_forces  = glm::vec3{0.0f};
           c.external_torques = glm::vec3{0.0f};
+
+          // get continuous collision if defined, else leave it off
+          if (j.find("continuous_collision") != j.end()) {
+            c.continuous_collision = j.at("continuous_collision").get<bool>();
+          } else {
+            c.continuous_collision = false;
+          }
         }
       }
     }
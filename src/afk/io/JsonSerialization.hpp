@@ -4,6 +4,7 @@
 #include <glm/gtx/quaternion.hpp>
 
 #include "afk/config/Config.hpp"
+#include "afk/debug/Benchmark.hpp"
 #include "afk/ecs/component/Component.hpp"
 #include "afk/io/Json.hpp"
 #include "afk/physics/Transform.hpp"
@@ -35,7 +36,14 @@ namespace afk {
     NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Video, resolution_width, resolution_height,
                                        fullscreen_enabled, antialiasing_samples,
                                        antialiasing_enabled, vsync_enabled)
-    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Config, video)
+    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Simulation, fixed_timestep_enabled,
+                                       tick_rate, max_ticks_per_frame,
+                                       pipelining_enabled)
+    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Config, video, simulation)
+  }
+
+  namespace debug {
+    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Benchmark::Summary, count, min, mean, p50, p99, max)
   }
 
   namespace physics {
@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 
 #include "afk/Engine.hpp"
@@ -22,6 +23,8 @@ namespace afk {
       std::filesystem::path log_path = {};
       /** The log file handle. */
       std::ofstream log_file = {};
+      /** Guards the log, as systems may log from any thread. */
+      std::mutex mutex = {};
 
       /**
        * Opens the log file.
@@ -40,6 +43,7 @@ namespace afk {
 
       auto &afk = Engine::get();
       auto ss   = ostringstream{};
+      auto lock = std::lock_guard{log.mutex};
 
       if (!log.log_file.is_open()) {
         log.open_log_file();
@@ -0,0 +1,208 @@
+#include "afk/job/JobManager.hpp"
+
+#include <string>
+
+#include "afk/debug/Assert.hpp"
+#include "afk/debug/Profiler.hpp"
+
+using afk::job::JobManager;
+
+auto JobManager::Counter::increment(usize count) -> void {
+  this->pending.fetch_add(count, std::memory_order_relaxed);
+}
+
+auto JobManager::Counter::decrement() -> bool {
+  return this->pending.fetch_sub(1, std::memory_order_acq_rel) == 1;
+}
+
+auto JobManager::Counter::is_done() const -> bool {
+  return this->pending.load(std::memory_order_acquire) == 0;
+}
+
+auto JobManager::QueuedJob::is_ready() const -> bool {
+  return std::all_of(this->dependencies.begin(), this->dependencies.end(),
+                     [](const auto *counter) { return counter->is_done(); });
+}
+
+JobManager::~JobManager() {
+  {
+    auto lock = std::lock_guard{this->sleep_mutex};
+    this->is_stopping = true;
+  }
+
+  this->job_available.notify_all();
+
+  for (auto &worker : this->workers) {
+    worker.join();
+  }
+}
+
+auto JobManager::initialize() -> void {
+  afk_assert(!this->is_initialized, "Job manager already initialized");
+
+  // the main thread runs jobs while waiting, so leave a core for it
+  const auto hardware_threads = std::thread::hardware_concurrency();
+  const auto worker_count = hardware_threads > 1 ? hardware_threads - 1 : 1;
+
+  JobManager::queue_index = 0;
+
+  for (auto i = usize{0}; i < worker_count + 1; ++i) {
+    this->queues.push_back(std::make_unique<Queue>());
+  }
+
+  for (auto i = usize{1}; i < worker_count + 1; ++i) {
+    this->workers.emplace_back([this, i]() { this->work(i); });
+  }
+
+  this->is_initialized = true;
+}
+
+auto JobManager::submit(Job job, Counter *counter, Dependencies dependencies) -> void {
+  afk_assert(this->is_initialized, "Job manager not initialized");
+
+  if (counter != nullptr) {
+    counter->increment();
+  }
+
+  // threads outside the pool share the main thread's queue
+  auto &queue = *this->queues[JobManager::queue_index];
+
+  {
+    auto lock = std::lock_guard{queue.mutex};
+    queue.jobs.push_back({std::move(job), counter, std::move(dependencies)});
+  }
+
+  this->queued_count.fetch_add(1, std::memory_order_release);
+  this->wake(false);
+}
+
+auto JobManager::wait(const Counter &counter) -> void {
+  while (!counter.is_done()) {
+    // read before looking for jobs, so anything that becomes ready while looking ends the sleep
+    const auto last_wake_count = this->wake_count.load(std::memory_order_acquire);
+
+    if (!this->is_initialized) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    if (this->try_run_job()) {
+      continue;
+    }
+
+    auto lock = std::unique_lock{this->sleep_mutex};
+    this->job_available.wait(lock, [this, &counter, last_wake_count]() {
+      return counter.is_done() ||
+             this->wake_count.load(std::memory_order_acquire) != last_wake_count;
+    });
+  }
+}
+
+auto JobManager::finish(Counter &counter) -> void {
+  if (counter.decrement()) {
+    this->wake(true);
+  }
+}
+
+auto JobManager::get_worker_count() const -> usize {
+  return this->workers.size();
+}
+
+auto JobManager::take_job(Queue &queue, bool is_owner, QueuedJob &job) -> bool {
+  auto lock = std::lock_guard{queue.mutex};
+
+  if (queue.jobs.empty()) {
+    return false;
+  }
+
+  // jobs waiting on dependencies are skipped rather than blocking the queue
+  if (is_owner) {
+    for (auto it = queue.jobs.rbegin(); it != queue.jobs.rend(); ++it) {
+      if (it->is_ready()) {
+        job = std::move(*it);
+        queue.jobs.erase(std::next(it).base());
+        return true;
+      }
+    }
+  } else {
+    for (auto it = queue.jobs.begin(); it != queue.jobs.end(); ++it) {
+      if (it->is_ready()) {
+        job = std::move(*it);
+        queue.jobs.erase(it);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+auto JobManager::try_run_job() -> bool {
+  if (this->queued_count.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+
+  const auto queue_count = this->queues.size();
+  const auto own_index   = JobManager::queue_index;
+  auto job               = QueuedJob{};
+  auto is_taken          = false;
+
+  for (auto i = usize{0}; i < queue_count && !is_taken; ++i) {
+    const auto index = (own_index + i) % queue_count;
+    is_taken         = JobManager::take_job(*this->queues[index], i == 0, job);
+  }
+
+  if (!is_taken) {
+    return false;
+  }
+
+  this->queued_count.fetch_sub(1, std::memory_order_acq_rel);
+  job.job();
+
+  if (job.counter != nullptr) {
+    this->finish(*job.counter);
+  }
+
+  return true;
+}
+
+auto JobManager::wake(bool is_waking_all) -> void {
+  // a thread may have just found nothing to run and be about to sleep, changing
+  // the count under the lock ensures it is either already asleep or sees the change
+  {
+    auto lock = std::lock_guard{this->sleep_mutex};
+    this->wake_count.fetch_add(1, std::memory_order_release);
+  }
+
+  if (is_waking_all) {
+    this->job_available.notify_all();
+  } else {
+    this->job_available.notify_one();
+  }
+}
+
+auto JobManager::work(usize index) -> void {
+  JobManager::queue_index = index;
+  afk_profile_thread("Worker " + std::to_string(index));
+
+  while (true) {
+    // read before looking for jobs, so anything that becomes ready while looking ends the sleep
+    const auto last_wake_count = this->wake_count.load(std::memory_order_acquire);
+
+    if (this->try_run_job()) {
+      continue;
+    }
+
+    // every queued job may be blocked on a dependency, so sleep until a new
+    // job is queued or a counter finishes rather than until any job is queued
+    auto lock = std::unique_lock{this->sleep_mutex};
+    this->job_available.wait(lock, [this, last_wake_count]() {
+      return this->is_stopping ||
+             this->wake_count.load(std::memory_order_acquire) != last_wake_count;
+    });
+
+    if (this->is_stopping && this->queued_count.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+  }
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "afk/NumericTypes.hpp"
+
+namespace afk {
+  namespace job {
+    /**
+     * Manages a pool of worker threads which run jobs.
+     *
+     * Each worker owns a queue of jobs, running the most recently queued job
+     * first and stealing the oldest jobs from other workers when its own queue
+     * is empty. Threads waiting on jobs to finish help by running queued jobs
+     * rather than blocking.
+     */
+    class JobManager {
+    public:
+      /** A unit of work. */
+      using Job = std::function<void()>;
+
+      /**
+       * Counts the unfinished jobs it has been attached to. Waiting on a
+       * counter returns once each of its jobs has finished, and jobs may
+       * depend on counters to not run until they reach zero.
+       *
+       * A counter must outlive the jobs it is attached to.
+       */
+      class Counter {
+      public:
+        Counter()                = default;
+        ~Counter()               = default;
+        Counter(Counter &&)      = delete;
+        Counter(const Counter &) = delete;
+        auto operator=(const Counter &) -> Counter & = delete;
+        auto operator=(Counter &&) -> Counter & = delete;
+
+        /**
+         * Adds unfinished work to the counter.
+         *
+         * @param count The amount of work to add.
+         */
+        auto increment(usize count = 1) -> void;
+
+        /**
+         * Returns if all of the counter's work has finished.
+         *
+         * @return True if the counter has reached zero.
+         */
+        auto is_done() const -> bool;
+
+      private:
+        friend class JobManager;
+
+        /**
+         * Marks a piece of the counter's work as finished, use
+         * JobManager::finish() so threads waiting on the counter are woken.
+         *
+         * @return True if the counter reached zero.
+         */
+        auto decrement() -> bool;
+
+        /** The amount of unfinished work. */
+        std::atomic<usize> pending = {};
+      };
+
+      /** The counters a job waits on before running. */
+      using Dependencies = std::vector<const Counter *>;
+
+      JobManager() = default;
+      ~JobManager();
+      JobManager(JobManager &&)      = delete;
+      JobManager(const JobManager &) = delete;
+      auto operator=(const JobManager &) -> JobManager & = delete;
+      auto operator=(JobManager &&) -> JobManager & = delete;
+
+      /**
+       * Initializes the job subsystem, starting the worker threads. The
+       * calling thread is treated as the main thread.
+       */
+      auto initialize() -> void;
+
+      /**
+       * Queues a job to be run on a worker thread.
+       *
+       * @param job The job to run.
+       * @param counter The counter to attach the job to, if any.
+       * @param dependencies The counters that must reach zero before the job
+       *                     runs.
+       */
+      auto submit(Job job, Counter *counter = nullptr, Dependencies dependencies = {})
+          -> void;
+
+      /**
+       * Waits for the specified counter to reach zero, running queued jobs
+       * while waiting.
+       *
+       * @param counter The counter to wait on.
+       */
+      auto wait(const Counter &counter) -> void;
+
+      /**
+       * Marks a piece of a counter's work as finished. Once the counter reaches
+       * zero, sleeping threads are woken so jobs depending on it can run.
+       *
+       * @param counter The counter.
+       */
+      auto finish(Counter &counter) -> void;
+
+      /**
+       * Calls the specified function with every index in [0, count), split into
+       * batches that run concurrently. Returns once every index is processed.
+       *
+       * @param count The number of indices.
+       * @param fn The function to call with each index.
+       * @param batch_size The number of indices per job, picked from the
+       *                   number of threads if zero.
+       */
+      template<typename Fn>
+      auto parallel_for(usize count, Fn &&fn, usize batch_size = 0) -> void {
+        if (count == 0) {
+          return;
+        }
+
+        if (batch_size == 0) {
+          // a few batches per thread keeps threads busy if batches are uneven
+          const auto batch_count = (this->get_worker_count() + 1) * 4;
+          batch_size = std::max(usize{1}, (count + batch_count - 1) / batch_count);
+        }
+
+        // run small ranges inline rather than paying for a job
+        if (!this->is_initialized || count <= batch_size) {
+          for (auto i = usize{0}; i < count; ++i) {
+            fn(i);
+          }
+
+          return;
+        }
+
+        auto counter = Counter{};
+
+        for (auto begin = usize{0}; begin < count; begin += batch_size) {
+          const auto end = std::min(begin + batch_size, count);
+
+          this->submit(
+              [&fn, begin, end]() {
+                for (auto i = begin; i < end; ++i) {
+                  fn(i);
+                }
+              },
+              &counter);
+        }
+
+        this->wait(counter);
+      }
+
+      /**
+       * Returns the number of worker threads, excluding the main thread.
+       *
+       * @return The number of worker threads.
+       */
+      auto get_worker_count() const -> usize;
+
+    private:
+      /**
+       * Encapsulates a queued job.
+       */
+      struct QueuedJob {
+        /** The job to run. */
+        Job job = {};
+        /** The counter the job is attached to, if any. */
+        Counter *counter = nullptr;
+        /** The counters that must reach zero before the job runs. */
+        Dependencies dependencies = {};
+
+        /**
+         * Returns if every dependency of the job has finished.
+         *
+         * @return True if the job can run.
+         */
+        auto is_ready() const -> bool;
+      };
+
+      /**
+       * A job queue owned by a single thread. The owner pushes and pops the
+       * back while other threads steal from the front.
+       */
+      struct Queue {
+        /** The queued jobs. */
+        std::deque<QueuedJob> jobs = {};
+        /** Guards the queued jobs. */
+        std::mutex mutex = {};
+      };
+
+      /**
+       * Runs a single ready job, preferring the calling thread's own queue
+       * before stealing from the others.
+       *
+       * @return True if a job was run.
+       */
+      auto try_run_job() -> bool;
+
+      /**
+       * Takes a ready job from the specified queue.
+       *
+       * @param queue The queue to take from.
+       * @param is_owner Is the calling thread the owner of the queue?
+       * @param job The taken job.
+       * @return True if a job was taken.
+       */
+      static auto take_job(Queue &queue, bool is_owner, QueuedJob &job) -> bool;
+
+      /**
+       * Wakes sleeping threads, as a job may have become ready to run.
+       *
+       * @param is_waking_all Wake every thread rather than one.
+       */
+      auto wake(bool is_waking_all) -> void;
+
+      /**
+       * The worker thread loop, runs jobs until the manager is destroyed.
+       *
+       * @param index The index of the worker's queue.
+       */
+      auto work(usize index) -> void;
+
+      /** The index of the calling thread's queue, the main thread uses 0. */
+      inline static thread_local usize queue_index = 0;
+
+      /** Is the job manager initialized? */
+      bool is_initialized = false;
+      /** The job queues, the first belongs to the main thread. */
+      std::vector<std::unique_ptr<Queue>> queues = {};
+      /** The worker threads. */
+      std::vector<std::thread> workers = {};
+      /** The number of queued jobs across all queues. */
+      std::atomic<usize> queued_count = {};
+      /**
+       * The number of times sleeping threads have been woken. Threads only
+       * sleep until it changes, as jobs blocked on dependencies can't run until
+       * a new job is queued or a counter reaches zero.
+       */
+      std::atomic<usize> wake_count = {};
+      /** Guards sleeping threads. */
+      std::mutex sleep_mutex = {};
+      /** Signals sleeping threads that a job may be ready to run. */
+      std::condition_variable job_available = {};
+      /** Are the workers being shut down? */
+      std::atomic<bool> is_stopping = false;
+    };
+  }
+}
@@ -0,0 +1,344 @@
+#include "afk/physics/AabbTree.hpp"
+
+#include <algorithm>
+
+using afk::physics::Aabb;
+using afk::physics::AabbTree;
+
+/**
+ * Returns the smallest box holding two boxes.
+ *
+ * @param lhs The first box.
+ * @param rhs The second box.
+ * @return The combined box.
+ */
+static auto get_union(const Aabb &lhs, const Aabb &rhs) -> Aabb {
+  return Aabb{glm::min(lhs.min, rhs.min), glm::max(lhs.max, rhs.max)};
+}
+
+/**
+ * Returns the surface area of a box, which is proportional to the chance a
+ * random ray crosses it.
+ *
+ * @param bounds The box.
+ * @return The surface area.
+ */
+static auto get_surface_area(const Aabb &bounds) -> f32 {
+  const auto size = bounds.max - bounds.min;
+
+  return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+/**
+ * Returns if a box is entirely inside another.
+ *
+ * @param outer The outer box.
+ * @param inner The inner box.
+ * @return If the inner box is inside the outer box.
+ */
+static auto is_containing(const Aabb &outer, const Aabb &inner) -> bool {
+  return glm::all(glm::lessThanEqual(outer.min, inner.min)) &&
+         glm::all(glm::lessThanEqual(inner.max, outer.max));
+}
+
+auto AabbTree::insert(const Aabb &bounds, usize data) -> i32 {
+  const auto proxy = this->allocate_node();
+  auto &leaf       = this->get_node(proxy);
+  const auto fat   = glm::vec3{this->fat_margin};
+
+  leaf.bounds = Aabb{bounds.min - fat, bounds.max + fat};
+  leaf.data   = data;
+  leaf.height = 0;
+
+  this->insert_leaf(proxy);
+  ++this->proxy_count;
+
+  return proxy;
+}
+
+auto AabbTree::remove(i32 proxy) -> void {
+  afk_assert(this->get_node(proxy).is_leaf(), "AABB tree proxy is not a leaf");
+
+  this->remove_leaf(proxy);
+  this->free_node(proxy);
+  --this->proxy_count;
+}
+
+auto AabbTree::move(i32 proxy, const Aabb &bounds) -> bool {
+  afk_assert(this->get_node(proxy).is_leaf(), "AABB tree proxy is not a leaf");
+
+  ++this->refit_count;
+
+  // most boxes barely move between steps, so they're still inside their leaf
+  if (is_containing(this->get_node(proxy).bounds, bounds)) {
+    return false;
+  }
+
+  this->remove_leaf(proxy);
+
+  const auto fat               = glm::vec3{this->fat_margin};
+  this->get_node(proxy).bounds = Aabb{bounds.min - fat, bounds.max + fat};
+
+  this->insert_leaf(proxy);
+  ++this->reinsert_count;
+
+  return true;
+}
+
+auto AabbTree::get_data(i32 proxy) const -> usize {
+  return this->nodes[static_cast<usize>(proxy)].data;
+}
+
+auto AabbTree::get_fat_bounds(i32 proxy) const -> const Aabb & {
+  return this->nodes[static_cast<usize>(proxy)].bounds;
+}
+
+auto AabbTree::set_fat_margin(f32 fat_margin) -> void {
+  afk_assert(fat_margin >= 0.0f, "AABB tree fat margin must not be negative");
+
+  this->fat_margin = fat_margin;
+}
+
+auto AabbTree::get_fat_margin() const -> f32 {
+  return this->fat_margin;
+}
+
+auto AabbTree::get_stats() const -> Stats {
+  auto stats = Stats{};
+
+  stats.proxy_count    = this->proxy_count;
+  stats.node_count     = this->node_count;
+  stats.refit_count    = this->refit_count;
+  stats.reinsert_count = this->reinsert_count;
+  stats.rotation_count = this->rotation_count;
+
+  if (this->root == AabbTree::NULL_NODE) {
+    return stats;
+  }
+
+  const auto &root_node = this->nodes[static_cast<usize>(this->root)];
+  stats.height          = root_node.height;
+
+  // only nodes in use have a height, leaves are 0 and free nodes are -1
+  auto total_area = 0.0f;
+
+  for (const auto &node : this->nodes) {
+    if (node.height >= 0) {
+      total_area += get_surface_area(node.bounds);
+    }
+  }
+
+  const auto root_area = get_surface_area(root_node.bounds);
+  stats.area_ratio     = root_area > 0.0f ? total_area / root_area : 0.0f;
+
+  return stats;
+}
+
+auto AabbTree::allocate_node() -> i32 {
+  auto index = this->free_list;
+
+  if (index == AabbTree::NULL_NODE) {
+    index = static_cast<i32>(this->nodes.size());
+    this->nodes.emplace_back();
+  } else {
+    this->free_list = this->get_node(index).parent;
+  }
+
+  this->get_node(index) = Node{};
+  ++this->node_count;
+
+  return index;
+}
+
+auto AabbTree::free_node(i32 index) -> void {
+  auto &node  = this->get_node(index);
+  node.parent = this->free_list;
+  node.height = -1;
+
+  this->free_list = index;
+  --this->node_count;
+}
+
+auto AabbTree::insert_leaf(i32 leaf) -> void {
+  if (this->root == AabbTree::NULL_NODE) {
+    this->root                  = leaf;
+    this->get_node(leaf).parent = AabbTree::NULL_NODE;
+    return;
+  }
+
+  const auto bounds = this->get_node(leaf).bounds;
+
+  // descend towards the sibling that adds the least surface area, the
+  // surface area heuristic, stopping when pairing with the node itself is
+  // cheaper than going any further down
+  auto index = this->root;
+
+  while (!this->get_node(index).is_leaf()) {
+    const auto &node = this->get_node(index);
+
+    const auto area          = get_surface_area(node.bounds);
+    const auto combined_area = get_surface_area(get_union(node.bounds, bounds));
+
+    // pairing with this node makes a new parent with the combined area, and
+    // going further down grows this node and every node above it anyway
+    const auto cost        = 2.0f * combined_area;
+    const auto inheritance = 2.0f * (combined_area - area);
+
+    const auto get_cost = [&](i32 child_index) {
+      const auto &child = this->get_node(child_index);
+      const auto grown  = get_surface_area(get_union(child.bounds, bounds));
+
+      return child.is_leaf() ? grown + inheritance
+                             : grown - get_surface_area(child.bounds) + inheritance;
+    };
+
+    const auto left_cost  = get_cost(node.left);
+    const auto right_cost = get_cost(node.right);
+
+    if (cost < left_cost && cost < right_cost) {
+      break;
+    }
+
+    index = left_cost < right_cost ? node.left : node.right;
+  }
+
+  // the new parent is allocated before taking any references, as it may grow the pool
+  const auto sibling    = index;
+  const auto new_parent = this->allocate_node();
+  const auto old_parent = this->get_node(sibling).parent;
+
+  auto &parent  = this->get_node(new_parent);
+  parent.parent = old_parent;
+  parent.bounds = get_union(bounds, this->get_node(sibling).bounds);
+  parent.height = this->get_node(sibling).height + 1;
+  parent.left   = sibling;
+  parent.right  = leaf;
+
+  if (old_parent == AabbTree::NULL_NODE) {
+    this->root = new_parent;
+  } else if (this->get_node(old_parent).left == sibling) {
+    this->get_node(old_parent).left = new_parent;
+  } else {
+    this->get_node(old_parent).right = new_parent;
+  }
+
+  this->get_node(sibling).parent = new_parent;
+  this->get_node(leaf).parent    = new_parent;
+
+  this->refit_upwards(new_parent);
+}
+
+auto AabbTree::remove_leaf(i32 leaf) -> void {
+  if (leaf == this->root) {
+    this->root = AabbTree::NULL_NODE;
+    return;
+  }
+
+  const auto parent      = this->get_node(leaf).parent;
+  const auto grandparent = this->get_node(parent).parent;
+  const auto sibling     = this->get_node(parent).left == leaf ? this->get_node(parent).right
+                                                               : this->get_node(parent).left;
+
+  // the sibling takes the parent's place
+  this->free_node(parent);
+  this->get_node(sibling).parent = grandparent;
+
+  if (grandparent == AabbTree::NULL_NODE) {
+    this->root = sibling;
+    return;
+  }
+
+  if (this->get_node(grandparent).left == parent) {
+    this->get_node(grandparent).left = sibling;
+  } else {
+    this->get_node(grandparent).right = sibling;
+  }
+
+  this->refit_upwards(grandparent);
+}
+
+auto AabbTree::refit_upwards(i32 index) -> void {
+  while (index != AabbTree::NULL_NODE) {
+    index = this->balance(index);
+
+    auto &node        = this->get_node(index);
+    const auto &left  = this->get_node(node.left);
+    const auto &right = this->get_node(node.right);
+
+    node.height = 1 + std::max(left.height, right.height);
+    node.bounds = get_union(left.bounds, right.bounds);
+
+    index = node.parent;
+  }
+}
+
+auto AabbTree::balance(i32 index) -> i32 {
+  auto &a = this->get_node(index);
+
+  if (a.is_leaf() || a.height < 2) {
+    return index;
+  }
+
+  const auto b_index = a.left;
+  const auto c_index = a.right;
+  auto &b            = this->get_node(b_index);
+  auto &c            = this->get_node(c_index);
+  const auto skew    = c.height - b.height;
+
+  if (skew >= -1 && skew <= 1) {
+    return index;
+  }
+
+  // the taller child is rotated up into a's place, and a keeps the shorter
+  // of that child's children, so the subtree is at most one level uneven
+  const auto up_index    = skew > 1 ? c_index : b_index;
+  auto &up               = skew > 1 ? c : b;
+  const auto &other      = skew > 1 ? b : c;
+  const auto f_index     = up.left;
+  const auto g_index     = up.right;
+  auto &f                = this->get_node(f_index);
+  auto &g                = this->get_node(g_index);
+  const auto is_f_taller = f.height > g.height;
+  const auto kept_index  = is_f_taller ? f_index : g_index;
+  const auto moved_index = is_f_taller ? g_index : f_index;
+  auto &kept             = is_f_taller ? f : g;
+  auto &moved            = is_f_taller ? g : f;
+
+  up.left   = index;
+  up.parent = a.parent;
+  a.parent  = up_index;
+
+  if (up.parent == AabbTree::NULL_NODE) {
+    this->root = up_index;
+  } else if (this->get_node(up.parent).left == index) {
+    this->get_node(up.parent).left = up_index;
+  } else {
+    this->get_node(up.parent).right = up_index;
+  }
+
+  // the moved grandchild takes the place of the child that was rotated up
+  up.right     = kept_index;
+  moved.parent = index;
+
+  if (skew > 1) {
+    a.right = moved_index;
+  } else {
+    a.left = moved_index;
+  }
+
+  a.bounds  = get_union(other.bounds, moved.bounds);
+  a.height  = 1 + std::max(other.height, moved.height);
+  up.bounds = get_union(a.bounds, kept.bounds);
+  up.height = 1 + std::max(a.height, kept.height);
+
+  ++this->rotation_count;
+
+  return up_index;
+}
+
+auto AabbTree::get_node(i32 index) -> Node & {
+  afk_assert_debug(index >= 0 && static_cast<usize>(index) < this->nodes.size(),
+                   "AABB tree node out of range");
+
+  return this->nodes[static_cast<usize>(index)];
+}
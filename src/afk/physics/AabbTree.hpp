@@ -0,0 +1,324 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/debug/Assert.hpp"
+#include "afk/physics/Geometry.hpp"
+
+namespace afk {
+  namespace physics {
+    /**
+     * A dynamic bounding volume hierarchy of bounding boxes, used to find
+     * which boxes overlap a box or are crossed by a line segment without
+     * testing every one of them.
+     *
+     * Each box is stored in a leaf grown by the tree's fat margin, so a box
+     * that moves a little stays inside its leaf and only needs its leaf
+     * checked. Boxes that leave their leaf are removed and reinserted where
+     * they add the least surface area, and the tree is rotated on the way
+     * back up so no branch is more than one level taller than its sibling.
+     *
+     * Nodes are kept in a pool and reused, so a box's proxy stays the same
+     * for as long as it's in the tree. The tree is safe to query from any
+     * number of threads as long as nothing changes it at the same time.
+     */
+    class AabbTree {
+    public:
+      /** The proxy of a box that isn't in the tree. */
+      static constexpr i32 NULL_NODE = -1;
+
+      /** How far each leaf's box is grown past the box it holds by default, in world units. */
+      static constexpr f32 DEFAULT_FAT_MARGIN = 0.1f;
+
+      /** How deep a traversal can go, far more than a balanced tree ever needs. */
+      static constexpr usize STACK_SIZE = 64;
+
+      /**
+       * Statistics on the shape of the tree and the cost of keeping it up to
+       * date, counted from when the tree was created.
+       */
+      struct Stats {
+        /** The number of levels below the root, zero if there's at most one box. */
+        i32 height = {};
+        /** The number of boxes. */
+        usize proxy_count = {};
+        /** The number of nodes in use, including internal nodes. */
+        usize node_count = {};
+        /**
+         * The total surface area of every node in use over the root's, lower
+         * means fewer nodes are visited by each traversal.
+         */
+        f32 area_ratio = {};
+        /** The number of times a box has been moved. */
+        usize refit_count = {};
+        /** The number of moved boxes that left their leaf, so were reinserted. */
+        usize reinsert_count = {};
+        /** The number of rotations done to keep the tree balanced. */
+        usize rotation_count = {};
+      };
+
+      /**
+       * Adds a box to the tree.
+       *
+       * @param bounds The box.
+       * @param data The value to report when the box is found.
+       * @return The box's proxy, used to move or remove it.
+       */
+      auto insert(const Aabb &bounds, usize data) -> i32;
+
+      /**
+       * Removes a box from the tree.
+       *
+       * @param proxy The box's proxy.
+       */
+      auto remove(i32 proxy) -> void;
+
+      /**
+       * Moves a box, reinserting it only if it has left its leaf.
+       *
+       * @param proxy The box's proxy.
+       * @param bounds The box's new bounds.
+       * @return If the box was reinserted.
+       */
+      auto move(i32 proxy, const Aabb &bounds) -> bool;
+
+      /**
+       * Returns the value a box was inserted with.
+       *
+       * @param proxy The box's proxy.
+       * @return The value.
+       */
+      auto get_data(i32 proxy) const -> usize;
+
+      /**
+       * Returns the grown box stored in a box's leaf.
+       *
+       * @param proxy The box's proxy.
+       * @return The grown box.
+       */
+      auto get_fat_bounds(i32 proxy) const -> const Aabb &;
+
+      /**
+       * Sets how far each leaf's box is grown past the box it holds. A larger
+       * margin means fewer reinserts for moving boxes, but looser leaves and
+       * more false overlaps. Boxes already in the tree keep their leaf until
+       * they're next reinserted.
+       *
+       * @param fat_margin The margin, in world units.
+       */
+      auto set_fat_margin(f32 fat_margin) -> void;
+
+      /**
+       * Returns how far each leaf's box is grown past the box it holds.
+       *
+       * @return The margin, in world units.
+       */
+      auto get_fat_margin() const -> f32;
+
+      /**
+       * Returns statistics on the tree.
+       *
+       * @return The statistics.
+       */
+      auto get_stats() const -> Stats;
+
+      /**
+       * Calls a function with the value of every box whose leaf overlaps the
+       * specified box.
+       *
+       * @param bounds The box to test.
+       * @param fn The function to call, returning false to stop.
+       */
+      template<typename Fn>
+      auto query(const Aabb &bounds, Fn &&fn) const -> void {
+        auto stack = std::array<i32, AabbTree::STACK_SIZE>{};
+        auto count = usize{0};
+
+        if (this->root != AabbTree::NULL_NODE) {
+          stack[count++] = this->root;
+        }
+
+        while (count > 0) {
+          const auto &node = this->nodes[static_cast<usize>(stack[--count])];
+
+          if (!afk::physics::is_overlapping(node.bounds, bounds)) {
+            continue;
+          }
+
+          if (node.is_leaf()) {
+            if (!fn(node.data)) {
+              return;
+            }
+
+            continue;
+          }
+
+          afk_assert_debug(count + 2 <= AabbTree::STACK_SIZE, "AABB tree is too deep");
+          stack[count++] = node.left;
+          stack[count++] = node.right;
+        }
+      }
+
+      /**
+       * Calls a function with the value of every box whose leaf is crossed by
+       * a line segment, in no particular order.
+       *
+       * The function returns the fraction along the segment past which boxes
+       * no longer need to be found, such as the fraction of the closest hit so
+       * far, so the rest of the segment is skipped. Returning a negative
+       * fraction stops the traversal.
+       *
+       * @param from The start of the segment.
+       * @param to The end of the segment.
+       * @param padding How far to grow each box on each axis before testing it,
+       *                such as the radius of a sphere swept along the segment.
+       * @param fn The function to call.
+       */
+      template<typename Fn>
+      auto raycast(const glm::vec3 &from, const glm::vec3 &to, const glm::vec3 &padding,
+                   Fn &&fn) const -> void {
+        auto stack        = std::array<i32, AabbTree::STACK_SIZE>{};
+        auto count        = usize{0};
+        auto max_fraction = 1.0f;
+
+        if (this->root != AabbTree::NULL_NODE) {
+          stack[count++] = this->root;
+        }
+
+        while (count > 0) {
+          const auto &node  = this->nodes[static_cast<usize>(stack[--count])];
+          const auto bounds = Aabb{node.bounds.min - padding, node.bounds.max + padding};
+          const auto entry  = afk::physics::intersect_segment(from, to, bounds);
+
+          if (!entry.has_value() || *entry > max_fraction) {
+            continue;
+          }
+
+          if (node.is_leaf()) {
+            max_fraction = fn(node.data);
+
+            if (max_fraction < 0.0f) {
+              return;
+            }
+
+            continue;
+          }
+
+          afk_assert_debug(count + 2 <= AabbTree::STACK_SIZE, "AABB tree is too deep");
+          stack[count++] = node.left;
+          stack[count++] = node.right;
+        }
+      }
+
+    private:
+      /** A node of the tree, either a leaf holding a box or the parent of two nodes. */
+      struct Node {
+        /** The box holding every box below the node, grown by the fat margin for leaves. */
+        Aabb bounds = {};
+        /** The value the box was inserted with, for leaves. */
+        usize data = {};
+        /** The parent, or the next free node if the node isn't in use. */
+        i32 parent = AabbTree::NULL_NODE;
+        /** The first child, NULL_NODE for leaves. */
+        i32 left = AabbTree::NULL_NODE;
+        /** The second child, NULL_NODE for leaves. */
+        i32 right = AabbTree::NULL_NODE;
+        /** The number of levels below the node, zero for leaves and -1 if the node isn't in use. */
+        i32 height = -1;
+
+        /**
+         * Returns if the node is a leaf.
+         *
+         * @return If the node is a leaf.
+         */
+        auto is_leaf() const -> bool {
+          return this->left == AabbTree::NULL_NODE;
+        }
+      };
+
+      /**
+       * Takes a node from the free list, growing the pool if there are none.
+       *
+       * @return The node, which is a leaf with no parent.
+       */
+      auto allocate_node() -> i32;
+
+      /**
+       * Returns a node to the free list.
+       *
+       * @param index The node.
+       */
+      auto free_node(i32 index) -> void;
+
+      /**
+       * Links a leaf into the tree next to the node where it adds the least
+       * surface area.
+       *
+       * @param leaf The leaf.
+       */
+      auto insert_leaf(i32 leaf) -> void;
+
+      /**
+       * Unlinks a leaf from the tree, freeing its parent.
+       *
+       * @param leaf The leaf.
+       */
+      auto remove_leaf(i32 leaf) -> void;
+
+      /**
+       * Balances and refits every node from the specified node up to the root.
+       *
+       * @param index The first node.
+       */
+      auto refit_upwards(i32 index) -> void;
+
+      /**
+       * Rotates a node's taller child above it if its children's heights
+       * differ by more than one.
+       *
+       * @param index The node.
+       * @return The node now in the node's place.
+       */
+      auto balance(i32 index) -> i32;
+
+      /**
+       * Returns the node at the specified index.
+       *
+       * @param index The node's index.
+       * @return The node.
+       */
+      auto get_node(i32 index) -> Node &;
+
+      /** Every node, including free nodes. */
+      std::vector<Node> nodes = {};
+
+      /** The root node. */
+      i32 root = AabbTree::NULL_NODE;
+
+      /** The first free node. */
+      i32 free_list = AabbTree::NULL_NODE;
+
+      /** How far each leaf's box is grown past the box it holds. */
+      f32 fat_margin = AabbTree::DEFAULT_FAT_MARGIN;
+
+      /** The number of boxes. */
+      usize proxy_count = {};
+
+      /** The number of nodes in use. */
+      usize node_count = {};
+
+      /** The number of times a box has been moved. */
+      usize refit_count = {};
+
+      /** The number of moved boxes that were reinserted. */
+      usize reinsert_count = {};
+
+      /** The number of rotations done. */
+      usize rotation_count = {};
+    };
+  }
+}
@@ -0,0 +1,365 @@
+#include "afk/physics/BodyBatch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "afk/debug/Profiler.hpp"
+#include "afk/ecs/component/ColliderComponent.hpp"
+#include "afk/ecs/component/PhysicsComponent.hpp"
+#include "afk/ecs/component/TransformComponent.hpp"
+#include "afk/physics/Lanes.hpp"
+
+using afk::ecs::Entity;
+using afk::ecs::Registry;
+using afk::ecs::component::ColliderComponent;
+using afk::ecs::component::PhysicsComponent;
+using afk::ecs::component::TransformComponent;
+using afk::job::JobManager;
+using afk::physics::BodyBatch;
+
+BodyBatch::BodyBatch(JobManager &job_manager) : job_manager(job_manager) {}
+
+auto BodyBatch::sync(Registry &registry) -> void {
+  afk_profile_scope("BodyBatch::sync");
+
+  const auto is_integrated = [&registry](Entity entity) {
+    if (!registry.valid(entity) ||
+        !registry.has<ColliderComponent, PhysicsComponent, TransformComponent>(entity)) {
+      return false;
+    }
+
+    const auto &physics = registry.get<PhysicsComponent>(entity);
+
+    return !physics.is_static && !physics.is_sleeping;
+  };
+
+  // walk backwards, so the body moved into a removed slot has already been checked
+  for (auto slot = this->entities.size(); slot-- > 0;) {
+    if (!is_integrated(this->entities[slot])) {
+      this->remove(registry, slot);
+    }
+  }
+
+  const auto view =
+      registry.view<const ColliderComponent, const PhysicsComponent, const TransformComponent>();
+
+  for (const auto entity : view) {
+    const auto &physics = view.get<const PhysicsComponent>(entity);
+
+    if (!physics.is_static && !physics.is_sleeping && !this->contains(registry, entity)) {
+      this->add(registry, entity);
+    }
+  }
+
+  for (const auto entity : this->dirty_entities) {
+    if (registry.valid(entity) && registry.has<PhysicsComponent>(entity) &&
+        this->contains(registry, entity)) {
+      this->load_transform(registry, registry.get<PhysicsComponent>(entity).batch_slot);
+    }
+  }
+
+  this->dirty_entities.clear();
+}
+
+auto BodyBatch::set_transform_dirty(Entity entity) -> void {
+  this->dirty_entities.push_back(entity);
+}
+
+auto BodyBatch::integrate_velocities(f32 dt, const glm::vec3 &gravity) -> void {
+  afk_profile_scope("BodyBatch::integrate_velocities");
+
+  // most bodies share the same dampening, so only call pow when it changes
+  auto *linear_dampening  = this->get_stream(BodyBatch::LINEAR_DAMPENING);
+  auto *angular_dampening = this->get_stream(BodyBatch::ANGULAR_DAMPENING);
+  auto last_dampening     = glm::vec2{-1.0f};
+  auto last_factor        = glm::vec2{0.0f};
+
+  for (auto i = usize{0}; i < this->dampenings.size(); ++i) {
+    const auto dampening = this->dampenings[i];
+
+    if (dampening != last_dampening) {
+      last_dampening = dampening;
+      last_factor    = glm::vec2{std::clamp(std::pow(1.0f - dampening.x, dt), 0.0f, 1.0f),
+                              std::clamp(std::pow(1.0f - dampening.y, dt), 0.0f, 1.0f)};
+    }
+
+    linear_dampening[i]  = last_factor.x;
+    angular_dampening[i] = last_factor.y;
+  }
+
+  this->job_manager.parallel_for(this->get_lane_count(), [&](usize lane) {
+    const auto first  = lane * BodyBatch::LANE_WIDTH;
+    const auto stream = [&](Stream s) { return this->get_stream(s) + first; };
+
+    // semi-implicit euler, so the velocity is integrated before the position
+    // external forces is just force, so need to divide mass out (a = F/m)
+    const auto inverse_mass   = load(stream(BodyBatch::INVERSE_MASS));
+    const auto linear_factor  = load(stream(BodyBatch::LINEAR_DAMPENING));
+    const auto angular_factor = load(stream(BodyBatch::ANGULAR_DAMPENING));
+    const auto gravity_dt     = gravity * dt;
+
+    for (auto axis = usize{0}; axis < 3; ++axis) {
+      const auto offset = [&](Stream x) { return stream(static_cast<Stream>(x + axis)); };
+
+      auto *linear_velocity    = offset(BodyBatch::LINEAR_VELOCITY_X);
+      auto *angular_velocity   = offset(BodyBatch::ANGULAR_VELOCITY_X);
+      const auto gravity_lanes = splat(gravity_dt[static_cast<glm::vec3::length_type>(axis)]);
+      const auto force         = load(offset(BodyBatch::EXTERNAL_FORCE_X));
+      const auto torque        = load(offset(BodyBatch::EXTERNAL_TORQUE_X));
+
+      store(linear_velocity,
+            (load(linear_velocity) + gravity_lanes + inverse_mass * force) * linear_factor);
+      store(angular_velocity, (load(angular_velocity) + torque) * angular_factor);
+    }
+
+    // rotate the local inverse inertia tensor into world space, the same as
+    // scaling each column of the rotation matrix by it
+    const auto w   = load(stream(BodyBatch::ROTATION_W));
+    const auto x   = load(stream(BodyBatch::ROTATION_X));
+    const auto y   = load(stream(BodyBatch::ROTATION_Y));
+    const auto z   = load(stream(BodyBatch::ROTATION_Z));
+    const auto ix  = load(stream(BodyBatch::LOCAL_INVERSE_INERTIA_X));
+    const auto iy  = load(stream(BodyBatch::LOCAL_INVERSE_INERTIA_Y));
+    const auto iz  = load(stream(BodyBatch::LOCAL_INVERSE_INERTIA_Z));
+    const auto one = splat(1.0f);
+    const auto two = splat(2.0f);
+
+    const auto xx = x * x;
+    const auto yy = y * y;
+    const auto zz = z * z;
+    const auto xy = x * y;
+    const auto xz = x * z;
+    const auto yz = y * z;
+    const auto wx = w * x;
+    const auto wy = w * y;
+    const auto wz = w * z;
+
+    store(stream(BodyBatch::INVERSE_INERTIA_00), (one - two * (yy + zz)) * ix);
+    store(stream(BodyBatch::INVERSE_INERTIA_01), two * (xy + wz) * ix);
+    store(stream(BodyBatch::INVERSE_INERTIA_02), two * (xz - wy) * ix);
+    store(stream(BodyBatch::INVERSE_INERTIA_10), two * (xy - wz) * iy);
+    store(stream(BodyBatch::INVERSE_INERTIA_11), (one - two * (xx + zz)) * iy);
+    store(stream(BodyBatch::INVERSE_INERTIA_12), two * (yz + wx) * iy);
+    store(stream(BodyBatch::INVERSE_INERTIA_20), two * (xz + wy) * iz);
+    store(stream(BodyBatch::INVERSE_INERTIA_21), two * (yz - wx) * iz);
+    store(stream(BodyBatch::INVERSE_INERTIA_22), (one - two * (xx + yy)) * iz);
+  });
+}
+
+auto BodyBatch::integrate_positions(f32 dt) -> void {
+  afk_profile_scope("BodyBatch::integrate_positions");
+
+  this->job_manager.parallel_for(this->get_lane_count(), [&](usize lane) {
+    const auto first  = lane * BodyBatch::LANE_WIDTH;
+    const auto stream        = [&](Stream s) { return this->get_stream(s) + first; };
+    const auto dt_lanes      = splat(dt);
+    const auto half_dt_lanes = splat(0.5f * dt);
+
+    const auto vx = load(stream(BodyBatch::LINEAR_VELOCITY_X));
+    const auto vy = load(stream(BodyBatch::LINEAR_VELOCITY_Y));
+    const auto vz = load(stream(BodyBatch::LINEAR_VELOCITY_Z));
+
+    auto *tx = stream(BodyBatch::TRANSLATION_X);
+    auto *ty = stream(BodyBatch::TRANSLATION_Y);
+    auto *tz = stream(BodyBatch::TRANSLATION_Z);
+
+    store(tx, load(tx) + vx * dt_lanes);
+    store(ty, load(ty) + vy * dt_lanes);
+    store(tz, load(tz) + vz * dt_lanes);
+
+    // q += (0, w) * q * dt / 2
+    const auto ax = load(stream(BodyBatch::ANGULAR_VELOCITY_X));
+    const auto ay = load(stream(BodyBatch::ANGULAR_VELOCITY_Y));
+    const auto az = load(stream(BodyBatch::ANGULAR_VELOCITY_Z));
+    const auto w  = load(stream(BodyBatch::ROTATION_W));
+    const auto x  = load(stream(BodyBatch::ROTATION_X));
+    const auto y  = load(stream(BodyBatch::ROTATION_Y));
+    const auto z  = load(stream(BodyBatch::ROTATION_Z));
+
+    const auto new_w = w - (ax * x + ay * y + az * z) * half_dt_lanes;
+    const auto new_x = x + (ax * w + ay * z - az * y) * half_dt_lanes;
+    const auto new_y = y + (ay * w + az * x - ax * z) * half_dt_lanes;
+    const auto new_z = z + (az * w + ax * y - ay * x) * half_dt_lanes;
+
+    // the rotations are kept between steps, so each step's error would otherwise build up
+    const auto inverse_length =
+        splat(1.0f) / sqrt(new_w * new_w + new_x * new_x + new_y * new_y + new_z * new_z);
+
+    store(stream(BodyBatch::ROTATION_W), new_w * inverse_length);
+    store(stream(BodyBatch::ROTATION_X), new_x * inverse_length);
+    store(stream(BodyBatch::ROTATION_Y), new_y * inverse_length);
+    store(stream(BodyBatch::ROTATION_Z), new_z * inverse_length);
+  });
+}
+
+auto BodyBatch::load_velocities(const Registry &registry) -> void {
+  afk_profile_scope("BodyBatch::load_velocities");
+
+  this->job_manager.parallel_for(this->entities.size(), [&](usize i) {
+    const auto &physics = registry.get<PhysicsComponent>(this->entities[i]);
+
+    this->get_stream(BodyBatch::LINEAR_VELOCITY_X)[i]  = physics.linear_velocity.x;
+    this->get_stream(BodyBatch::LINEAR_VELOCITY_Y)[i]  = physics.linear_velocity.y;
+    this->get_stream(BodyBatch::LINEAR_VELOCITY_Z)[i]  = physics.linear_velocity.z;
+    this->get_stream(BodyBatch::ANGULAR_VELOCITY_X)[i] = physics.angular_velocity.x;
+    this->get_stream(BodyBatch::ANGULAR_VELOCITY_Y)[i] = physics.angular_velocity.y;
+    this->get_stream(BodyBatch::ANGULAR_VELOCITY_Z)[i] = physics.angular_velocity.z;
+    this->get_stream(BodyBatch::EXTERNAL_FORCE_X)[i]   = physics.external_forces.x;
+    this->get_stream(BodyBatch::EXTERNAL_FORCE_Y)[i]   = physics.external_forces.y;
+    this->get_stream(BodyBatch::EXTERNAL_FORCE_Z)[i]   = physics.external_forces.z;
+    this->get_stream(BodyBatch::EXTERNAL_TORQUE_X)[i]  = physics.external_torques.x;
+    this->get_stream(BodyBatch::EXTERNAL_TORQUE_Y)[i]  = physics.external_torques.y;
+    this->get_stream(BodyBatch::EXTERNAL_TORQUE_Z)[i]  = physics.external_torques.z;
+  });
+}
+
+auto BodyBatch::store_velocities(Registry &registry) const -> void {
+  afk_profile_scope("BodyBatch::store_velocities");
+
+  this->job_manager.parallel_for(this->entities.size(), [&](usize i) {
+    auto &physics  = registry.get<PhysicsComponent>(this->entities[i]);
+    const auto get = [&](Stream stream) { return this->get_stream(stream)[i]; };
+
+    physics.linear_velocity  = glm::vec3{get(BodyBatch::LINEAR_VELOCITY_X),
+                                        get(BodyBatch::LINEAR_VELOCITY_Y),
+                                        get(BodyBatch::LINEAR_VELOCITY_Z)};
+    physics.angular_velocity = glm::vec3{get(BodyBatch::ANGULAR_VELOCITY_X),
+                                         get(BodyBatch::ANGULAR_VELOCITY_Y),
+                                         get(BodyBatch::ANGULAR_VELOCITY_Z)};
+
+    for (auto column = usize{0}; column < 3; ++column) {
+      for (auto row = usize{0}; row < 3; ++row) {
+        const auto stream = static_cast<Stream>(BodyBatch::INVERSE_INERTIA_00 + column * 3 + row);
+        physics.inverse_inertial_tensor[static_cast<glm::mat3::length_type>(column)]
+                                       [static_cast<glm::vec3::length_type>(row)] = get(stream);
+      }
+    }
+
+    // reset external forces and torque for the next update cycle
+    // these only represent "moments" in acceleration
+    physics.external_forces  = glm::vec3{0.0f};
+    physics.external_torques = glm::vec3{0.0f};
+  });
+}
+
+auto BodyBatch::store_transforms(Registry &registry) const -> void {
+  afk_profile_scope("BodyBatch::store_transforms");
+
+  this->job_manager.parallel_for(this->entities.size(), [&](usize i) {
+    auto &transform = registry.get<TransformComponent>(this->entities[i]);
+    const auto get  = [&](Stream stream) { return this->get_stream(stream)[i]; };
+
+    transform.translation = glm::vec3{get(BodyBatch::TRANSLATION_X), get(BodyBatch::TRANSLATION_Y),
+                                      get(BodyBatch::TRANSLATION_Z)};
+    transform.rotation    = glm::quat{get(BodyBatch::ROTATION_W), get(BodyBatch::ROTATION_X),
+                                   get(BodyBatch::ROTATION_Y), get(BodyBatch::ROTATION_Z)};
+  });
+}
+
+auto BodyBatch::get_count() const -> usize {
+  return this->entities.size();
+}
+
+auto BodyBatch::get_entities() const -> const std::vector<Entity> & {
+  return this->entities;
+}
+
+auto BodyBatch::add(Registry &registry, Entity entity) -> void {
+  const auto slot = this->entities.size();
+
+  // double the capacity, moving each array along to its new offset
+  if (slot == this->capacity) {
+    const auto capacity = std::max(this->capacity * 2, BodyBatch::LANE_WIDTH);
+    auto streams        = std::vector<f32>(capacity * BodyBatch::STREAM_COUNT);
+
+    for (auto stream = usize{0}; stream < BodyBatch::STREAM_COUNT; ++stream) {
+      std::copy_n(this->streams.data() + stream * this->capacity, this->capacity,
+                  streams.data() + stream * capacity);
+    }
+
+    this->streams  = std::move(streams);
+    this->capacity = capacity;
+
+    for (auto i = slot; i < capacity; ++i) {
+      this->clear(i);
+    }
+  }
+
+  auto &physics      = registry.get<PhysicsComponent>(entity);
+  physics.batch_slot = slot;
+  this->entities.push_back(entity);
+  this->dampenings.push_back(glm::vec2{physics.linear_dampening, physics.angular_dampening});
+
+  // the velocities and queued forces are loaded on every step
+  const auto set = [&](Stream stream, f32 value) { this->get_stream(stream)[slot] = value; };
+
+  set(BodyBatch::INVERSE_MASS, physics.total_inverse_mass);
+  set(BodyBatch::LOCAL_INVERSE_INERTIA_X, physics.local_inverse_inertial_tensor.x);
+  set(BodyBatch::LOCAL_INVERSE_INERTIA_Y, physics.local_inverse_inertial_tensor.y);
+  set(BodyBatch::LOCAL_INVERSE_INERTIA_Z, physics.local_inverse_inertial_tensor.z);
+
+  this->load_transform(registry, slot);
+}
+
+auto BodyBatch::remove(Registry &registry, usize slot) -> void {
+  const auto last = this->entities.size() - 1;
+
+  if (slot != last) {
+    for (auto stream = usize{0}; stream < BodyBatch::STREAM_COUNT; ++stream) {
+      auto *values = this->get_stream(static_cast<Stream>(stream));
+      values[slot] = values[last];
+    }
+
+    this->entities[slot]   = this->entities[last];
+    this->dampenings[slot] = this->dampenings[last];
+
+    // the body moved into the slot needs to know where it is now
+    registry.get<PhysicsComponent>(this->entities[slot]).batch_slot = slot;
+  }
+
+  this->entities.pop_back();
+  this->dampenings.pop_back();
+  this->clear(last);
+}
+
+auto BodyBatch::load_transform(const Registry &registry, usize slot) -> void {
+  const auto &transform = registry.get<TransformComponent>(this->entities[slot]);
+
+  const auto set = [&](Stream stream, f32 value) { this->get_stream(stream)[slot] = value; };
+
+  set(BodyBatch::TRANSLATION_X, transform.translation.x);
+  set(BodyBatch::TRANSLATION_Y, transform.translation.y);
+  set(BodyBatch::TRANSLATION_Z, transform.translation.z);
+  set(BodyBatch::ROTATION_W, transform.rotation.w);
+  set(BodyBatch::ROTATION_X, transform.rotation.x);
+  set(BodyBatch::ROTATION_Y, transform.rotation.y);
+  set(BodyBatch::ROTATION_Z, transform.rotation.z);
+}
+
+auto BodyBatch::clear(usize slot) -> void {
+  for (auto stream = usize{0}; stream < BodyBatch::STREAM_COUNT; ++stream) {
+    this->get_stream(static_cast<Stream>(stream))[slot] = 0.0f;
+  }
+
+  this->get_stream(BodyBatch::ROTATION_W)[slot] = 1.0f;
+}
+
+auto BodyBatch::contains(const Registry &registry, Entity entity) const -> bool {
+  // the slot is copied along with the rest of the component, e.g. from a prefab
+  const auto slot = registry.get<PhysicsComponent>(entity).batch_slot;
+
+  return slot < this->entities.size() && this->entities[slot] == entity;
+}
+
+auto BodyBatch::get_lane_count() const -> usize {
+  return (this->entities.size() + BodyBatch::LANE_WIDTH - 1) / BodyBatch::LANE_WIDTH;
+}
+
+auto BodyBatch::get_stream(Stream stream) -> f32 * {
+  return this->streams.data() + stream * this->capacity;
+}
+
+auto BodyBatch::get_stream(Stream stream) const -> const f32 * {
+  return this->streams.data() + stream * this->capacity;
+}
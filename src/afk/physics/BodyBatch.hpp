@@ -0,0 +1,238 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/ecs/Registry.hpp"
+#include "afk/job/JobManager.hpp"
+#include "afk/physics/Lanes.hpp"
+
+namespace afk {
+  namespace physics {
+    /**
+     * Integrates the moving rigid bodies of a step from packed arrays.
+     *
+     * The state of every dynamic, awake body is kept in one array per scalar,
+     * e.g. every body's linear velocity x, then every body's linear velocity
+     * y, and so on. Each integration step then updates LANE_WIDTH bodies per
+     * instruction with SSE where it's available, falling back to plain loops
+     * the compiler can vectorize otherwise.
+     *
+     * The arrays are kept between steps, with each body at the slot stored in
+     * its physics component. A body's full state is only loaded when it's
+     * added, such as when it's created or wakes, and its transform is only
+     * reloaded when something else moves it. Static and sleeping bodies are
+     * left out, so the integration loops never branch on them.
+     */
+    class BodyBatch {
+    public:
+      /** The number of bodies integrated together. */
+      static constexpr usize LANE_WIDTH = afk::physics::Lanes::WIDTH;
+
+      /**
+       * Constructs an empty batch.
+       *
+       * @param job_manager The job manager to spread the bodies across.
+       */
+      explicit BodyBatch(afk::job::JobManager &job_manager);
+
+      /**
+       * Adds every rigid body that became dynamic and awake since the last
+       * sync, removes every body that was destroyed, fell asleep or became
+       * static, and reloads the transforms marked with set_transform_dirty().
+       *
+       * @param registry The registry the bodies belong to.
+       */
+      auto sync(afk::ecs::Registry &registry) -> void;
+
+      /**
+       * Marks that a body's transform was moved by something other than the
+       * batch, so it's reloaded on the next sync.
+       *
+       * @param entity The entity of the body.
+       */
+      auto set_transform_dirty(afk::ecs::Entity entity) -> void;
+
+      /**
+       * Applies gravity, queued forces and dampening to the velocities, and
+       * updates the world space inverse inertia tensors from the rotations.
+       *
+       * @param dt The time to advance by, in seconds.
+       * @param gravity The gravity acceleration, zero if gravity is disabled.
+       */
+      auto integrate_velocities(f32 dt, const glm::vec3 &gravity) -> void;
+
+      /**
+       * Moves the bodies by their velocities, and normalises their rotations
+       * so they don't drift from unit length over many steps.
+       *
+       * @param dt The time to advance by, in seconds.
+       */
+      auto integrate_positions(f32 dt) -> void;
+
+      /**
+       * Reloads the velocities and queued forces and torques of the bodies,
+       * which can be changed between steps or by the contact solver.
+       *
+       * @param registry The registry the bodies belong to.
+       */
+      auto load_velocities(const afk::ecs::Registry &registry) -> void;
+
+      /**
+       * Writes the velocities and inverse inertia tensors back to the
+       * registry, and clears the queued forces and torques.
+       *
+       * @param registry The registry the bodies belong to.
+       */
+      auto store_velocities(afk::ecs::Registry &registry) const -> void;
+
+      /**
+       * Writes the translations and rotations back to the registry.
+       *
+       * @param registry The registry the bodies belong to.
+       */
+      auto store_transforms(afk::ecs::Registry &registry) const -> void;
+
+      /**
+       * Returns the number of bodies.
+       *
+       * @return The body count.
+       */
+      auto get_count() const -> usize;
+
+      /**
+       * Returns the bodies, in slot order.
+       *
+       * @return The entities of the bodies.
+       */
+      auto get_entities() const -> const std::vector<afk::ecs::Entity> &;
+
+    private:
+      /** Identifies each array of scalars. */
+      enum Stream : usize {
+        LINEAR_VELOCITY_X,
+        LINEAR_VELOCITY_Y,
+        LINEAR_VELOCITY_Z,
+        ANGULAR_VELOCITY_X,
+        ANGULAR_VELOCITY_Y,
+        ANGULAR_VELOCITY_Z,
+        EXTERNAL_FORCE_X,
+        EXTERNAL_FORCE_Y,
+        EXTERNAL_FORCE_Z,
+        EXTERNAL_TORQUE_X,
+        EXTERNAL_TORQUE_Y,
+        EXTERNAL_TORQUE_Z,
+        INVERSE_MASS,
+        LINEAR_DAMPENING,
+        ANGULAR_DAMPENING,
+        LOCAL_INVERSE_INERTIA_X,
+        LOCAL_INVERSE_INERTIA_Y,
+        LOCAL_INVERSE_INERTIA_Z,
+        /** The inverse inertia tensor's elements, by column then row. */
+        INVERSE_INERTIA_00,
+        INVERSE_INERTIA_01,
+        INVERSE_INERTIA_02,
+        INVERSE_INERTIA_10,
+        INVERSE_INERTIA_11,
+        INVERSE_INERTIA_12,
+        INVERSE_INERTIA_20,
+        INVERSE_INERTIA_21,
+        INVERSE_INERTIA_22,
+        TRANSLATION_X,
+        TRANSLATION_Y,
+        TRANSLATION_Z,
+        ROTATION_W,
+        ROTATION_X,
+        ROTATION_Y,
+        ROTATION_Z,
+        STREAM_COUNT
+      };
+
+      /**
+       * Adds a body to the end of the arrays, growing them if they're full,
+       * and loads its full state.
+       *
+       * @param registry The registry the body belongs to.
+       * @param entity The entity of the body.
+       */
+      auto add(afk::ecs::Registry &registry, afk::ecs::Entity entity) -> void;
+
+      /**
+       * Removes the body in a slot, moving the last body into its place.
+       *
+       * @param registry The registry the bodies belong to.
+       * @param slot The slot of the body.
+       */
+      auto remove(afk::ecs::Registry &registry, usize slot) -> void;
+
+      /**
+       * Loads the translation and rotation of the body in a slot.
+       *
+       * @param registry The registry the body belongs to.
+       * @param slot The slot of the body.
+       */
+      auto load_transform(const afk::ecs::Registry &registry, usize slot) -> void;
+
+      /**
+       * Resets a slot to a body at rest with an identity rotation, so the
+       * padding lanes integrate and normalise without any special cases.
+       *
+       * @param slot The slot.
+       */
+      auto clear(usize slot) -> void;
+
+      /**
+       * Returns if a body is in the batch.
+       *
+       * @param registry The registry the body belongs to.
+       * @param entity The entity of the body.
+       * @return If the body's slot holds it.
+       */
+      auto contains(const afk::ecs::Registry &registry, afk::ecs::Entity entity) const -> bool;
+
+      /**
+       * Returns the number of lanes holding at least one body.
+       *
+       * @return The lane count.
+       */
+      auto get_lane_count() const -> usize;
+
+      /**
+       * Returns the first element of the specified array.
+       *
+       * @param stream The array.
+       * @return The array's first element.
+       */
+      auto get_stream(Stream stream) -> f32 *;
+
+      /**
+       * Returns the first element of the specified array.
+       *
+       * @param stream The array.
+       * @return The array's first element.
+       */
+      auto get_stream(Stream stream) const -> const f32 *;
+
+      /** The job manager the bodies are spread across. */
+      afk::job::JobManager &job_manager;
+
+      /** The body in each slot. */
+      std::vector<afk::ecs::Entity> entities = {};
+
+      /** The linear and angular dampening of the body in each slot. */
+      std::vector<glm::vec2> dampenings = {};
+
+      /** The bodies moved by something other than the batch since the last sync. */
+      std::vector<afk::ecs::Entity> dirty_entities = {};
+
+      /** The number of elements in each array, padded to a multiple of the lane width. */
+      usize capacity = 0;
+
+      /** Every array, one after another. */
+      std::vector<f32> streams = {};
+    };
+  }
+}
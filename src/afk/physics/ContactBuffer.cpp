@@ -0,0 +1,39 @@
+#include "afk/physics/ContactBuffer.hpp"
+
+#include "afk/debug/Assert.hpp"
+
+using afk::ecs::Entity;
+using afk::event::Event;
+using afk::physics::ContactBuffer;
+
+auto ContactBuffer::clear() -> void {
+  this->pairs.clear();
+  this->contacts.clear();
+}
+
+auto ContactBuffer::add_pair(Entity entity1, Entity entity2) -> void {
+  this->pairs.push_back(Pair{entity1, entity2, static_cast<u32>(this->contacts.size()), 0});
+}
+
+auto ContactBuffer::add_contact(const Contact &contact) -> void {
+  afk_assert_debug(!this->pairs.empty(), "Contact added before any pair");
+
+  this->contacts.push_back(contact);
+  ++this->pairs.back().contact_count;
+}
+
+auto ContactBuffer::get_pairs() const -> std::span<const Pair> {
+  return this->pairs;
+}
+
+auto ContactBuffer::get_contacts(const Pair &pair) const -> std::span<const Contact> {
+  return std::span<const Contact>{this->contacts}.subspan(pair.first_contact, pair.contact_count);
+}
+
+auto ContactBuffer::is_empty() const -> bool {
+  return this->pairs.empty();
+}
+
+auto ContactBuffer::get_event_data() const -> Event::Contacts {
+  return Event::Contacts{this->pairs, this->contacts};
+}
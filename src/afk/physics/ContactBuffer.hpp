@@ -0,0 +1,88 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/event/Event.hpp"
+
+namespace afk {
+  namespace physics {
+    /**
+     * Stores the contacts found during a single physics step contiguously.
+     *
+     * Every contact is appended to one shared array, and each colliding pair
+     * is a header referring to its range of contacts. Clearing the buffer
+     * keeps its memory, so after the first few steps filling it allocates
+     * nothing, and the whole step can be handed to subscribers as spans
+     * rather than as an event per pair.
+     */
+    class ContactBuffer {
+    public:
+      /** A single contact point. */
+      using Contact = afk::event::Event::Collision::Contact;
+      /** A colliding pair of entities and the range of its contacts. */
+      using Pair = afk::event::Event::ContactPair;
+
+      /**
+       * Removes every pair and contact, keeping the memory for the next step.
+       */
+      auto clear() -> void;
+
+      /**
+       * Starts a new pair, which contacts are then added to.
+       *
+       * @param entity1 The first entity.
+       * @param entity2 The second entity.
+       */
+      auto add_pair(afk::ecs::Entity entity1, afk::ecs::Entity entity2) -> void;
+
+      /**
+       * Adds a contact to the last pair added.
+       *
+       * @param contact The contact, oriented from the pair's first entity to
+       *                its second.
+       */
+      auto add_contact(const Contact &contact) -> void;
+
+      /**
+       * Returns every pair.
+       *
+       * @return The pairs, in the order they were added.
+       */
+      auto get_pairs() const -> std::span<const Pair>;
+
+      /**
+       * Returns the contacts of a pair.
+       *
+       * @param pair The pair, which must belong to this buffer.
+       * @return The pair's contacts.
+       */
+      auto get_contacts(const Pair &pair) const -> std::span<const Contact>;
+
+      /**
+       * Returns if there are no pairs.
+       *
+       * @return If the buffer is empty.
+       */
+      auto is_empty() const -> bool;
+
+      /**
+       * Returns the contacts of every pair, to be sent in a collision event.
+       * The event refers to this buffer, so it's only valid until the buffer
+       * is next changed.
+       *
+       * @return The event data.
+       */
+      auto get_event_data() const -> afk::event::Event::Contacts;
+
+    private:
+      /** The pair headers. */
+      std::vector<Pair> pairs = {};
+
+      /** The contacts of every pair, one pair after another. */
+      std::vector<Contact> contacts = {};
+    };
+  }
+}
@@ -0,0 +1,143 @@
+#include "afk/physics/ContactCache.hpp"
+
+#include <initializer_list>
+#include <utility>
+
+#include "afk/debug/Profiler.hpp"
+
+using afk::ecs::Entity;
+using afk::physics::ContactCache;
+
+auto ContactCache::rebuild(const ContactBuffer &contacts) -> void {
+  afk_profile_scope("ContactCache::rebuild");
+
+  this->clear();
+
+  const auto pairs = contacts.get_pairs();
+  this->pair_to_collision_map.reserve(pairs.size());
+  this->entity_to_collisions_map.reserve(pairs.size() * 2);
+
+  for (const auto &pair : pairs) {
+    if (pair.entity1 == pair.entity2) {
+      continue;
+    }
+
+    const auto pair_contacts = contacts.get_contacts(pair);
+    const auto key           = ContactCache::get_pair_key(pair.entity1, pair.entity2);
+    const auto it            = this->pair_to_collision_map.find(key);
+
+    if (it == this->pair_to_collision_map.end()) {
+      if (this->collision_count == this->collisions.size()) {
+        this->collisions.emplace_back();
+      }
+
+      // reuse a manifold from an earlier step, keeping its contacts' memory
+      const auto index    = this->collision_count++;
+      auto &collision     = this->collisions[index];
+      collision.entity1   = pair.entity1;
+      collision.entity2   = pair.entity2;
+      collision.contacts.assign(pair_contacts.begin(), pair_contacts.end());
+      this->pair_to_collision_map.insert({key, index});
+
+      for (const auto entity : {pair.entity1, pair.entity2}) {
+        auto &indices = this->entity_to_collisions_map[entity];
+
+        if (indices.empty()) {
+          this->entities.push_back(entity);
+        }
+
+        indices.push_back(index);
+      }
+      continue;
+    }
+
+    // merge into the existing manifold, flipping the contacts if the pair
+    // was reported the other way around
+    auto &manifold        = this->collisions[it->second];
+    const auto is_flipped = manifold.entity1 != pair.entity1;
+
+    for (auto contact : pair_contacts) {
+      if (is_flipped) {
+        std::swap(contact.collider1_point, contact.collider2_point);
+        contact.normal = -contact.normal;
+      }
+
+      manifold.contacts.push_back(contact);
+    }
+  }
+}
+
+auto ContactCache::clear() -> void {
+  for (auto i = usize{0}; i < this->collision_count; ++i) {
+    this->collisions[i].contacts.clear();
+  }
+
+  // entities that weren't touching anything on the last step are only dropped once they're most
+  // of the map, so it doesn't grow forever as entities are destroyed
+  if (this->entity_to_collisions_map.size() > this->entities.size() * 2 + 64) {
+    std::erase_if(this->entity_to_collisions_map,
+                  [](const auto &entry) { return entry.second.empty(); });
+  }
+
+  for (const auto entity : this->entities) {
+    this->entity_to_collisions_map.at(entity).clear();
+  }
+
+  this->collision_count = 0;
+  this->pair_to_collision_map.clear();
+  this->entities.clear();
+}
+
+auto ContactCache::translate(Entity entity, const glm::vec3 &offset) -> void {
+  const auto it = this->entity_to_collisions_map.find(entity);
+
+  if (it == this->entity_to_collisions_map.end()) {
+    return;
+  }
+
+  for (const auto index : it->second) {
+    auto &collision = this->collisions[index];
+
+    // the normal points from the first entity to the second, so the first
+    // moving along it or the second moving against it pushes them together
+    const auto is_first = collision.entity1 == entity;
+
+    for (auto &contact : collision.contacts) {
+      const auto approach = glm::dot(offset, contact.normal);
+
+      if (is_first) {
+        contact.collider1_point += offset;
+        contact.penetration_depth += approach;
+      } else {
+        contact.collider2_point += offset;
+        contact.penetration_depth -= approach;
+      }
+    }
+  }
+}
+
+auto ContactCache::get_collisions() const -> std::span<const Collision> {
+  return {this->collisions.data(), this->collision_count};
+}
+
+auto ContactCache::get_entities() const -> const std::vector<Entity> & {
+  return this->entities;
+}
+
+auto ContactCache::find(Entity entity1, Entity entity2) const -> const Collision * {
+  const auto it =
+      this->pair_to_collision_map.find(ContactCache::get_pair_key(entity1, entity2));
+
+  return it != this->pair_to_collision_map.end() ? &this->collisions[it->second] : nullptr;
+}
+
+auto ContactCache::get_pair_key(Entity entity1, Entity entity2) -> PairKey {
+  auto first  = static_cast<PairKey>(static_cast<u32>(entity1));
+  auto second = static_cast<PairKey>(static_cast<u32>(entity2));
+
+  if (first > second) {
+    std::swap(first, second);
+  }
+
+  return (first << 32) | second;
+}
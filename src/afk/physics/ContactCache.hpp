@@ -0,0 +1,126 @@
+#pragma once
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/event/Event.hpp"
+#include "afk/physics/ContactBuffer.hpp"
+
+namespace afk {
+  namespace physics {
+    /**
+     * Caches the contact manifold of each colliding entity pair for a single
+     * physics step.
+     *
+     * The cache is built from one collision test per step. When a body is
+     * nudged afterwards, e.g. while depenetrating, the manifolds it is part
+     * of are moved with it rather than being regenerated, so repeated passes
+     * over the contacts don't need to repeat the broad and narrow phase.
+     *
+     * Rebuilding reuses the memory of the last step's manifolds, so a scene
+     * whose contacts don't change much doesn't allocate on each step.
+     */
+    class ContactCache {
+    public:
+      /** The contact manifold between two entities. */
+      using Collision = afk::event::Event::Collision;
+      /** A collection of contact manifolds. */
+      using Collisions = std::vector<Collision>;
+      /** Identifies an unordered pair of entities. */
+      using PairKey = u64;
+
+      /**
+       * Replaces the cached manifolds with the specified contacts.
+       *
+       * Pairs of the same entities, such as those between the individual
+       * colliders of compound bodies, are merged into a single manifold.
+       * Pairs of an entity with itself are discarded.
+       *
+       * @param contacts The contacts found by a collision test.
+       */
+      auto rebuild(const ContactBuffer &contacts) -> void;
+
+      /**
+       * Removes every cached manifold, keeping their memory for the next
+       * rebuild.
+       */
+      auto clear() -> void;
+
+      /**
+       * Moves the specified entity's contacts by the specified offset, and
+       * updates the penetration depth of each manifold it is part of.
+       *
+       * Only translation is accounted for, which is all depenetration does.
+       *
+       * @param entity The entity that moved.
+       * @param offset The translation applied to the entity, in world space.
+       */
+      auto translate(afk::ecs::Entity entity, const glm::vec3 &offset) -> void;
+
+      /**
+       * Returns the cached manifolds.
+       *
+       * @return The cached manifolds.
+       */
+      auto get_collisions() const -> std::span<const Collision>;
+
+      /**
+       * Returns every entity that is part of a cached manifold.
+       *
+       * @return The entities, each appearing once.
+       */
+      auto get_entities() const -> const std::vector<afk::ecs::Entity> &;
+
+      /**
+       * Returns the manifold between the specified entities, if they're
+       * touching. The manifold is oriented from its own first entity to its
+       * second, which may not be the order given here.
+       *
+       * @param entity1 The first entity.
+       * @param entity2 The second entity.
+       * @return The manifold, or nullptr if there isn't one.
+       */
+      auto find(afk::ecs::Entity entity1, afk::ecs::Entity entity2) const
+          -> const Collision *;
+
+      /**
+       * Returns the key identifying the specified pair of entities, which is
+       * the same regardless of their order.
+       *
+       * @param entity1 The first entity.
+       * @param entity2 The second entity.
+       * @return The pair key.
+       */
+      static auto get_pair_key(afk::ecs::Entity entity1, afk::ecs::Entity entity2)
+          -> PairKey;
+
+    private:
+      /**
+       * The cached manifolds, followed by manifolds from earlier steps which
+       * are only kept for their memory.
+       */
+      Collisions collisions = {};
+
+      /** The number of cached manifolds at the start of the collisions. */
+      usize collision_count = 0;
+
+      /** Maps entity pairs to the index of their manifold. */
+      std::unordered_map<PairKey, usize> pair_to_collision_map = {};
+
+      /** Every entity that is part of a cached manifold. */
+      std::vector<afk::ecs::Entity> entities = {};
+
+      /**
+       * Maps entities to the indices of every manifold they're part of.
+       * Entities that stop touching anything keep an empty entry, so its
+       * memory is reused if they touch something again.
+       */
+      std::unordered_map<afk::ecs::Entity, std::vector<usize>> entity_to_collisions_map = {};
+    };
+  }
+}
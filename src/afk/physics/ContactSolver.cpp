@@ -0,0 +1,369 @@
+#include "afk/physics/ContactSolver.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include "afk/debug/Assert.hpp"
+#include "afk/debug/Profiler.hpp"
+#include "afk/ecs/component/PhysicsComponent.hpp"
+#include "afk/ecs/component/TransformComponent.hpp"
+
+using afk::ecs::Entity;
+using afk::ecs::Registry;
+using afk::ecs::component::PhysicsComponent;
+using afk::ecs::component::TransformComponent;
+using afk::physics::ContactCache;
+using afk::physics::ContactSolver;
+using afk::job::JobManager;
+using afk::physics::Islands;
+
+/**
+ * Returns the effective mass of a pair of bodies along a direction at a contact.
+ *
+ * @param inverse_mass The sum of both bodies' inverse masses.
+ * @param inverse_inertia1 The first body's inverse inertia tensor.
+ * @param inverse_inertia2 The second body's inverse inertia tensor.
+ * @param r1 The first body's vector from its centre of mass to the contact.
+ * @param r2 The second body's vector from its centre of mass to the contact.
+ * @param direction The direction, which must be normalized.
+ * @return The effective mass, or zero if neither body can move.
+ */
+static auto get_effective_mass(f32 inverse_mass, const glm::mat3 &inverse_inertia1,
+                               const glm::mat3 &inverse_inertia2, const glm::vec3 &r1,
+                               const glm::vec3 &r2, const glm::vec3 &direction) -> f32 {
+  const auto rn1 = glm::cross(r1, direction);
+  const auto rn2 = glm::cross(r2, direction);
+  const auto k   = inverse_mass + glm::dot(rn1, inverse_inertia1 * rn1) +
+                 glm::dot(rn2, inverse_inertia2 * rn2);
+
+  return k > 0.0f ? 1.0f / k : 0.0f;
+}
+
+ContactSolver::ContactSolver(JobManager &job_manager) : job_manager(job_manager) {}
+
+auto ContactSolver::solve(Registry &registry, const ContactCache &contact_cache,
+                          const Islands &islands) -> void {
+  afk_profile_scope("ContactSolver::solve");
+
+  this->prepare(registry, contact_cache, islands);
+
+  // islands share no bodies, so they can be solved in any order on any thread
+  // and still give the same result
+  this->job_manager.parallel_for(this->island_offsets.size() - 1, [this](usize island) {
+    const auto first = this->island_offsets[island];
+    const auto last  = this->island_offsets[island + 1];
+
+    this->warm_start(first, last);
+
+    for (auto i = i32{0}; i < ContactSolver::VELOCITY_ITERATIONS; ++i) {
+      this->solve_velocities(first, last);
+    }
+  });
+
+  this->store(registry);
+}
+
+auto ContactSolver::clear() -> void {
+  this->cached_impulses.clear();
+  this->pair_to_impulses_map.clear();
+}
+
+auto ContactSolver::prepare(Registry &registry, const ContactCache &contact_cache,
+                            const Islands &islands) -> void {
+  afk_profile_scope("ContactSolver::prepare");
+
+  this->bodies.clear();
+  this->body_map.clear();
+  this->constraints.clear();
+  this->points.clear();
+
+  // gathers each body once, no matter how many contacts it's part of, except
+  // bodies that can't move which are gathered once per island they touch, so
+  // no two islands ever share a body
+  const auto get_body = [this, &registry](Entity entity, usize island) {
+    const auto &physics  = registry.get<PhysicsComponent>(entity);
+    const auto is_moving = !physics.is_static && !physics.is_sleeping;
+    const auto owner     = is_moving ? ContactSolver::ANY_ISLAND : static_cast<u64>(island);
+    const auto key       = (owner << 32) | static_cast<u64>(static_cast<u32>(entity));
+    const auto [it, is_inserted] = this->body_map.try_emplace(key, this->bodies.size());
+
+    if (is_inserted) {
+      const auto &transform = registry.get<TransformComponent>(entity);
+
+      auto body           = Body{};
+      body.entity         = entity;
+      body.center_of_mass = transform.translation + physics.center_of_mass;
+
+      // static and sleeping bodies are left with zero inverse mass and inertia, so impulses never move them
+      if (is_moving) {
+        body.linear_velocity        = physics.linear_velocity;
+        body.angular_velocity       = physics.angular_velocity;
+        body.inverse_mass           = physics.total_inverse_mass;
+        body.inverse_inertia_tensor = physics.inverse_inertial_tensor;
+      }
+
+      this->bodies.push_back(body);
+    }
+
+    return it->second;
+  };
+
+  for (const auto &collision : contact_cache.get_collisions()) {
+    // always put the lower entity first, so a pair's impulses can be warm started no
+    // matter which way around it's reported, flipping the contacts to match
+    const auto is_swapped =
+        static_cast<u32>(collision.entity1) > static_cast<u32>(collision.entity2);
+    const auto entity1 = is_swapped ? collision.entity2 : collision.entity1;
+    const auto entity2 = is_swapped ? collision.entity1 : collision.entity2;
+
+    if (!registry.has<PhysicsComponent>(entity1) || !registry.has<PhysicsComponent>(entity2)) {
+      continue;
+    }
+
+    const auto &physics1 = registry.get<PhysicsComponent>(entity1);
+    const auto &physics2 = registry.get<PhysicsComponent>(entity2);
+
+    const auto is_moving1 = !physics1.is_static && !physics1.is_sleeping;
+    const auto is_moving2 = !physics2.is_static && !physics2.is_sleeping;
+
+    if (!is_moving1 && !is_moving2) {
+      continue;
+    }
+
+    // moving bodies are always dynamic, so they're always in an island
+    const auto island = islands.get_island(is_moving1 ? entity1 : entity2);
+    afk_assert_debug(island.has_value(), "Moving body is not in an island");
+
+    auto constraint        = Constraint{};
+    constraint.island      = island.value();
+    constraint.body1       = get_body(entity1, constraint.island);
+    constraint.body2       = get_body(entity2, constraint.island);
+    constraint.first_point = this->points.size();
+
+    const auto &body1       = this->bodies[constraint.body1];
+    const auto &body2       = this->bodies[constraint.body2];
+    const auto &transform1  = registry.get<TransformComponent>(entity1);
+    const auto inverse_mass = body1.inverse_mass + body2.inverse_mass;
+
+    for (const auto &contact : collision.contacts) {
+      const auto length = glm::length(contact.normal);
+
+      if (length <= std::numeric_limits<f32>::epsilon()) {
+        continue;
+      }
+
+      const auto &point1 = is_swapped ? contact.collider2_point : contact.collider1_point;
+      const auto &point2 = is_swapped ? contact.collider1_point : contact.collider2_point;
+
+      auto point        = Point{};
+      point.r1          = point1 - body1.center_of_mass;
+      point.r2          = point2 - body2.center_of_mass;
+      point.normal      = (is_swapped ? -contact.normal : contact.normal) / length;
+      point.local_point = glm::inverse(transform1.rotation) * (point1 - transform1.translation);
+
+      // pick the tangent from whichever axis is furthest from the normal
+      const auto &n  = point.normal;
+      point.tangent1 = std::abs(n.x) >= 0.57735f ? glm::normalize(glm::vec3{n.y, -n.x, 0.0f})
+                                                 : glm::normalize(glm::vec3{0.0f, n.z, -n.y});
+      point.tangent2 = glm::cross(n, point.tangent1);
+
+      point.normal_mass =
+          get_effective_mass(inverse_mass, body1.inverse_inertia_tensor,
+                             body2.inverse_inertia_tensor, point.r1, point.r2, n);
+      point.tangent_mass = glm::vec2{
+          get_effective_mass(inverse_mass, body1.inverse_inertia_tensor,
+                             body2.inverse_inertia_tensor, point.r1, point.r2, point.tangent1),
+          get_effective_mass(inverse_mass, body1.inverse_inertia_tensor,
+                             body2.inverse_inertia_tensor, point.r1, point.r2, point.tangent2)};
+
+      this->points.push_back(point);
+
+      // only bounce when approaching quickly, so resting contacts settle
+      const auto normal_velocity =
+          glm::dot(this->get_relative_velocity(constraint, this->points.back()), n);
+      if (normal_velocity < -ContactSolver::RESTITUTION_THRESHOLD) {
+        this->points.back().velocity_bias =
+            -ContactSolver::COEFFICIENT_OF_RESTITUTION * normal_velocity;
+      }
+    }
+
+    constraint.point_count = this->points.size() - constraint.first_point;
+
+    if (constraint.point_count > 0) {
+      this->constraints.push_back(constraint);
+    }
+  }
+
+  // counting sort the constraints by island, keeping the order they were
+  // reported in within each island so every run solves them in the same order
+  this->island_offsets.assign(islands.get_count() + 1, 0);
+
+  for (const auto &constraint : this->constraints) {
+    ++this->island_offsets[constraint.island + 1];
+  }
+
+  std::partial_sum(this->island_offsets.begin(), this->island_offsets.end(),
+                   this->island_offsets.begin());
+
+  auto next_constraint = std::vector<usize>(this->island_offsets.begin(), this->island_offsets.end() - 1);
+  this->sorted_constraints.resize(this->constraints.size());
+
+  for (const auto &constraint : this->constraints) {
+    this->sorted_constraints[next_constraint[constraint.island]++] = constraint;
+  }
+
+  std::swap(this->constraints, this->sorted_constraints);
+}
+
+auto ContactSolver::warm_start(usize first, usize last) -> void {
+  static constexpr auto tolerance_squared =
+      ContactSolver::WARM_START_TOLERANCE * ContactSolver::WARM_START_TOLERANCE;
+
+  for (auto c = first; c < last; ++c) {
+    const auto &constraint = this->constraints[c];
+    const auto entity1 = this->bodies[constraint.body1].entity;
+    const auto entity2 = this->bodies[constraint.body2].entity;
+    const auto it      = this->pair_to_impulses_map.find(ContactCache::get_pair_key(entity1, entity2));
+
+    // pairs are always solved the same way around, so the impulses are relative to the same entity
+    if (it == this->pair_to_impulses_map.end()) {
+      continue;
+    }
+
+    const auto &cached = it->second;
+
+    for (auto i = usize{0}; i < constraint.point_count; ++i) {
+      auto &point = this->points[constraint.first_point + i];
+
+      // match with the closest contact from the last step
+      const CachedImpulse *match = nullptr;
+      auto match_distance        = tolerance_squared;
+
+      for (auto j = usize{0}; j < cached.impulse_count; ++j) {
+        const auto &impulse = this->cached_impulses[cached.first_impulse + j];
+        const auto offset   = impulse.local_point - point.local_point;
+        const auto distance = glm::dot(offset, offset);
+
+        if (distance < match_distance) {
+          match          = &impulse;
+          match_distance = distance;
+        }
+      }
+
+      if (match == nullptr) {
+        continue;
+      }
+
+      // the tangents may have changed, so project the friction impulse onto the new ones
+      point.normal_impulse  = match->normal_impulse;
+      point.tangent_impulse = glm::vec2{glm::dot(match->tangent_impulse, point.tangent1),
+                                        glm::dot(match->tangent_impulse, point.tangent2)};
+
+      this->apply_impulse(constraint, point,
+                          point.normal * point.normal_impulse +
+                              point.tangent1 * point.tangent_impulse.x +
+                              point.tangent2 * point.tangent_impulse.y);
+    }
+  }
+}
+
+auto ContactSolver::solve_velocities(usize first, usize last) -> void {
+  for (auto c = first; c < last; ++c) {
+    const auto &constraint = this->constraints[c];
+
+    for (auto i = usize{0}; i < constraint.point_count; ++i) {
+      auto &point = this->points[constraint.first_point + i];
+
+      // friction first, so the normal impulse has the final say on penetration
+      {
+        const auto velocity = this->get_relative_velocity(constraint, point);
+        const auto tangent_velocity =
+            glm::vec2{glm::dot(velocity, point.tangent1), glm::dot(velocity, point.tangent2)};
+        const auto max_friction = ContactSolver::COEFFICIENT_OF_FRICTION * point.normal_impulse;
+        const auto lambda       = -tangent_velocity * point.tangent_mass;
+
+        // clamp the combined impulse to the friction cone rather than each tangent on its own,
+        // which would allow more friction diagonally than along either tangent
+        const auto previous = point.tangent_impulse;
+        auto impulse        = previous + lambda;
+        const auto length   = glm::length(impulse);
+
+        if (length > max_friction) {
+          impulse *= max_friction / length;
+        }
+
+        point.tangent_impulse = impulse;
+        const auto delta      = point.tangent_impulse - previous;
+
+        this->apply_impulse(constraint, point,
+                            point.tangent1 * delta.x + point.tangent2 * delta.y);
+      }
+
+      // the accumulated normal impulse may only ever push the bodies apart
+      {
+        const auto velocity = this->get_relative_velocity(constraint, point);
+        const auto lambda =
+            point.normal_mass * (point.velocity_bias - glm::dot(velocity, point.normal));
+
+        const auto previous  = point.normal_impulse;
+        point.normal_impulse = std::max(previous + lambda, 0.0f);
+        const auto delta     = point.normal_impulse - previous;
+
+        this->apply_impulse(constraint, point, point.normal * delta);
+      }
+    }
+  }
+}
+
+auto ContactSolver::store(Registry &registry) -> void {
+  this->cached_impulses.clear();
+  this->pair_to_impulses_map.clear();
+
+  for (const auto &constraint : this->constraints) {
+    const auto entity1 = this->bodies[constraint.body1].entity;
+    const auto entity2 = this->bodies[constraint.body2].entity;
+
+    this->pair_to_impulses_map[ContactCache::get_pair_key(entity1, entity2)] =
+        CachedPair{this->cached_impulses.size(), constraint.point_count};
+
+    for (auto i = usize{0}; i < constraint.point_count; ++i) {
+      const auto &point = this->points[constraint.first_point + i];
+      this->cached_impulses.push_back(
+          CachedImpulse{point.local_point, point.normal_impulse,
+                        point.tangent1 * point.tangent_impulse.x +
+                            point.tangent2 * point.tangent_impulse.y});
+    }
+  }
+
+  for (const auto &body : this->bodies) {
+    auto &physics = registry.get<PhysicsComponent>(body.entity);
+
+    if (!physics.is_static && !physics.is_sleeping) {
+      physics.linear_velocity  = body.linear_velocity;
+      physics.angular_velocity = body.angular_velocity;
+    }
+  }
+}
+
+auto ContactSolver::apply_impulse(const Constraint &constraint, const Point &point,
+                                  const glm::vec3 &impulse) -> void {
+  auto &body1 = this->bodies[constraint.body1];
+  auto &body2 = this->bodies[constraint.body2];
+
+  body1.linear_velocity -= body1.inverse_mass * impulse;
+  body1.angular_velocity -= body1.inverse_inertia_tensor * glm::cross(point.r1, impulse);
+  body2.linear_velocity += body2.inverse_mass * impulse;
+  body2.angular_velocity += body2.inverse_inertia_tensor * glm::cross(point.r2, impulse);
+}
+
+auto ContactSolver::get_relative_velocity(const Constraint &constraint,
+                                          const Point &point) const -> glm::vec3 {
+  const auto &body1 = this->bodies[constraint.body1];
+  const auto &body2 = this->bodies[constraint.body2];
+
+  return (body2.linear_velocity + glm::cross(body2.angular_velocity, point.r2)) -
+         (body1.linear_velocity + glm::cross(body1.angular_velocity, point.r1));
+}
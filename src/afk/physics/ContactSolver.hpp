@@ -0,0 +1,242 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/ecs/Registry.hpp"
+#include "afk/job/JobManager.hpp"
+#include "afk/physics/ContactCache.hpp"
+#include "afk/physics/Islands.hpp"
+
+namespace afk {
+  namespace physics {
+    /**
+     * Resolves contacts between rigid bodies with a sequential impulse solver.
+     *
+     * Every contact of a step is solved together over several iterations,
+     * with the normal impulse of each contact kept non-negative and its
+     * combined friction impulse along both tangents kept within the friction
+     * cone. Each pair is solved with its lower entity first, whichever way
+     * around it was reported, and its impulses are cached and used to warm
+     * start the same contacts on the next step so resting contacts converge
+     * in a few iterations.
+     *
+     * The contacts of each island are solved on their own, with islands
+     * spread across the job manager's threads. Static and sleeping bodies are
+     * copied into every island they touch, so islands share no state and the
+     * result doesn't depend on how the islands were scheduled.
+     */
+    class ContactSolver {
+    public:
+      /** The number of velocity iterations per step. */
+      static constexpr i32 VELOCITY_ITERATIONS = 8;
+
+      /**
+       * Coefficient of restitution
+       * 1 for perfectly elastic collisions, 0 for all energy lost
+       */
+      static constexpr f32 COEFFICIENT_OF_RESTITUTION = 0.9f;
+
+      /**
+       * The approach speed below which contacts don't bounce, so resting
+       * contacts don't jitter, in metres per second.
+       */
+      static constexpr f32 RESTITUTION_THRESHOLD = 1.0f;
+
+      /** The coefficient of friction between every pair of bodies. */
+      static constexpr f32 COEFFICIENT_OF_FRICTION = 0.5f;
+
+      /**
+       * The distance within which a contact is considered to be the same
+       * contact as one from the last step, in metres.
+       */
+      static constexpr f32 WARM_START_TOLERANCE = 0.1f;
+
+      /** The owner of a body that moves, and so is only ever in one island. */
+      static constexpr u64 ANY_ISLAND = 0xFFFFFFFF;
+
+      /**
+       * Constructs a solver without any cached impulses.
+       *
+       * @param job_manager The job manager to spread the islands across.
+       */
+      explicit ContactSolver(afk::job::JobManager &job_manager);
+
+      /**
+       * Solves every contact in the specified cache, changing the velocities
+       * of the dynamic bodies involved.
+       *
+       * Only contacts between two entities with a physics component are
+       * solved, and at least one of them must be dynamic and awake.
+       *
+       * @param registry The registry the entities belong to.
+       * @param contact_cache The contacts to solve.
+       * @param islands The islands of the bodies, built from the same contacts.
+       */
+      auto solve(afk::ecs::Registry &registry, const ContactCache &contact_cache,
+                 const Islands &islands) -> void;
+
+      /**
+       * Forgets the impulses cached for warm starting.
+       */
+      auto clear() -> void;
+
+    private:
+      /** The state of a body involved in a contact, gathered from its components. */
+      struct Body {
+        /** The entity of the body. */
+        afk::ecs::Entity entity = {};
+        /** The linear velocity. */
+        glm::vec3 linear_velocity = {};
+        /** The angular velocity. */
+        glm::vec3 angular_velocity = {};
+        /** The centre of mass in world space. */
+        glm::vec3 center_of_mass = {};
+        /** The inverse mass, zero for static and sleeping bodies. */
+        f32 inverse_mass = {};
+        /** The inverse inertia tensor in world space, zero for static and sleeping bodies. */
+        glm::mat3 inverse_inertia_tensor = glm::mat3{0.0f};
+      };
+
+      /** A single contact point between two bodies. */
+      struct Point {
+        /** The first body's vector from its centre of mass to the contact. */
+        glm::vec3 r1 = {};
+        /** The second body's vector from its centre of mass to the contact. */
+        glm::vec3 r2 = {};
+        /** The contact normal from the first body to the second. */
+        glm::vec3 normal = {};
+        /** The first tangent the friction impulse acts along. */
+        glm::vec3 tangent1 = {};
+        /** The second tangent the friction impulse acts along. */
+        glm::vec3 tangent2 = {};
+        /** The contact on the first body, in the first body's local space. */
+        glm::vec3 local_point = {};
+        /** The effective mass along the normal. */
+        f32 normal_mass = {};
+        /** The effective mass along each tangent. */
+        glm::vec2 tangent_mass = {};
+        /** The separating speed the normal impulse aims for, for restitution. */
+        f32 velocity_bias = {};
+        /** The accumulated normal impulse. */
+        f32 normal_impulse = {};
+        /** The accumulated friction impulse along each tangent. */
+        glm::vec2 tangent_impulse = {};
+      };
+
+      /** The contact between two bodies. */
+      struct Constraint {
+        /** The island the constraint belongs to. */
+        usize island = {};
+        /** The index of the first body. */
+        usize body1 = {};
+        /** The index of the second body. */
+        usize body2 = {};
+        /** The index of the first contact point. */
+        usize first_point = {};
+        /** The number of contact points. */
+        usize point_count = {};
+      };
+
+      /** An impulse kept from the last step for warm starting. */
+      struct CachedImpulse {
+        /** The contact on the first body, in the first body's local space. */
+        glm::vec3 local_point = {};
+        /** The accumulated normal impulse. */
+        f32 normal_impulse = {};
+        /** The accumulated friction impulse in world space. */
+        glm::vec3 tangent_impulse = {};
+      };
+
+      /** The impulses kept from the last step for an entity pair. */
+      struct CachedPair {
+        /** The index of the first impulse in the cached impulses. */
+        usize first_impulse = {};
+        /** The number of impulses. */
+        usize impulse_count = {};
+      };
+
+      /**
+       * Gathers the bodies and contact constraints to solve from the cache,
+       * grouping the constraints by island.
+       *
+       * @param registry The registry the entities belong to.
+       * @param contact_cache The contacts to solve.
+       * @param islands The islands of the bodies.
+       */
+      auto prepare(afk::ecs::Registry &registry, const ContactCache &contact_cache,
+                   const Islands &islands) -> void;
+
+      /**
+       * Applies the impulses cached from the last step to the matching contacts
+       * of the specified constraints.
+       *
+       * @param first The index of the first constraint.
+       * @param last The index one past the last constraint.
+       */
+      auto warm_start(usize first, usize last) -> void;
+
+      /**
+       * Runs a single iteration over the specified constraints.
+       *
+       * @param first The index of the first constraint.
+       * @param last The index one past the last constraint.
+       */
+      auto solve_velocities(usize first, usize last) -> void;
+
+      /**
+       * Caches the accumulated impulses for the next step and writes the
+       * solved velocities back to the registry.
+       *
+       * @param registry The registry the entities belong to.
+       */
+      auto store(afk::ecs::Registry &registry) -> void;
+
+      /**
+       * Applies an impulse at a contact, equal and opposite on each body.
+       *
+       * @param constraint The constraint the contact belongs to.
+       * @param point The contact.
+       * @param impulse The impulse to apply to the second body.
+       */
+      auto apply_impulse(const Constraint &constraint, const Point &point,
+                         const glm::vec3 &impulse) -> void;
+
+      /**
+       * Returns the velocity of the second body relative to the first at a contact.
+       *
+       * @param constraint The constraint the contact belongs to.
+       * @param point The contact.
+       * @return The relative velocity.
+       */
+      auto get_relative_velocity(const Constraint &constraint, const Point &point) const
+          -> glm::vec3;
+
+      /** The job manager the islands are spread across. */
+      afk::job::JobManager &job_manager;
+
+      /** The bodies involved in this step's contacts. */
+      std::vector<Body> bodies = {};
+      /** Maps entities and their owning island to their index in the bodies. */
+      std::unordered_map<u64, usize> body_map = {};
+      /** This step's contact constraints, grouped by island. */
+      std::vector<Constraint> constraints = {};
+      /** Scratch space for grouping the constraints by island. */
+      std::vector<Constraint> sorted_constraints = {};
+      /** The index of each island's first constraint, followed by the constraint count. */
+      std::vector<usize> island_offsets = {};
+      /** The contact points of every constraint. */
+      std::vector<Point> points = {};
+
+      /** The impulses kept from the last step. */
+      std::vector<CachedImpulse> cached_impulses = {};
+      /** Maps entity pairs to their impulses kept from the last step. */
+      std::unordered_map<ContactCache::PairKey, CachedPair> pair_to_impulses_map = {};
+    };
+  }
+}
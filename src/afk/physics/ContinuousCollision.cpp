@@ -0,0 +1,26 @@
+#include "afk/physics/ContinuousCollision.hpp"
+
+using afk::physics::ContinuousStop;
+using afk::physics::SegmentHit;
+
+auto afk::physics::stop_at_hit(const glm::vec3 &from, const glm::vec3 &motion,
+                               const glm::vec3 &linear_velocity, const SegmentHit &hit)
+    -> ContinuousStop {
+  if (hit.fraction <= 0.0f) {
+    return ContinuousStop{from + motion, linear_velocity};
+  }
+
+  // anything that overlaps where the body stops is resolved by the contact solver and
+  // depenetration on the next update
+  auto stop = ContinuousStop{from + motion * hit.fraction, linear_velocity};
+
+  // the velocity would carry the body straight back through on the next update
+  // the body is approaching when the normal velocity is negative, as the normal faces against it
+  const auto normal_velocity = glm::dot(linear_velocity, hit.normal);
+
+  if (normal_velocity < 0.0f) {
+    stop.linear_velocity -= hit.normal * normal_velocity;
+  }
+
+  return stop;
+}
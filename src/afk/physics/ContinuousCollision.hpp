@@ -0,0 +1,39 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "afk/physics/Geometry.hpp"
+
+namespace afk {
+  namespace physics {
+    /**
+     * Where a body swept with continuous collision is stopped, and how it's
+     * moving afterwards.
+     */
+    struct ContinuousStop {
+      /** The body's translation. */
+      glm::vec3 translation = {};
+      /** The body's linear velocity. */
+      glm::vec3 linear_velocity = {};
+    };
+
+    /**
+     * Stops a body swept with continuous collision where its sphere hit
+     * something.
+     *
+     * Only the part of the velocity heading into the surface is removed, so
+     * a body that hits a wall at an angle keeps sliding along it. A hit at
+     * the very start of the sweep is something the body was already resting
+     * against, which the contact solver handles, so it's left alone.
+     *
+     * @param from The body's translation at the start of the update.
+     * @param motion How far the body moved on the update.
+     * @param linear_velocity The body's linear velocity.
+     * @param hit Where the sphere first hit something, with the normal facing
+     *            against the motion.
+     * @return Where the body stops, and its velocity.
+     */
+    auto stop_at_hit(const glm::vec3 &from, const glm::vec3 &motion,
+                     const glm::vec3 &linear_velocity, const SegmentHit &hit) -> ContinuousStop;
+  }
+}
@@ -0,0 +1,283 @@
+#include "afk/physics/Geometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <variant>
+
+#include "afk/utility/Visitor.hpp"
+
+using afk::physics::Aabb;
+using afk::physics::SegmentHit;
+using afk::physics::WorldBox;
+using afk::physics::WorldShape;
+using afk::physics::WorldSphere;
+
+/** Where a line segment enters a set of slabs. */
+struct SlabHit {
+  /** The fraction along the segment it enters at. */
+  f32 fraction = {};
+  /** The axis of the slab it entered last, or -1 if it starts inside. */
+  i32 axis = {};
+};
+
+/**
+ * Returns where a line segment enters the space between three pairs of axis
+ * aligned planes.
+ *
+ * @param from The start of the segment.
+ * @param delta The end of the segment minus its start.
+ * @param min The minimum corner of the slabs.
+ * @param max The maximum corner of the slabs.
+ * @return The hit, or nothing if it misses.
+ */
+static auto intersect_slabs(const glm::vec3 &from, const glm::vec3 &delta,
+                            const glm::vec3 &min, const glm::vec3 &max) -> std::optional<SlabHit> {
+  auto hit          = SlabHit{0.0f, -1};
+  auto fraction_max = 1.0f;
+
+  for (auto i = glm::vec3::length_type{0}; i < 3; ++i) {
+    // parallel to the slab, so it either never enters or never leaves it
+    if (std::abs(delta[i]) < std::numeric_limits<f32>::epsilon()) {
+      if (from[i] < min[i] || from[i] > max[i]) {
+        return std::nullopt;
+      }
+
+      continue;
+    }
+
+    const auto inverse_delta = 1.0f / delta[i];
+    auto enter               = (min[i] - from[i]) * inverse_delta;
+    auto exit                = (max[i] - from[i]) * inverse_delta;
+
+    if (enter > exit) {
+      std::swap(enter, exit);
+    }
+
+    if (enter > hit.fraction) {
+      hit.fraction = enter;
+      hit.axis     = static_cast<i32>(i);
+    }
+
+    fraction_max = std::min(fraction_max, exit);
+
+    if (hit.fraction > fraction_max) {
+      return std::nullopt;
+    }
+  }
+
+  return hit;
+}
+
+/**
+ * Returns the normal to report for a line segment that starts inside a shape.
+ *
+ * @param delta The end of the segment minus its start.
+ * @return The normal, facing against the segment.
+ */
+static auto get_inside_normal(const glm::vec3 &delta) -> glm::vec3 {
+  const auto length = glm::length(delta);
+
+  return length > 0.0f ? -delta / length : glm::vec3{0.0f};
+}
+
+auto afk::physics::get_bounds(const WorldSphere &sphere) -> Aabb {
+  return Aabb{sphere.center - glm::vec3{sphere.radius}, sphere.center + glm::vec3{sphere.radius}};
+}
+
+auto afk::physics::get_bounds(const WorldBox &box) -> Aabb {
+  const auto axes = glm::mat3_cast(box.rotation);
+  auto extents    = glm::vec3{0.0f};
+
+  // each local axis adds its half extent's reach along each world axis
+  for (auto i = glm::mat3::length_type{0}; i < 3; ++i) {
+    extents += glm::abs(axes[i]) * box.half_extents[i];
+  }
+
+  return Aabb{box.center - extents, box.center + extents};
+}
+
+auto afk::physics::get_closest_point(const WorldBox &box, const glm::vec3 &point) -> glm::vec3 {
+  const auto local = glm::inverse(box.rotation) * (point - box.center);
+
+  return box.center + box.rotation * glm::clamp(local, -box.half_extents, box.half_extents);
+}
+
+auto afk::physics::is_overlapping(const Aabb &lhs, const Aabb &rhs) -> bool {
+  return glm::all(glm::lessThanEqual(lhs.min, rhs.max)) &&
+         glm::all(glm::lessThanEqual(rhs.min, lhs.max));
+}
+
+auto afk::physics::is_overlapping(const WorldSphere &lhs, const WorldSphere &rhs) -> bool {
+  const auto offset   = rhs.center - lhs.center;
+  const auto distance = lhs.radius + rhs.radius;
+
+  return glm::dot(offset, offset) <= distance * distance;
+}
+
+auto afk::physics::is_overlapping(const WorldSphere &sphere, const WorldBox &box) -> bool {
+  const auto offset = afk::physics::get_closest_point(box, sphere.center) - sphere.center;
+
+  return glm::dot(offset, offset) <= sphere.radius * sphere.radius;
+}
+
+auto afk::physics::is_overlapping(const WorldBox &lhs, const WorldBox &rhs) -> bool {
+  // Gottschalk's separating axis test, done in the first box's local space
+  // the boxes are separate if their projections onto any face normal of
+  // either box, or any cross product of an edge from each, don't overlap
+  const auto axes1 = glm::mat3_cast(lhs.rotation);
+  const auto axes2 = glm::mat3_cast(rhs.rotation);
+  const auto &a    = lhs.half_extents;
+  const auto &b    = rhs.half_extents;
+
+  // an epsilon stops near parallel edges from giving a zero length cross product axis
+  static constexpr auto epsilon = 1e-6f;
+
+  auto rotation          = glm::mat3{};
+  auto absolute_rotation = glm::mat3{};
+
+  for (auto i = glm::mat3::length_type{0}; i < 3; ++i) {
+    for (auto j = glm::mat3::length_type{0}; j < 3; ++j) {
+      rotation[i][j]          = glm::dot(axes1[i], axes2[j]);
+      absolute_rotation[i][j] = std::abs(rotation[i][j]) + epsilon;
+    }
+  }
+
+  const auto offset = rhs.center - lhs.center;
+  const auto t      = glm::vec3{glm::dot(offset, axes1[0]), glm::dot(offset, axes1[1]),
+                                glm::dot(offset, axes1[2])};
+
+  // the first box's face normals
+  for (auto i = glm::mat3::length_type{0}; i < 3; ++i) {
+    const auto ra = a[i];
+    const auto rb = b[0] * absolute_rotation[i][0] + b[1] * absolute_rotation[i][1] +
+                    b[2] * absolute_rotation[i][2];
+
+    if (std::abs(t[i]) > ra + rb) {
+      return false;
+    }
+  }
+
+  // the second box's face normals
+  for (auto j = glm::mat3::length_type{0}; j < 3; ++j) {
+    const auto ra = a[0] * absolute_rotation[0][j] + a[1] * absolute_rotation[1][j] +
+                    a[2] * absolute_rotation[2][j];
+    const auto rb       = b[j];
+    const auto distance = t[0] * rotation[0][j] + t[1] * rotation[1][j] + t[2] * rotation[2][j];
+
+    if (std::abs(distance) > ra + rb) {
+      return false;
+    }
+  }
+
+  // the cross product of each pair of edges
+  for (auto i = glm::mat3::length_type{0}; i < 3; ++i) {
+    const auto i1 = (i + 1) % 3;
+    const auto i2 = (i + 2) % 3;
+
+    for (auto j = glm::mat3::length_type{0}; j < 3; ++j) {
+      const auto j1 = (j + 1) % 3;
+      const auto j2 = (j + 2) % 3;
+
+      const auto ra       = a[i1] * absolute_rotation[i2][j] + a[i2] * absolute_rotation[i1][j];
+      const auto rb       = b[j1] * absolute_rotation[i][j2] + b[j2] * absolute_rotation[i][j1];
+      const auto distance = t[i2] * rotation[i1][j] - t[i1] * rotation[i2][j];
+
+      if (std::abs(distance) > ra + rb) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+auto afk::physics::is_overlapping(const WorldShape &lhs, const WorldShape &rhs) -> bool {
+  auto visitor = afk::utility::Visitor{
+      [](const WorldSphere &lhs, const WorldSphere &rhs) { return is_overlapping(lhs, rhs); },
+      [](const WorldSphere &sphere, const WorldBox &box) { return is_overlapping(sphere, box); },
+      [](const WorldBox &box, const WorldSphere &sphere) { return is_overlapping(sphere, box); },
+      [](const WorldBox &lhs, const WorldBox &rhs) { return is_overlapping(lhs, rhs); }};
+
+  return std::visit(visitor, lhs, rhs);
+}
+
+auto afk::physics::intersect_segment(const glm::vec3 &from, const glm::vec3 &to,
+                                     const Aabb &aabb) -> std::optional<f32> {
+  const auto hit = intersect_slabs(from, to - from, aabb.min, aabb.max);
+
+  if (!hit.has_value()) {
+    return std::nullopt;
+  }
+
+  return hit->fraction;
+}
+
+auto afk::physics::intersect_segment(const glm::vec3 &from, const glm::vec3 &to,
+                                     const WorldSphere &sphere) -> std::optional<SegmentHit> {
+  const auto delta  = to - from;
+  const auto offset = from - sphere.center;
+  const auto c      = glm::dot(offset, offset) - sphere.radius * sphere.radius;
+
+  if (c <= 0.0f) {
+    return SegmentHit{0.0f, get_inside_normal(delta)};
+  }
+
+  // solve |from + t * delta - center| = radius for the smallest t
+  const auto a            = glm::dot(delta, delta);
+  const auto b            = glm::dot(offset, delta);
+  const auto discriminant = b * b - a * c;
+
+  // moving away from the sphere, or missing it entirely
+  if (a == 0.0f || b >= 0.0f || discriminant < 0.0f) {
+    return std::nullopt;
+  }
+
+  const auto fraction = (-b - std::sqrt(discriminant)) / a;
+
+  if (fraction > 1.0f) {
+    return std::nullopt;
+  }
+
+  return SegmentHit{fraction, glm::normalize(from + delta * fraction - sphere.center)};
+}
+
+auto afk::physics::intersect_segment(const glm::vec3 &from, const glm::vec3 &to,
+                                     const WorldBox &box) -> std::optional<SegmentHit> {
+  // test in the box's local space, where it's axis aligned
+  const auto inverse_rotation = glm::inverse(box.rotation);
+  const auto local_from       = inverse_rotation * (from - box.center);
+  const auto local_delta      = inverse_rotation * (to - from);
+
+  const auto hit = intersect_slabs(local_from, local_delta, -box.half_extents, box.half_extents);
+
+  if (!hit.has_value()) {
+    return std::nullopt;
+  }
+
+  if (hit->axis < 0) {
+    return SegmentHit{0.0f, get_inside_normal(to - from)};
+  }
+
+  // the face entered last is the one that was hit, and it faces against the segment
+  const auto axis    = static_cast<glm::vec3::length_type>(hit->axis);
+  auto local_normal  = glm::vec3{0.0f};
+  local_normal[axis] = local_delta[axis] > 0.0f ? -1.0f : 1.0f;
+
+  return SegmentHit{hit->fraction, box.rotation * local_normal};
+}
+
+auto afk::physics::sweep_sphere(const glm::vec3 &from, const glm::vec3 &to, f32 radius,
+                                const WorldShape &shape) -> std::optional<SegmentHit> {
+  auto visitor = afk::utility::Visitor{
+      [&](const WorldSphere &sphere) {
+        return intersect_segment(from, to, WorldSphere{sphere.center, sphere.radius + radius});
+      },
+      [&](const WorldBox &box) {
+        return intersect_segment(
+            from, to, WorldBox{box.center, box.rotation, box.half_extents + glm::vec3{radius}});
+      }};
+
+  return std::visit(visitor, shape);
+}
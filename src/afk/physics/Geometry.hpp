@@ -0,0 +1,185 @@
+#pragma once
+
+#include <optional>
+#include <variant>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include "afk/NumericTypes.hpp"
+
+namespace afk {
+  namespace physics {
+    /**
+     * An axis aligned bounding box in world space.
+     */
+    struct Aabb {
+      /** The minimum corner. */
+      glm::vec3 min = {};
+      /** The maximum corner. */
+      glm::vec3 max = {};
+    };
+
+    /**
+     * A sphere in world space.
+     */
+    struct WorldSphere {
+      /** The centre. */
+      glm::vec3 center = {};
+      /** The radius. */
+      f32 radius = {};
+    };
+
+    /**
+     * An oriented box in world space.
+     */
+    struct WorldBox {
+      /** The centre. */
+      glm::vec3 center = {};
+      /** The rotation from the box's local space to world space. */
+      glm::quat rotation = glm::quat{1.0f, 0.0f, 0.0f, 0.0f};
+      /** The half extents along each of the box's local axes. */
+      glm::vec3 half_extents = {};
+    };
+
+    /**
+     * A collider's shape in world space.
+     */
+    using WorldShape = std::variant<WorldSphere, WorldBox>;
+
+    /**
+     * Where a line segment first hits a shape.
+     */
+    struct SegmentHit {
+      /**
+       * The fraction of the distance from the start of the segment to its
+       * end the hit is at, zero if the segment starts inside the shape.
+       */
+      f32 fraction = {};
+      /** The surface normal at the hit, facing against the segment. */
+      glm::vec3 normal = {};
+    };
+
+    /**
+     * Returns the bounding box of a sphere.
+     *
+     * @param sphere The sphere.
+     * @return The bounding box.
+     */
+    auto get_bounds(const WorldSphere &sphere) -> Aabb;
+
+    /**
+     * Returns the bounding box of an oriented box.
+     *
+     * @param box The box.
+     * @return The bounding box.
+     */
+    auto get_bounds(const WorldBox &box) -> Aabb;
+
+    /**
+     * Returns the point inside an oriented box closest to the specified point.
+     *
+     * @param box The box.
+     * @param point The point, in world space.
+     * @return The closest point, in world space.
+     */
+    auto get_closest_point(const WorldBox &box, const glm::vec3 &point) -> glm::vec3;
+
+    /**
+     * Returns if two bounding boxes overlap, including touching.
+     *
+     * @param lhs The first bounding box.
+     * @param rhs The second bounding box.
+     * @return If they overlap.
+     */
+    auto is_overlapping(const Aabb &lhs, const Aabb &rhs) -> bool;
+
+    /**
+     * Returns if two spheres overlap, including touching.
+     *
+     * @param lhs The first sphere.
+     * @param rhs The second sphere.
+     * @return If they overlap.
+     */
+    auto is_overlapping(const WorldSphere &lhs, const WorldSphere &rhs) -> bool;
+
+    /**
+     * Returns if a sphere and an oriented box overlap, including touching.
+     *
+     * @param sphere The sphere.
+     * @param box The box.
+     * @return If they overlap.
+     */
+    auto is_overlapping(const WorldSphere &sphere, const WorldBox &box) -> bool;
+
+    /**
+     * Returns if two oriented boxes overlap, including touching, by testing
+     * every separating axis.
+     *
+     * @param lhs The first box.
+     * @param rhs The second box.
+     * @return If they overlap.
+     */
+    auto is_overlapping(const WorldBox &lhs, const WorldBox &rhs) -> bool;
+
+    /**
+     * Returns if two shapes overlap, including touching.
+     *
+     * @param lhs The first shape.
+     * @param rhs The second shape.
+     * @return If they overlap.
+     */
+    auto is_overlapping(const WorldShape &lhs, const WorldShape &rhs) -> bool;
+
+    /**
+     * Returns where a line segment enters a bounding box.
+     *
+     * @param from The start of the segment.
+     * @param to The end of the segment.
+     * @param aabb The bounding box.
+     * @return The fraction along the segment it enters at, zero if it starts
+     *         inside, or nothing if it misses.
+     */
+    auto intersect_segment(const glm::vec3 &from, const glm::vec3 &to, const Aabb &aabb)
+        -> std::optional<f32>;
+
+    /**
+     * Returns where a line segment first hits a sphere.
+     *
+     * @param from The start of the segment.
+     * @param to The end of the segment.
+     * @param sphere The sphere.
+     * @return The hit, or nothing if it misses.
+     */
+    auto intersect_segment(const glm::vec3 &from, const glm::vec3 &to, const WorldSphere &sphere)
+        -> std::optional<SegmentHit>;
+
+    /**
+     * Returns where a line segment first hits an oriented box.
+     *
+     * @param from The start of the segment.
+     * @param to The end of the segment.
+     * @param box The box.
+     * @return The hit, or nothing if it misses.
+     */
+    auto intersect_segment(const glm::vec3 &from, const glm::vec3 &to, const WorldBox &box)
+        -> std::optional<SegmentHit>;
+
+    /**
+     * Returns where a sphere swept along a line segment first hits a shape.
+     *
+     * Sweeping a sphere is the same as intersecting its centre with the shape
+     * grown by its radius. Boxes are grown along their faces rather than
+     * having their edges and corners rounded, which is conservative, so the
+     * hit may be slightly early near them.
+     *
+     * @param from The start of the sphere's centre.
+     * @param to The end of the sphere's centre.
+     * @param radius The radius of the sphere.
+     * @param shape The shape.
+     * @return The hit, or nothing if it misses.
+     */
+    auto sweep_sphere(const glm::vec3 &from, const glm::vec3 &to, f32 radius,
+                      const WorldShape &shape) -> std::optional<SegmentHit>;
+  }
+}
@@ -0,0 +1,131 @@
+#include "afk/physics/Islands.hpp"
+
+#include <numeric>
+#include <utility>
+
+#include "afk/debug/Profiler.hpp"
+#include "afk/ecs/component/PhysicsComponent.hpp"
+
+using afk::ecs::Entity;
+using afk::ecs::Registry;
+using afk::ecs::component::PhysicsComponent;
+using afk::physics::Islands;
+
+auto Islands::build(const Registry &registry, const ContactCache &contact_cache) -> void {
+  afk_profile_scope("Islands::build");
+
+  this->entities.clear();
+  this->entity_to_body_map.clear();
+
+  const auto view = registry.view<const PhysicsComponent>();
+
+  for (const auto entity : view) {
+    if (!view.get<const PhysicsComponent>(entity).is_static) {
+      this->entity_to_body_map.insert({entity, this->entities.size()});
+      this->entities.push_back(entity);
+    }
+  }
+
+  const auto count = this->entities.size();
+  this->parents.resize(count);
+  this->ranks.assign(count, 0);
+  std::iota(this->parents.begin(), this->parents.end(), usize{0});
+
+  // only contacts between two dynamic bodies join islands
+  for (const auto &collision : contact_cache.get_collisions()) {
+    const auto body1 = this->entity_to_body_map.find(collision.entity1);
+    const auto body2 = this->entity_to_body_map.find(collision.entity2);
+
+    if (body1 != this->entity_to_body_map.end() && body2 != this->entity_to_body_map.end()) {
+      this->merge(body1->second, body2->second);
+    }
+  }
+
+  // counting sort the bodies by their island, numbering islands in order of
+  // their first body so islands come out in the same order every step
+  auto island_indices = std::vector<usize>(count, count);
+  auto island_counts  = std::vector<usize>{};
+
+  for (auto i = usize{0}; i < count; ++i) {
+    auto &island = island_indices[this->find(i)];
+
+    if (island == count) {
+      island = island_counts.size();
+      island_counts.push_back(0);
+    }
+
+    ++island_counts[island];
+  }
+
+  this->island_offsets.resize(island_counts.size() + 1);
+  this->island_offsets[0] = 0;
+  std::partial_sum(island_counts.begin(), island_counts.end(), this->island_offsets.begin() + 1);
+
+  auto next_body = std::vector<usize>(this->island_offsets.begin(), this->island_offsets.end() - 1);
+  this->island_bodies.resize(count);
+  this->body_islands.resize(count);
+
+  for (auto i = usize{0}; i < count; ++i) {
+    const auto island                        = island_indices[this->find(i)];
+    this->body_islands[i]                    = island;
+    this->island_bodies[next_body[island]++] = this->entities[i];
+  }
+}
+
+auto Islands::get_count() const -> usize {
+  return this->island_offsets.empty() ? 0 : this->island_offsets.size() - 1;
+}
+
+auto Islands::get_bodies(usize island) const -> std::span<const Entity> {
+  const auto first = this->island_offsets[island];
+  const auto last  = this->island_offsets[island + 1];
+
+  return std::span<const Entity>{this->island_bodies.data() + first, last - first};
+}
+
+auto Islands::get_island(Entity entity) const -> std::optional<usize> {
+  const auto it = this->entity_to_body_map.find(entity);
+
+  if (it == this->entity_to_body_map.end()) {
+    return std::nullopt;
+  }
+
+  return this->body_islands[it->second];
+}
+
+auto Islands::find(usize body) -> usize {
+  auto root = body;
+
+  while (this->parents[root] != root) {
+    root = this->parents[root];
+  }
+
+  // point everything on the path straight at the root
+  while (this->parents[body] != root) {
+    const auto parent   = this->parents[body];
+    this->parents[body] = root;
+    body                = parent;
+  }
+
+  return root;
+}
+
+auto Islands::merge(usize body1, usize body2) -> void {
+  auto root1 = this->find(body1);
+  auto root2 = this->find(body2);
+
+  if (root1 == root2) {
+    return;
+  }
+
+  // attach the shorter tree under the taller one to keep finds short
+  if (this->ranks[root1] < this->ranks[root2]) {
+    std::swap(root1, root2);
+  }
+
+  this->parents[root2] = root1;
+
+  if (this->ranks[root1] == this->ranks[root2]) {
+    ++this->ranks[root1];
+  }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/ecs/Registry.hpp"
+#include "afk/physics/ContactCache.hpp"
+
+namespace afk {
+  namespace physics {
+    /**
+     * Splits the dynamic rigid bodies into simulation islands: groups of
+     * bodies that are touching each other, directly or through other dynamic
+     * bodies.
+     *
+     * Static bodies never join an island, as they can't carry motion from
+     * one body to another. Bodies in different islands can't affect each
+     * other during a step, so each island can be put to sleep, woken, or
+     * solved on its own.
+     */
+    class Islands {
+    public:
+      /**
+       * Builds the islands from every dynamic rigid body and the contacts
+       * between them.
+       *
+       * @param registry The registry the bodies belong to.
+       * @param contact_cache The contacts between the bodies.
+       */
+      auto build(const afk::ecs::Registry &registry, const ContactCache &contact_cache) -> void;
+
+      /**
+       * Returns the number of islands.
+       *
+       * @return The island count.
+       */
+      auto get_count() const -> usize;
+
+      /**
+       * Returns the bodies in the specified island.
+       *
+       * @param island The island index.
+       * @return The entities of the island's bodies.
+       */
+      auto get_bodies(usize island) const -> std::span<const afk::ecs::Entity>;
+
+      /**
+       * Returns the island the specified body is in.
+       *
+       * @param entity The entity of the body.
+       * @return The island index, or nothing if the body isn't dynamic.
+       */
+      auto get_island(afk::ecs::Entity entity) const -> std::optional<usize>;
+
+    private:
+      /**
+       * Returns the representative of the set containing the specified body,
+       * flattening the path to it along the way.
+       *
+       * @param body The body index.
+       * @return The index of the set's representative body.
+       */
+      auto find(usize body) -> usize;
+
+      /**
+       * Merges the sets containing the specified bodies.
+       *
+       * @param body1 The first body index.
+       * @param body2 The second body index.
+       */
+      auto merge(usize body1, usize body2) -> void;
+
+      /** The dynamic bodies, indexed by the union find. */
+      std::vector<afk::ecs::Entity> entities = {};
+      /** Maps entities to their index in the union find. */
+      std::unordered_map<afk::ecs::Entity, usize> entity_to_body_map = {};
+      /** The parent of each body in the union find. */
+      std::vector<usize> parents = {};
+      /** The upper bound of the height of each set's tree in the union find. */
+      std::vector<u32> ranks = {};
+
+      /** The island of each body in the union find. */
+      std::vector<usize> body_islands = {};
+
+      /** The bodies of every island, stored one island after another. */
+      std::vector<afk::ecs::Entity> island_bodies = {};
+      /** The index of each island's first body, followed by the body count. */
+      std::vector<usize> island_offsets = {};
+    };
+  }
+}
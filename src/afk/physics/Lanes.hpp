@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "afk/NumericTypes.hpp"
+
+// SSE is always available on x86-64, AVX would need every build to opt in
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+  #define AFK_PHYSICS_SSE
+  #include <xmmintrin.h>
+#endif
+
+namespace afk {
+  namespace physics {
+#if defined(AFK_PHYSICS_SSE)
+    /**
+     * A scalar for each of several bodies or pairs, operated on together
+     * with SSE.
+     */
+    struct Lanes {
+      /** The number of scalars. */
+      static constexpr usize WIDTH = 4;
+
+      /** The scalars. */
+      __m128 value;
+    };
+
+    static_assert(sizeof(Lanes) == sizeof(f32) * Lanes::WIDTH);
+
+    /**
+     * Loads lanes from WIDTH consecutive scalars.
+     *
+     * @param source The first scalar, which needn't be aligned.
+     * @return The lanes.
+     */
+    inline auto load(const f32 *source) -> Lanes {
+      return Lanes{_mm_loadu_ps(source)};
+    }
+
+    /**
+     * Stores lanes to WIDTH consecutive scalars.
+     *
+     * @param destination The first scalar, which needn't be aligned.
+     * @param lanes The lanes.
+     */
+    inline auto store(f32 *destination, Lanes lanes) -> void {
+      _mm_storeu_ps(destination, lanes.value);
+    }
+
+    /**
+     * Returns lanes that are all the same scalar.
+     *
+     * @param value The scalar.
+     * @return The lanes.
+     */
+    inline auto splat(f32 value) -> Lanes {
+      return Lanes{_mm_set1_ps(value)};
+    }
+
+    inline auto operator+(Lanes lhs, Lanes rhs) -> Lanes {
+      return Lanes{_mm_add_ps(lhs.value, rhs.value)};
+    }
+
+    inline auto operator-(Lanes lhs, Lanes rhs) -> Lanes {
+      return Lanes{_mm_sub_ps(lhs.value, rhs.value)};
+    }
+
+    inline auto operator*(Lanes lhs, Lanes rhs) -> Lanes {
+      return Lanes{_mm_mul_ps(lhs.value, rhs.value)};
+    }
+
+    inline auto operator/(Lanes lhs, Lanes rhs) -> Lanes {
+      return Lanes{_mm_div_ps(lhs.value, rhs.value)};
+    }
+
+    /**
+     * Returns the square root of each lane.
+     *
+     * @param lanes The lanes.
+     * @return The square roots.
+     */
+    inline auto sqrt(Lanes lanes) -> Lanes {
+      return Lanes{_mm_sqrt_ps(lanes.value)};
+    }
+
+    /**
+     * Returns the smaller scalar of each lane.
+     *
+     * @param lhs The first lanes.
+     * @param rhs The second lanes.
+     * @return The smaller of each.
+     */
+    inline auto min(Lanes lhs, Lanes rhs) -> Lanes {
+      return Lanes{_mm_min_ps(lhs.value, rhs.value)};
+    }
+
+    /**
+     * Returns the larger scalar of each lane.
+     *
+     * @param lhs The first lanes.
+     * @param rhs The second lanes.
+     * @return The larger of each.
+     */
+    inline auto max(Lanes lhs, Lanes rhs) -> Lanes {
+      return Lanes{_mm_max_ps(lhs.value, rhs.value)};
+    }
+
+    /**
+     * Compares each lane.
+     *
+     * @param lhs The first lanes.
+     * @param rhs The second lanes.
+     * @return A bit for each lane, set where the first is less than or equal
+     *         to the second.
+     */
+    inline auto less_equal(Lanes lhs, Lanes rhs) -> u32 {
+      return static_cast<u32>(_mm_movemask_ps(_mm_cmple_ps(lhs.value, rhs.value)));
+    }
+#else
+    /**
+     * A scalar for each of several bodies or pairs, operated on together in
+     * loops the compiler can vectorize.
+     */
+    struct Lanes {
+      /** The number of scalars. */
+      static constexpr usize WIDTH = 4;
+
+      /** The scalars. */
+      std::array<f32, WIDTH> value;
+    };
+
+    /**
+     * Loads lanes from WIDTH consecutive scalars.
+     *
+     * @param source The first scalar.
+     * @return The lanes.
+     */
+    inline auto load(const f32 *source) -> Lanes {
+      auto lanes = Lanes{};
+      std::copy(source, source + Lanes::WIDTH, lanes.value.begin());
+
+      return lanes;
+    }
+
+    /**
+     * Stores lanes to WIDTH consecutive scalars.
+     *
+     * @param destination The first scalar.
+     * @param lanes The lanes.
+     */
+    inline auto store(f32 *destination, Lanes lanes) -> void {
+      std::copy(lanes.value.begin(), lanes.value.end(), destination);
+    }
+
+    /**
+     * Returns lanes that are all the same scalar.
+     *
+     * @param value The scalar.
+     * @return The lanes.
+     */
+    inline auto splat(f32 value) -> Lanes {
+      auto lanes = Lanes{};
+      lanes.value.fill(value);
+
+      return lanes;
+    }
+
+    inline auto operator+(Lanes lhs, Lanes rhs) -> Lanes {
+      for (auto i = usize{0}; i < Lanes::WIDTH; ++i) {
+        lhs.value[i] += rhs.value[i];
+      }
+
+      return lhs;
+    }
+
+    inline auto operator-(Lanes lhs, Lanes rhs) -> Lanes {
+      for (auto i = usize{0}; i < Lanes::WIDTH; ++i) {
+        lhs.value[i] -= rhs.value[i];
+      }
+
+      return lhs;
+    }
+
+    inline auto operator*(Lanes lhs, Lanes rhs) -> Lanes {
+      for (auto i = usize{0}; i < Lanes::WIDTH; ++i) {
+        lhs.value[i] *= rhs.value[i];
+      }
+
+      return lhs;
+    }
+
+    inline auto operator/(Lanes lhs, Lanes rhs) -> Lanes {
+      for (auto i = usize{0}; i < Lanes::WIDTH; ++i) {
+        lhs.value[i] /= rhs.value[i];
+      }
+
+      return lhs;
+    }
+
+    /**
+     * Returns the square root of each lane.
+     *
+     * @param lanes The lanes.
+     * @return The square roots.
+     */
+    inline auto sqrt(Lanes lanes) -> Lanes {
+      for (auto i = usize{0}; i < Lanes::WIDTH; ++i) {
+        lanes.value[i] = std::sqrt(lanes.value[i]);
+      }
+
+      return lanes;
+    }
+
+    /**
+     * Returns the smaller scalar of each lane.
+     *
+     * @param lhs The first lanes.
+     * @param rhs The second lanes.
+     * @return The smaller of each.
+     */
+    inline auto min(Lanes lhs, Lanes rhs) -> Lanes {
+      for (auto i = usize{0}; i < Lanes::WIDTH; ++i) {
+        lhs.value[i] = std::min(lhs.value[i], rhs.value[i]);
+      }
+
+      return lhs;
+    }
+
+    /**
+     * Returns the larger scalar of each lane.
+     *
+     * @param lhs The first lanes.
+     * @param rhs The second lanes.
+     * @return The larger of each.
+     */
+    inline auto max(Lanes lhs, Lanes rhs) -> Lanes {
+      for (auto i = usize{0}; i < Lanes::WIDTH; ++i) {
+        lhs.value[i] = std::max(lhs.value[i], rhs.value[i]);
+      }
+
+      return lhs;
+    }
+
+    /**
+     * Compares each lane.
+     *
+     * @param lhs The first lanes.
+     * @param rhs The second lanes.
+     * @return A bit for each lane, set where the first is less than or equal
+     *         to the second.
+     */
+    inline auto less_equal(Lanes lhs, Lanes rhs) -> u32 {
+      auto mask = u32{0};
+
+      for (auto i = usize{0}; i < Lanes::WIDTH; ++i) {
+        mask |= lhs.value[i] <= rhs.value[i] ? u32{1} << i : u32{0};
+      }
+
+      return mask;
+    }
+#endif
+  }
+}
@@ -0,0 +1,623 @@
+#include "afk/physics/NarrowPhase.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <variant>
+
+#include "afk/debug/Assert.hpp"
+#include "afk/debug/Profiler.hpp"
+#include "afk/physics/Lanes.hpp"
+#include "afk/utility/Visitor.hpp"
+
+using afk::ecs::Entity;
+using afk::physics::ContactBuffer;
+using afk::physics::Lanes;
+using afk::physics::NarrowPhase;
+using afk::physics::WorldBox;
+using afk::physics::WorldShape;
+using afk::physics::WorldSphere;
+
+/** The most points a clipped face can have, as each of its four sides adds at most one. */
+static constexpr usize MAX_CLIP_POINTS = 8;
+
+/** The most contacts kept between two boxes. */
+static constexpr usize MAX_BOX_CONTACTS = 4;
+
+/**
+ * How much less the best axis of a later group must overlap by to be picked
+ * over the best of an earlier group, so the first box's faces are preferred
+ * over the second's, and faces over edges, which keeps the contacts from
+ * flickering between them. Axes within a group are compared exactly.
+ */
+static constexpr f32 RELATIVE_TOLERANCE = 0.98f;
+
+/** See RELATIVE_TOLERANCE. */
+static constexpr f32 ABSOLUTE_TOLERANCE = 0.001f;
+
+/** Below this squared length two box edges are treated as parallel. */
+static constexpr f32 PARALLEL_EPSILON = 1e-6f;
+
+/** A convex polygon, such as a box face being clipped. */
+struct Polygon {
+  /** The corners, in order around the polygon. */
+  std::array<glm::vec3, MAX_CLIP_POINTS> points = {};
+  /** The number of corners. */
+  usize count = 0;
+};
+
+/** The contacts found between two boxes, before being reduced. */
+struct BoxContacts {
+  /** The contacts. */
+  std::array<ContactBuffer::Contact, MAX_CLIP_POINTS> contacts = {};
+  /** The number of contacts. */
+  usize count = 0;
+};
+
+/**
+ * Returns the part of a polygon behind a plane.
+ *
+ * @param polygon The polygon.
+ * @param normal The normal of the plane, facing away from the part kept.
+ * @param offset The distance of the plane from the origin along its normal.
+ * @return The clipped polygon.
+ */
+static auto clip(const Polygon &polygon, const glm::vec3 &normal, f32 offset) -> Polygon {
+  auto clipped = Polygon{};
+
+  for (auto i = usize{0}; i < polygon.count; ++i) {
+    const auto &start         = polygon.points[i];
+    const auto &end           = polygon.points[(i + 1) % polygon.count];
+    const auto start_distance = glm::dot(start, normal) - offset;
+    const auto end_distance   = glm::dot(end, normal) - offset;
+    const auto is_crossing    = (start_distance < 0.0f && end_distance > 0.0f) ||
+                             (start_distance > 0.0f && end_distance < 0.0f);
+
+    if (start_distance <= 0.0f) {
+      clipped.points[clipped.count] = start;
+      ++clipped.count;
+    }
+
+    if (is_crossing) {
+      const auto t                  = start_distance / (start_distance - end_distance);
+      clipped.points[clipped.count] = start + (end - start) * t;
+      ++clipped.count;
+    }
+  }
+
+  afk_assert_debug(clipped.count <= MAX_CLIP_POINTS, "Clipped polygon has too many points");
+
+  return clipped;
+}
+
+/**
+ * Adds up to MAX_BOX_CONTACTS contacts to a contact buffer, keeping the
+ * deepest and then whichever is furthest from those already kept, so the
+ * contacts still cover as much of the touching area as possible.
+ *
+ * @param box_contacts The contacts to pick from.
+ * @param contacts The buffer to add to.
+ */
+static auto add_box_contacts(const BoxContacts &box_contacts, ContactBuffer &contacts) -> void {
+  if (box_contacts.count <= MAX_BOX_CONTACTS) {
+    for (auto i = usize{0}; i < box_contacts.count; ++i) {
+      contacts.add_contact(box_contacts.contacts[i]);
+    }
+
+    return;
+  }
+
+  auto kept    = std::array<usize, MAX_BOX_CONTACTS>{};
+  auto is_kept = std::array<bool, MAX_CLIP_POINTS>{};
+
+  for (auto i = usize{1}; i < box_contacts.count; ++i) {
+    if (box_contacts.contacts[i].penetration_depth >
+        box_contacts.contacts[kept[0]].penetration_depth) {
+      kept[0] = i;
+    }
+  }
+
+  is_kept[kept[0]] = true;
+
+  for (auto k = usize{1}; k < MAX_BOX_CONTACTS; ++k) {
+    auto furthest          = usize{0};
+    auto furthest_distance = -1.0f;
+
+    for (auto i = usize{0}; i < box_contacts.count; ++i) {
+      if (is_kept[i]) {
+        continue;
+      }
+
+      auto distance = std::numeric_limits<f32>::max();
+
+      for (auto j = usize{0}; j < k; ++j) {
+        const auto offset = box_contacts.contacts[i].collider1_point -
+                            box_contacts.contacts[kept[j]].collider1_point;
+        distance = std::min(distance, glm::dot(offset, offset));
+      }
+
+      if (distance > furthest_distance) {
+        furthest          = i;
+        furthest_distance = distance;
+      }
+    }
+
+    kept[k]           = furthest;
+    is_kept[furthest] = true;
+  }
+
+  for (const auto i : kept) {
+    contacts.add_contact(box_contacts.contacts[i]);
+  }
+}
+
+/**
+ * Adds the contacts between two boxes to a contact buffer, if they're touching.
+ *
+ * The axis the boxes overlap least along is found with the separating axis
+ * test. If it's a face normal, the most opposing face of the other box is
+ * clipped against the sides of that face, and every clipped point below it is
+ * a contact. Otherwise the closest points between the two edges are.
+ *
+ * @param entity1 The entity the first box belongs to.
+ * @param box1 The first box.
+ * @param entity2 The entity the second box belongs to.
+ * @param box2 The second box.
+ * @param contacts The buffer to add to.
+ */
+static auto collide_boxes(Entity entity1, const WorldBox &box1, Entity entity2,
+                          const WorldBox &box2, ContactBuffer &contacts) -> void {
+  const auto axes1  = glm::mat3_cast(box1.rotation);
+  const auto axes2  = glm::mat3_cast(box2.rotation);
+  const auto offset = box2.center - box1.center;
+
+  // how far the boxes overlap along an axis, negative if it separates them
+  const auto get_overlap = [&](const glm::vec3 &axis) {
+    const auto radius1 = box1.half_extents.x * std::abs(glm::dot(axes1[0], axis)) +
+                         box1.half_extents.y * std::abs(glm::dot(axes1[1], axis)) +
+                         box1.half_extents.z * std::abs(glm::dot(axes1[2], axis));
+    const auto radius2 = box2.half_extents.x * std::abs(glm::dot(axes2[0], axis)) +
+                         box2.half_extents.y * std::abs(glm::dot(axes2[1], axis)) +
+                         box2.half_extents.z * std::abs(glm::dot(axes2[2], axis));
+
+    return radius1 + radius2 - std::abs(glm::dot(offset, axis));
+  };
+
+  enum class Feature { Face1, Face2, Edges };
+
+  // the axis of least overlap within a group of axes
+  struct Candidate {
+    f32 overlap                   = std::numeric_limits<f32>::max();
+    glm::vec3 axis                = glm::vec3{0.0f};
+    glm::mat3::length_type index1 = 0;
+    glm::mat3::length_type index2 = 0;
+  };
+
+  auto faces1 = Candidate{};
+  auto faces2 = Candidate{};
+  auto edges  = Candidate{};
+
+  // returns false if the axis separates the boxes
+  const auto test_axis = [&](const glm::vec3 &axis, Candidate &candidate,
+                             glm::mat3::length_type axis_index1,
+                             glm::mat3::length_type axis_index2) {
+    const auto overlap = get_overlap(axis);
+
+    if (overlap < 0.0f) {
+      return false;
+    }
+
+    if (overlap < candidate.overlap) {
+      candidate = Candidate{overlap, axis, axis_index1, axis_index2};
+    }
+
+    return true;
+  };
+
+  for (auto i = glm::mat3::length_type{0}; i < 3; ++i) {
+    if (!test_axis(axes1[i], faces1, i, 0)) {
+      return;
+    }
+  }
+
+  for (auto j = glm::mat3::length_type{0}; j < 3; ++j) {
+    if (!test_axis(axes2[j], faces2, 0, j)) {
+      return;
+    }
+  }
+
+  for (auto i = glm::mat3::length_type{0}; i < 3; ++i) {
+    for (auto j = glm::mat3::length_type{0}; j < 3; ++j) {
+      const auto axis   = glm::cross(axes1[i], axes2[j]);
+      const auto length = glm::dot(axis, axis);
+
+      // parallel edges give no new axis, their faces have already been tested
+      if (length < PARALLEL_EPSILON) {
+        continue;
+      }
+
+      if (!test_axis(axis / std::sqrt(length), edges, i, j)) {
+        return;
+      }
+    }
+  }
+
+  // only a clearly better group is picked over an earlier one
+  const auto is_better = [](const Candidate &candidate, const Candidate &best) {
+    return candidate.overlap < best.overlap * RELATIVE_TOLERANCE - ABSOLUTE_TOLERANCE;
+  };
+
+  auto best    = faces1;
+  auto feature = Feature::Face1;
+
+  if (is_better(faces2, best)) {
+    best    = faces2;
+    feature = Feature::Face2;
+  }
+
+  if (is_better(edges, best)) {
+    best    = edges;
+    feature = Feature::Edges;
+  }
+
+  const auto best_overlap = best.overlap;
+  const auto &best_axis   = best.axis;
+  const auto index1       = best.index1;
+  const auto index2       = best.index2;
+
+  // face the normal from the first box to the second
+  const auto normal = glm::dot(best_axis, offset) < 0.0f ? -best_axis : best_axis;
+
+  if (feature == Feature::Edges) {
+    // the edge of each box closest to the other, found by moving from its
+    // centre towards the other box along its other two axes
+    auto point1 = box1.center;
+    auto point2 = box2.center;
+
+    for (auto k = glm::mat3::length_type{0}; k < 3; ++k) {
+      if (k != index1) {
+        const auto sign = glm::dot(axes1[k], normal) > 0.0f ? 1.0f : -1.0f;
+        point1 += axes1[k] * box1.half_extents[k] * sign;
+      }
+
+      if (k != index2) {
+        const auto sign = glm::dot(axes2[k], normal) > 0.0f ? -1.0f : 1.0f;
+        point2 += axes2[k] * box2.half_extents[k] * sign;
+      }
+    }
+
+    // the closest points between the two edges
+    const auto &direction1 = axes1[index1];
+    const auto &direction2 = axes2[index2];
+    const auto extent1     = box1.half_extents[index1];
+    const auto extent2     = box2.half_extents[index2];
+    const auto r           = point1 - point2;
+    const auto b           = glm::dot(direction1, direction2);
+    const auto c           = glm::dot(direction1, r);
+    const auto f           = glm::dot(direction2, r);
+    const auto denominator = 1.0f - b * b;
+
+    auto s = denominator > PARALLEL_EPSILON
+                 ? std::clamp((b * f - c) / denominator, -extent1, extent1)
+                 : 0.0f;
+    const auto t = std::clamp(b * s + f, -extent2, extent2);
+    s            = std::clamp(b * t - c, -extent1, extent1);
+
+    contacts.add_pair(entity1, entity2);
+    contacts.add_contact(ContactBuffer::Contact{point1 + direction1 * s,
+                                                point2 + direction2 * t, normal, best_overlap});
+
+    return;
+  }
+
+  const auto is_reference_first = feature == Feature::Face1;
+  const auto &reference         = is_reference_first ? box1 : box2;
+  const auto &reference_axes    = is_reference_first ? axes1 : axes2;
+  const auto &incident          = is_reference_first ? box2 : box1;
+  const auto &incident_axes     = is_reference_first ? axes2 : axes1;
+  const auto reference_index    = is_reference_first ? index1 : index2;
+
+  // the reference face faces the incident box
+  const auto face_sign =
+      glm::dot(reference_axes[reference_index], is_reference_first ? normal : -normal) > 0.0f
+          ? 1.0f
+          : -1.0f;
+  const auto face_normal = reference_axes[reference_index] * face_sign;
+  const auto face_center =
+      reference.center + face_normal * reference.half_extents[reference_index];
+  const auto u_index = (reference_index + 1) % 3;
+  const auto v_index = (reference_index + 2) % 3;
+  const auto &u      = reference_axes[u_index];
+  const auto &v      = reference_axes[v_index];
+
+  // the incident face is the one facing most against the reference face
+  auto incident_index = glm::mat3::length_type{0};
+
+  for (auto j = glm::mat3::length_type{1}; j < 3; ++j) {
+    if (std::abs(glm::dot(incident_axes[j], face_normal)) >
+        std::abs(glm::dot(incident_axes[incident_index], face_normal))) {
+      incident_index = j;
+    }
+  }
+
+  const auto incident_sign =
+      glm::dot(incident_axes[incident_index], face_normal) > 0.0f ? -1.0f : 1.0f;
+  const auto incident_center = incident.center + incident_axes[incident_index] * incident_sign *
+                                                     incident.half_extents[incident_index];
+  const auto side1 = incident_axes[(incident_index + 1) % 3] *
+                     incident.half_extents[(incident_index + 1) % 3];
+  const auto side2 = incident_axes[(incident_index + 2) % 3] *
+                     incident.half_extents[(incident_index + 2) % 3];
+
+  auto polygon      = Polygon{};
+  polygon.points[0] = incident_center + side1 + side2;
+  polygon.points[1] = incident_center - side1 + side2;
+  polygon.points[2] = incident_center - side1 - side2;
+  polygon.points[3] = incident_center + side1 - side2;
+  polygon.count     = 4;
+
+  // clip the incident face to the sides of the reference face
+  const auto u_center = glm::dot(u, face_center);
+  const auto v_center = glm::dot(v, face_center);
+  polygon = clip(polygon, u, u_center + reference.half_extents[u_index]);
+  polygon = clip(polygon, -u, reference.half_extents[u_index] - u_center);
+  polygon = clip(polygon, v, v_center + reference.half_extents[v_index]);
+  polygon = clip(polygon, -v, reference.half_extents[v_index] - v_center);
+
+  // every clipped point below the reference face is a contact
+  const auto contact_normal = is_reference_first ? face_normal : -face_normal;
+  auto box_contacts         = BoxContacts{};
+
+  for (auto i = usize{0}; i < polygon.count; ++i) {
+    const auto &point = polygon.points[i];
+    const auto depth  = glm::dot(face_center - point, face_normal);
+
+    if (depth < 0.0f) {
+      continue;
+    }
+
+    const auto reference_point = point + face_normal * depth;
+
+    box_contacts.contacts[box_contacts.count] =
+        is_reference_first
+            ? ContactBuffer::Contact{reference_point, point, contact_normal, depth}
+            : ContactBuffer::Contact{point, reference_point, contact_normal, depth};
+    ++box_contacts.count;
+  }
+
+  if (box_contacts.count == 0) {
+    return;
+  }
+
+  contacts.add_pair(entity1, entity2);
+  add_box_contacts(box_contacts, contacts);
+}
+
+auto NarrowPhase::clear() -> void {
+  this->sphere_pairs.clear();
+  this->sphere_box_pairs.clear();
+  this->box_pairs.clear();
+}
+
+auto NarrowPhase::add_pair(Entity entity1, const WorldShape &shape1, Entity entity2,
+                           const WorldShape &shape2) -> void {
+  auto visitor = afk::utility::Visitor{
+      [&](const WorldSphere &sphere1, const WorldSphere &sphere2) {
+        this->sphere_pairs.push_back(SpherePair{entity1, entity2, sphere1, sphere2});
+      },
+      [&](const WorldSphere &sphere, const WorldBox &box) {
+        this->sphere_box_pairs.push_back(SphereBoxPair{entity1, entity2, sphere, box, false});
+      },
+      [&](const WorldBox &box, const WorldSphere &sphere) {
+        this->sphere_box_pairs.push_back(SphereBoxPair{entity2, entity1, sphere, box, true});
+      },
+      [&](const WorldBox &box1, const WorldBox &box2) {
+        this->box_pairs.push_back(BoxPair{entity1, entity2, box1, box2});
+      }};
+
+  std::visit(visitor, shape1, shape2);
+}
+
+auto NarrowPhase::generate(ContactBuffer &contacts) -> void {
+  afk_profile_scope("NarrowPhase::generate");
+
+  this->generate_sphere_contacts(contacts);
+  this->generate_sphere_box_contacts(contacts);
+  this->generate_box_contacts(contacts);
+}
+
+auto NarrowPhase::generate_sphere_contacts(ContactBuffer &contacts) -> void {
+  enum Stream : usize { OFFSET_X, OFFSET_Y, OFFSET_Z, RADIUS, STREAM_COUNT };
+
+  const auto count    = this->sphere_pairs.size();
+  const auto capacity = this->reset_streams(count, STREAM_COUNT);
+  const auto stream   = [&](Stream s) { return this->streams.data() + s * capacity; };
+
+  for (auto i = usize{0}; i < count; ++i) {
+    const auto &pair  = this->sphere_pairs[i];
+    const auto offset = pair.sphere2.center - pair.sphere1.center;
+
+    stream(OFFSET_X)[i] = offset.x;
+    stream(OFFSET_Y)[i] = offset.y;
+    stream(OFFSET_Z)[i] = offset.z;
+    stream(RADIUS)[i]   = pair.sphere1.radius + pair.sphere2.radius;
+  }
+
+  for (auto first = usize{0}; first < count; first += Lanes::WIDTH) {
+    const auto x      = load(stream(OFFSET_X) + first);
+    const auto y      = load(stream(OFFSET_Y) + first);
+    const auto z      = load(stream(OFFSET_Z) + first);
+    const auto radius = load(stream(RADIUS) + first);
+
+    // the padding lanes are all zero, so would count as touching
+    const auto valid = count - first < Lanes::WIDTH ? (u32{1} << (count - first)) - 1 : ~u32{0};
+    auto touching    = less_equal(x * x + y * y + z * z, radius * radius) & valid;
+
+    for (auto lane = usize{0}; touching != 0; ++lane, touching >>= 1) {
+      if ((touching & 1) == 0) {
+        continue;
+      }
+
+      const auto &pair    = this->sphere_pairs[first + lane];
+      const auto offset   = pair.sphere2.center - pair.sphere1.center;
+      const auto distance = glm::length(offset);
+
+      // concentric spheres have no direction between them, so pick one
+      const auto normal = distance > 0.0f ? offset / distance : glm::vec3{0.0f, 1.0f, 0.0f};
+
+      contacts.add_pair(pair.entity1, pair.entity2);
+      contacts.add_contact(ContactBuffer::Contact{
+          pair.sphere1.center + normal * pair.sphere1.radius,
+          pair.sphere2.center - normal * pair.sphere2.radius, normal,
+          pair.sphere1.radius + pair.sphere2.radius - distance});
+    }
+  }
+}
+
+auto NarrowPhase::generate_sphere_box_contacts(ContactBuffer &contacts) -> void {
+  enum Stream : usize {
+    OFFSET_X,
+    OFFSET_Y,
+    OFFSET_Z,
+    /** The box's axes, by column then row. */
+    AXIS_00,
+    AXIS_01,
+    AXIS_02,
+    AXIS_10,
+    AXIS_11,
+    AXIS_12,
+    AXIS_20,
+    AXIS_21,
+    AXIS_22,
+    HALF_EXTENT_X,
+    HALF_EXTENT_Y,
+    HALF_EXTENT_Z,
+    RADIUS,
+    STREAM_COUNT
+  };
+
+  const auto count    = this->sphere_box_pairs.size();
+  const auto capacity = this->reset_streams(count, STREAM_COUNT);
+  const auto stream   = [&](Stream s) { return this->streams.data() + s * capacity; };
+
+  for (auto i = usize{0}; i < count; ++i) {
+    const auto &pair  = this->sphere_box_pairs[i];
+    const auto axes   = glm::mat3_cast(pair.box.rotation);
+    const auto offset = pair.sphere.center - pair.box.center;
+
+    stream(OFFSET_X)[i]      = offset.x;
+    stream(OFFSET_Y)[i]      = offset.y;
+    stream(OFFSET_Z)[i]      = offset.z;
+    stream(HALF_EXTENT_X)[i] = pair.box.half_extents.x;
+    stream(HALF_EXTENT_Y)[i] = pair.box.half_extents.y;
+    stream(HALF_EXTENT_Z)[i] = pair.box.half_extents.z;
+    stream(RADIUS)[i]        = pair.sphere.radius;
+
+    for (auto column = usize{0}; column < 3; ++column) {
+      for (auto row = usize{0}; row < 3; ++row) {
+        stream(static_cast<Stream>(AXIS_00 + column * 3 + row))[i] =
+            axes[static_cast<glm::mat3::length_type>(column)]
+                [static_cast<glm::vec3::length_type>(row)];
+      }
+    }
+  }
+
+  const auto zero = splat(0.0f);
+
+  for (auto first = usize{0}; first < count; first += Lanes::WIDTH) {
+    const auto lanes = [&](Stream s) { return load(stream(s) + first); };
+
+    const auto x      = lanes(OFFSET_X);
+    const auto y      = lanes(OFFSET_Y);
+    const auto z      = lanes(OFFSET_Z);
+    const auto radius = lanes(RADIUS);
+
+    // the distance from the sphere's centre to the closest point in the box,
+    // worked out in the box's local space where it's axis aligned
+    const auto get_distance = [&](Stream axis_x, Stream half_extent) {
+      const auto local = lanes(axis_x) * x + lanes(static_cast<Stream>(axis_x + 1)) * y +
+                         lanes(static_cast<Stream>(axis_x + 2)) * z;
+      const auto extent = lanes(half_extent);
+
+      return local - min(max(local, zero - extent), extent);
+    };
+
+    const auto dx = get_distance(AXIS_00, HALF_EXTENT_X);
+    const auto dy = get_distance(AXIS_10, HALF_EXTENT_Y);
+    const auto dz = get_distance(AXIS_20, HALF_EXTENT_Z);
+
+    // the padding lanes are all zero, so would count as touching
+    const auto valid = count - first < Lanes::WIDTH ? (u32{1} << (count - first)) - 1 : ~u32{0};
+    auto touching    = less_equal(dx * dx + dy * dy + dz * dz, radius * radius) & valid;
+
+    for (auto lane = usize{0}; touching != 0; ++lane, touching >>= 1) {
+      if ((touching & 1) == 0) {
+        continue;
+      }
+
+      const auto &pair   = this->sphere_box_pairs[first + lane];
+      const auto &sphere = pair.sphere;
+      const auto &box    = pair.box;
+      const auto local   = glm::inverse(box.rotation) * (sphere.center - box.center);
+      const auto closest = glm::clamp(local, -box.half_extents, box.half_extents);
+
+      auto normal    = glm::vec3{0.0f};
+      auto box_point = glm::vec3{0.0f};
+      auto depth     = 0.0f;
+
+      if (closest != local) {
+        // the centre is outside the box, so the contact is at the closest point
+        box_point           = box.center + box.rotation * closest;
+        const auto offset   = box_point - sphere.center;
+        const auto distance = glm::length(offset);
+
+        normal = distance > 0.0f ? offset / distance : glm::vec3{0.0f, 1.0f, 0.0f};
+        depth  = sphere.radius - distance;
+      } else {
+        // the centre is inside the box, so push it out through the nearest face
+        auto axis = glm::vec3::length_type{0};
+
+        for (auto i = glm::vec3::length_type{1}; i < 3; ++i) {
+          if (box.half_extents[i] - std::abs(local[i]) <
+              box.half_extents[axis] - std::abs(local[axis])) {
+            axis = i;
+          }
+        }
+
+        auto face_normal  = glm::vec3{0.0f};
+        face_normal[axis] = local[axis] < 0.0f ? -1.0f : 1.0f;
+        face_normal       = box.rotation * face_normal;
+
+        const auto face_distance = box.half_extents[axis] - std::abs(local[axis]);
+
+        normal    = -face_normal;
+        box_point = sphere.center + face_normal * face_distance;
+        depth     = sphere.radius + face_distance;
+      }
+
+      const auto sphere_point = sphere.center + normal * sphere.radius;
+
+      if (pair.is_flipped) {
+        contacts.add_pair(pair.box_entity, pair.sphere_entity);
+        contacts.add_contact(ContactBuffer::Contact{box_point, sphere_point, -normal, depth});
+      } else {
+        contacts.add_pair(pair.sphere_entity, pair.box_entity);
+        contacts.add_contact(ContactBuffer::Contact{sphere_point, box_point, normal, depth});
+      }
+    }
+  }
+}
+
+auto NarrowPhase::generate_box_contacts(ContactBuffer &contacts) -> void {
+  for (const auto &pair : this->box_pairs) {
+    collide_boxes(pair.entity1, pair.box1, pair.entity2, pair.box2, contacts);
+  }
+}
+
+auto NarrowPhase::reset_streams(usize count, usize stream_count) -> usize {
+  const auto capacity = (count + Lanes::WIDTH - 1) / Lanes::WIDTH * Lanes::WIDTH;
+  this->streams.assign(capacity * stream_count, 0.0f);
+
+  return capacity;
+}
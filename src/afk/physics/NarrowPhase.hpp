@@ -0,0 +1,132 @@
+#pragma once
+
+#include <vector>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/physics/ContactBuffer.hpp"
+#include "afk/physics/Geometry.hpp"
+
+namespace afk {
+  namespace physics {
+    /**
+     * Generates the contacts between candidate pairs of spheres and boxes.
+     *
+     * Pairs are sorted by their shapes as they're added. Sphere-sphere and
+     * sphere-box pairs are then tested several at a time from packed arrays,
+     * and only the pairs that touch go on to have their contact worked out.
+     * Box-box pairs are tested one at a time with the separating axis test,
+     * clipping the faces against each other for up to four contacts.
+     *
+     * Every contact is oriented from the first entity of its pair to the
+     * second, with the normal pointing from the first to the second.
+     */
+    class NarrowPhase {
+    public:
+      /**
+       * Removes every pair, keeping the memory for the next step.
+       */
+      auto clear() -> void;
+
+      /**
+       * Adds a pair of shapes that may be touching.
+       *
+       * @param entity1 The entity the first shape belongs to.
+       * @param shape1 The first shape.
+       * @param entity2 The entity the second shape belongs to.
+       * @param shape2 The second shape.
+       */
+      auto add_pair(afk::ecs::Entity entity1, const WorldShape &shape1,
+                    afk::ecs::Entity entity2, const WorldShape &shape2) -> void;
+
+      /**
+       * Adds the contacts of every pair that is touching to a contact buffer.
+       *
+       * @param contacts The buffer to add to.
+       */
+      auto generate(ContactBuffer &contacts) -> void;
+
+    private:
+      /** A pair of spheres. */
+      struct SpherePair {
+        /** The entity the first sphere belongs to. */
+        afk::ecs::Entity entity1 = {};
+        /** The entity the second sphere belongs to. */
+        afk::ecs::Entity entity2 = {};
+        /** The first sphere. */
+        WorldSphere sphere1 = {};
+        /** The second sphere. */
+        WorldSphere sphere2 = {};
+      };
+
+      /** A pair of a sphere and a box. */
+      struct SphereBoxPair {
+        /** The entity the sphere belongs to. */
+        afk::ecs::Entity sphere_entity = {};
+        /** The entity the box belongs to. */
+        afk::ecs::Entity box_entity = {};
+        /** The sphere. */
+        WorldSphere sphere = {};
+        /** The box. */
+        WorldBox box = {};
+        /** If the box was the first shape of the pair. */
+        bool is_flipped = false;
+      };
+
+      /** A pair of boxes. */
+      struct BoxPair {
+        /** The entity the first box belongs to. */
+        afk::ecs::Entity entity1 = {};
+        /** The entity the second box belongs to. */
+        afk::ecs::Entity entity2 = {};
+        /** The first box. */
+        WorldBox box1 = {};
+        /** The second box. */
+        WorldBox box2 = {};
+      };
+
+      /**
+       * Adds the contacts of every touching sphere-sphere pair.
+       *
+       * @param contacts The buffer to add to.
+       */
+      auto generate_sphere_contacts(ContactBuffer &contacts) -> void;
+
+      /**
+       * Adds the contacts of every touching sphere-box pair.
+       *
+       * @param contacts The buffer to add to.
+       */
+      auto generate_sphere_box_contacts(ContactBuffer &contacts) -> void;
+
+      /**
+       * Adds the contacts of every touching box-box pair.
+       *
+       * @param contacts The buffer to add to.
+       */
+      auto generate_box_contacts(ContactBuffer &contacts) -> void;
+
+      /**
+       * Resizes the packed arrays to hold the specified number of pairs,
+       * padded to a multiple of the lane width, zeroing every element.
+       *
+       * @param count The number of pairs.
+       * @param stream_count The number of arrays.
+       * @return The number of elements in each array.
+       */
+      auto reset_streams(usize count, usize stream_count) -> usize;
+
+      /** The sphere-sphere pairs. */
+      std::vector<SpherePair> sphere_pairs = {};
+
+      /** The sphere-box pairs. */
+      std::vector<SphereBoxPair> sphere_box_pairs = {};
+
+      /** The box-box pairs. */
+      std::vector<BoxPair> box_pairs = {};
+
+      /** Packed arrays of the pairs being tested, one after another. */
+      std::vector<f32> streams = {};
+    };
+  }
+}
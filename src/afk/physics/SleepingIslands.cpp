@@ -0,0 +1,201 @@
+#include "afk/physics/SleepingIslands.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+#include "afk/debug/Profiler.hpp"
+#include "afk/ecs/component/ColliderComponent.hpp"
+#include "afk/ecs/component/PhysicsComponent.hpp"
+
+using afk::ecs::Entity;
+using afk::ecs::Registry;
+using afk::ecs::component::ColliderComponent;
+using afk::ecs::component::PhysicsComponent;
+using afk::physics::Islands;
+using afk::physics::SleepingIslands;
+
+auto SleepingIslands::wake(Registry &registry, const Islands &islands, bool is_waking_all,
+                           const Callback &on_change) -> void {
+  afk_profile_scope("SleepingIslands::wake");
+
+  for (auto i = usize{0}; i < islands.get_count(); ++i) {
+    const auto bodies  = islands.get_bodies(i);
+    auto is_any_awake  = false;
+    auto is_any_asleep = false;
+
+    for (const auto entity : bodies) {
+      const auto &physics = registry.get<PhysicsComponent>(entity);
+
+      // queued forces are meant to move a body, so they count as being awake
+      const auto is_pushed = physics.external_forces != glm::vec3{0.0f} ||
+                             physics.external_torques != glm::vec3{0.0f};
+
+      is_any_awake  = is_any_awake || !physics.is_sleeping || is_pushed;
+      is_any_asleep = is_any_asleep || physics.is_sleeping;
+    }
+
+    if (is_any_asleep && (is_any_awake || is_waking_all)) {
+      for (const auto entity : bodies) {
+        this->wake_body(registry, entity, on_change);
+      }
+    }
+  }
+
+  // sleeping bodies don't test contacts against what they rest on, so they
+  // can't notice it going away, and would otherwise stay asleep in mid air
+  const auto is_body = [&registry](Entity entity) {
+    return registry.valid(entity) && registry.has<PhysicsComponent>(entity);
+  };
+  const auto is_collider = [&registry](Entity entity) {
+    return registry.valid(entity) && registry.has<ColliderComponent>(entity);
+  };
+
+  for (auto i = usize{0}; i < this->islands.size(); ++i) {
+    const auto &island = this->islands[i];
+
+    if (!std::all_of(island.bodies.begin(), island.bodies.end(), is_body) ||
+        !std::all_of(island.supports.begin(), island.supports.end(), is_collider)) {
+      this->wake_island(registry, i, on_change);
+    }
+  }
+}
+
+auto SleepingIslands::sleep(Registry &registry, const Islands &islands,
+                            const ContactCache &contact_cache, f32 dt, const Callback &on_change)
+    -> void {
+  afk_profile_scope("SleepingIslands::sleep");
+
+  static constexpr auto linear_threshold =
+      SleepingIslands::LINEAR_VELOCITY * SleepingIslands::LINEAR_VELOCITY;
+  static constexpr auto angular_threshold =
+      SleepingIslands::ANGULAR_VELOCITY * SleepingIslands::ANGULAR_VELOCITY;
+
+  // maps each island falling asleep this step to its sleeping island
+  auto falling_asleep = std::unordered_map<usize, usize>{};
+
+  for (auto i = usize{0}; i < islands.get_count(); ++i) {
+    const auto bodies = islands.get_bodies(i);
+
+    // an island can only sleep once every body in it has been still for long enough
+    auto min_sleep_time = std::numeric_limits<f32>::max();
+
+    for (const auto entity : bodies) {
+      auto &physics = registry.get<PhysicsComponent>(entity);
+
+      if (physics.is_sleeping) {
+        continue;
+      }
+
+      if (glm::dot(physics.linear_velocity, physics.linear_velocity) > linear_threshold ||
+          glm::dot(physics.angular_velocity, physics.angular_velocity) > angular_threshold) {
+        physics.sleep_time = 0.0f;
+      } else {
+        physics.sleep_time += dt;
+      }
+
+      min_sleep_time = std::min(min_sleep_time, physics.sleep_time);
+    }
+
+    // islands that are already asleep are left alone
+    if (min_sleep_time == std::numeric_limits<f32>::max() ||
+        min_sleep_time < SleepingIslands::TIME_TO_SLEEP) {
+      continue;
+    }
+
+    auto index = this->islands.size();
+
+    if (this->free_islands.empty()) {
+      this->islands.emplace_back();
+    } else {
+      index = this->free_islands.back();
+      this->free_islands.pop_back();
+    }
+
+    auto &island = this->islands[index];
+    island.bodies.assign(bodies.begin(), bodies.end());
+    falling_asleep.insert({i, index});
+
+    for (const auto entity : bodies) {
+      SleepingIslands::set_is_sleeping(registry, entity, true, on_change);
+      this->entity_to_island_map.insert_or_assign(entity, index);
+    }
+  }
+
+  if (falling_asleep.empty()) {
+    return;
+  }
+
+  // keep what each island is resting on, the contacts with it stop being tested once it's asleep
+  for (const auto &collision : contact_cache.get_collisions()) {
+    const auto island1 = islands.get_island(collision.entity1);
+    const auto island2 = islands.get_island(collision.entity2);
+
+    if (island1 == island2) {
+      continue;
+    }
+
+    if (island1.has_value() && falling_asleep.count(*island1) == 1) {
+      this->islands[falling_asleep.at(*island1)].supports.push_back(collision.entity2);
+    }
+
+    if (island2.has_value() && falling_asleep.count(*island2) == 1) {
+      this->islands[falling_asleep.at(*island2)].supports.push_back(collision.entity1);
+    }
+  }
+}
+
+auto SleepingIslands::wake_body(Registry &registry, Entity entity, const Callback &on_change)
+    -> void {
+  const auto it = this->entity_to_island_map.find(entity);
+
+  // bodies can start asleep, without an island to wake alongside them
+  if (it == this->entity_to_island_map.end()) {
+    SleepingIslands::set_is_sleeping(registry, entity, false, on_change);
+    return;
+  }
+
+  this->wake_island(registry, it->second, on_change);
+}
+
+auto SleepingIslands::wake_island(Registry &registry, usize index, const Callback &on_change)
+    -> void {
+  auto &island = this->islands[index];
+
+  if (island.bodies.empty()) {
+    return;
+  }
+
+  for (const auto entity : island.bodies) {
+    this->entity_to_island_map.erase(entity);
+
+    if (registry.valid(entity) && registry.has<PhysicsComponent>(entity)) {
+      SleepingIslands::set_is_sleeping(registry, entity, false, on_change);
+    }
+  }
+
+  island.bodies.clear();
+  island.supports.clear();
+  this->free_islands.push_back(index);
+}
+
+auto SleepingIslands::set_is_sleeping(Registry &registry, Entity entity, bool is_sleeping,
+                                      const Callback &on_change) -> void {
+  auto &physics = registry.get<PhysicsComponent>(entity);
+
+  if (physics.is_sleeping == is_sleeping) {
+    return;
+  }
+
+  physics.is_sleeping = is_sleeping;
+  physics.sleep_time  = 0.0f;
+
+  // anything left over would be applied all at once on waking
+  if (is_sleeping) {
+    physics.linear_velocity  = glm::vec3{0.0f};
+    physics.angular_velocity = glm::vec3{0.0f};
+  }
+
+  on_change(entity, is_sleeping);
+}
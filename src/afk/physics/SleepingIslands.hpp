@@ -0,0 +1,115 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/ecs/Registry.hpp"
+#include "afk/physics/ContactCache.hpp"
+#include "afk/physics/Islands.hpp"
+
+namespace afk {
+  namespace physics {
+    /**
+     * Puts islands to sleep once every body in them has been still for long
+     * enough, and wakes them again when something touches or pushes them.
+     *
+     * Contacts between resting colliders aren't tested, so the islands
+     * rebuilt on each step no longer hold a sleeping island together. Each
+     * island is kept as it was when it fell asleep, along with everything it
+     * was resting on, so it's always woken whole.
+     */
+    class SleepingIslands {
+    public:
+      /** Called with a body and whether it's now asleep, whenever it falls asleep or wakes. */
+      using Callback = std::function<void(afk::ecs::Entity, bool)>;
+
+      /** The fastest a body can move and still be still enough to sleep, in metres per second. */
+      static constexpr f32 LINEAR_VELOCITY = 0.05f;
+
+      /** The fastest a body can spin and still be still enough to sleep, in radians per second. */
+      static constexpr f32 ANGULAR_VELOCITY = 0.05f;
+
+      /** How long every body in an island must be still for before it sleeps, in seconds. */
+      static constexpr f32 TIME_TO_SLEEP = 0.5f;
+
+      /**
+       * Wakes every sleeping island touched by an awake body, or with a body
+       * that has forces queued on it. An island is also woken when one of its
+       * bodies, or anything it was resting on, is destroyed.
+       *
+       * @param registry The registry the bodies belong to.
+       * @param islands The islands of the bodies, built from the last step's
+       *                contacts.
+       * @param is_waking_all Wake every island, such as when gravity changes.
+       * @param on_change Called with each body that wakes.
+       */
+      auto wake(afk::ecs::Registry &registry, const Islands &islands, bool is_waking_all,
+                const Callback &on_change) -> void;
+
+      /**
+       * Puts each island to sleep once every body in it has been still for
+       * long enough, zeroing their velocities.
+       *
+       * @param registry The registry the bodies belong to.
+       * @param islands The islands of the bodies.
+       * @param contact_cache The contacts the islands were built from.
+       * @param dt The time advanced by, in seconds.
+       * @param on_change Called with each body that falls asleep.
+       */
+      auto sleep(afk::ecs::Registry &registry, const Islands &islands,
+                 const ContactCache &contact_cache, f32 dt, const Callback &on_change) -> void;
+
+    private:
+      /** The bodies that fell asleep together, kept until they're woken. */
+      struct Island {
+        /** The bodies of the island. */
+        std::vector<afk::ecs::Entity> bodies = {};
+        /** Everything the bodies were touching outside of the island when it fell asleep. */
+        std::vector<afk::ecs::Entity> supports = {};
+      };
+
+      /**
+       * Wakes a sleeping body, along with every body of the island it fell
+       * asleep in.
+       *
+       * @param registry The registry the body belongs to.
+       * @param entity The entity of the body.
+       * @param on_change Called with each body that wakes.
+       */
+      auto wake_body(afk::ecs::Registry &registry, afk::ecs::Entity entity,
+                     const Callback &on_change) -> void;
+
+      /**
+       * Wakes every body of a sleeping island that still exists, then frees
+       * the island.
+       *
+       * @param registry The registry the bodies belong to.
+       * @param index The index of the sleeping island.
+       * @param on_change Called with each body that wakes.
+       */
+      auto wake_island(afk::ecs::Registry &registry, usize index, const Callback &on_change)
+          -> void;
+
+      /**
+       * Puts a body to sleep or wakes it.
+       *
+       * @param registry The registry the body belongs to.
+       * @param entity The entity of the body.
+       * @param is_sleeping Should the body be asleep?
+       * @param on_change Called if the body falls asleep or wakes.
+       */
+      static auto set_is_sleeping(afk::ecs::Registry &registry, afk::ecs::Entity entity,
+                                  bool is_sleeping, const Callback &on_change) -> void;
+
+      /** The sleeping islands, empty if not in use. */
+      std::vector<Island> islands = {};
+      /** The indices of the sleeping islands not in use, reused before new ones are added. */
+      std::vector<usize> free_islands = {};
+      /** Maps each sleeping body to the island it fell asleep in. */
+      std::unordered_map<afk::ecs::Entity, usize> entity_to_island_map = {};
+    };
+  }
+}
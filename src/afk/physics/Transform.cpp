@@ -44,4 +44,14 @@ auto Transform::combined_transform_to_mat4(const Transform &child_transform) ->
   return matrix;
 }
 
+auto afk::physics::interpolate(const Transform &from, const Transform &to, f32 alpha)
+    -> Transform {
+  auto transform        = Transform{};
+  transform.translation = glm::mix(from.translation, to.translation, alpha);
+  transform.scale       = glm::mix(from.scale, to.scale, alpha);
+  transform.rotation    = glm::slerp(from.rotation, to.rotation, alpha);
+
+  return transform;
+}
+
 /// @endcond
@@ -3,6 +3,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include "afk/NumericTypes.hpp"
+
 namespace afk {
   namespace physics {
     /**
@@ -39,5 +41,15 @@ namespace afk {
        */
       auto combined_transform_to_mat4(const Transform& child_transform) -> glm::mat4;
     };
+
+    /**
+     * Interpolates between two transforms.
+     *
+     * @param from The transform at alpha 0.
+     * @param to The transform at alpha 1.
+     * @param alpha The interpolation factor, between 0 and 1.
+     * @return The interpolated transform.
+     */
+    auto interpolate(const Transform &from, const Transform &to, f32 alpha) -> Transform;
   }
 }
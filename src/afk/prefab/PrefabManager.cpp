@@ -3,11 +3,17 @@
 #include <filesystem>
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include <glm/glm.hpp>
 
+#include "afk/Engine.hpp"
+#include "afk/World.hpp"
 #include "afk/debug/Assert.hpp"
+#include "afk/debug/Profiler.hpp"
 #include "afk/ecs/component/Component.hpp"
+#include "afk/ecs/component/PreviousTransformComponent.hpp"
+#include "afk/ecs/system/PhysicsSystem.hpp"
 #include "afk/io/Json.hpp"
 #include "afk/io/JsonSerialization.hpp"
 #include "afk/io/Log.hpp"
@@ -32,18 +38,49 @@ using afk::utility::Visitor;
 using namespace afk::ecs::component;
 
 auto PrefabManager::load_prefabs_from_dir(const path &dir_path) -> void {
+  afk_profile_scope("PrefabManager::load_prefabs_from_dir");
+
   const auto prefab_dir = afk::io::get_resource_path(dir_path);
   auto &afk             = afk::Engine::get();
 
+  auto paths = std::vector<path>{};
+
   for (const auto &entry : directory_iterator{prefab_dir}) {
-    const auto path = entry.path();
-    auto file       = ifstream{path};
-    auto json       = Json{};
-    auto prefab     = Prefab{};
+    paths.push_back(entry.path());
+  }
+
+  // read every prefab file up front so their models can be loaded together
+  auto jsons = std::vector<Json>(paths.size());
+  afk.job_manager.parallel_for(
+      paths.size(),
+      [&](usize i) {
+        auto file = ifstream{paths[i]};
+        afk_assert(file.is_open(), "Unable to open prefab file "s + paths[i].string());
+        file >> jsons[i];
+      },
+      1);
+
+  auto model_paths = std::vector<path>{};
+
+  for (const auto &json : jsons) {
+    const auto &components = json.at("components");
 
-    afk_assert(file.is_open(), "Unable to open prefab file "s + path.string());
+    if (components.count("Models") == 1) {
+      for (const auto &[_, model_json] : components.at("Models").items()) {
+        model_paths.push_back(
+            afk::io::get_resource_path(model_json.at("file_path").get<string>()));
+      }
+    }
+  }
 
-    file >> json;
+  // models are loaded in parallel, so initializing the Models components below
+  // only has to look up the loaded handles
+  afk.renderer.load_models(model_paths);
+
+  for (auto i = usize{0}; i < paths.size(); ++i) {
+    const auto &path = paths[i];
+    const auto &json = jsons[i];
+    auto prefab      = Prefab{};
 
     prefab.name     = json.at("name").get<string>();
     auto components = json.at("components");
@@ -61,7 +98,7 @@ auto PrefabManager::load_prefabs_from_dir(const path &dir_path) -> void {
                              [j](ColliderComponent &c) {
                                c = j.get<ColliderComponent>();
                              },
-                             [j, &components, &afk](PhysicsComponent &c) {
+                             [j, &components](PhysicsComponent &c) {
                                c = j.get<PhysicsComponent>();
                                afk_assert(components.count("Transform") == 1, "prefab must have a Transform component to instantiate a physics component");
                                afk_assert(
@@ -75,7 +112,7 @@ auto PrefabManager::load_prefabs_from_dir(const path &dir_path) -> void {
                                const auto transform =
                                    components.at("Transform").get<TransformComponent>();
 
-                               afk.physics_system.initialize_physics_component(
+                               afk::ecs::system::PhysicsSystem::initialize_physics_component(
                                    c, collider, transform);
                              },
                              [](auto) { afk_unreachable(); }};
@@ -113,7 +150,7 @@ auto PrefabManager::initialize_component(const Json &json, Component &component)
           const auto path =
               afk::io::get_resource_path(model_json.at("file_path").get<string>());
           auto transform = model_json.at("Transform").get<TransformComponent>();
-          c.models.push_back({afk.renderer.get_model(path), std::move(transform)});
+          c.models.push_back({&afk.renderer.get_model(path), std::move(transform)});
         }
       },
       [](auto) {}};
@@ -121,9 +158,9 @@ auto PrefabManager::initialize_component(const Json &json, Component &component)
   std::visit(visitor, component);
 }
 
-auto PrefabManager::instantiate_prefab(const Prefab &prefab) const -> Entity {
-  auto &afk      = afk::Engine::get();
-  auto &registry = afk.ecs.registry;
+auto PrefabManager::instantiate_prefab(const Prefab &prefab, afk::World &world) const
+    -> Entity {
+  auto &registry = world.ecs.registry;
 
   auto entity = registry.create();
 
@@ -133,12 +170,12 @@ auto PrefabManager::instantiate_prefab(const Prefab &prefab) const -> Entity {
                          [&registry, entity](TransformComponent component) {
                            registry.emplace<TransformComponent>(entity, component);
                          },
-                         [&registry, entity, &prefab, &afk](ColliderComponent component) {
+                         [&registry, entity, &prefab, &world](ColliderComponent component) {
                            afk_assert(prefab.components.count("Transform") == 1, "prefab must have a Transform component to instantiate a collider component");
                            // check that the "Transform" component is a transform component, then use it when instantiating the collider
                            auto transform_visitor = Visitor{
-                               [entity, &afk, &component](TransformComponent transform) {
-                                 afk.collision_system.instantiate_collider_component(
+                               [entity, &world, &component](TransformComponent transform) {
+                                 world.collision_system.instantiate_collider_component(
                                      entity, component, transform);
                                },
                                [](auto) { afk_unreachable(); }};
@@ -156,11 +193,25 @@ auto PrefabManager::instantiate_prefab(const Prefab &prefab) const -> Entity {
     std::visit(visitor, component);
   }
 
+  // static rigid bodies never move, so they never need testing against each other
+  if (registry.has<PhysicsComponent, ColliderComponent>(entity) &&
+      registry.get<PhysicsComponent>(entity).is_static) {
+    world.collision_system.set_is_resting(entity, true);
+  }
+
+  // dynamic rigid bodies are interpolated between ticks when drawn
+  if (registry.has<PhysicsComponent, TransformComponent>(entity) &&
+      !registry.get<PhysicsComponent>(entity).is_static) {
+    registry.emplace<PreviousTransformComponent>(
+        entity, registry.get<TransformComponent>(entity));
+  }
+
   return entity;
 }
 
-auto PrefabManager::instantiate_prefab(const string &name) const -> Entity {
-  return this->instantiate_prefab(this->prefab_map.at(name));
+auto PrefabManager::instantiate_prefab(const string &name, afk::World &world) const
+    -> Entity {
+  return this->instantiate_prefab(this->prefab_map.at(name), world);
 }
 
 auto PrefabManager::initialize() -> void {
@@ -10,6 +10,8 @@
 #include "afk/prefab/Prefab.hpp"
 
 namespace afk {
+  class World;
+
   namespace prefab {
     /**
      * Manages prefabs.
@@ -36,17 +38,21 @@ namespace afk {
        * Assumes prefab is not already instantiated
        *
        * @param name The prefab name.
+       * @param world The world to create the entity in.
        * @return The created entity.
        */
-      auto instantiate_prefab(const std::string &name) const -> afk::ecs::Entity;
+      auto instantiate_prefab(const std::string &name, afk::World &world) const
+          -> afk::ecs::Entity;
 
       /**
        * Instantiates the specified  prefab and returns the created entity.
        *
        * @param prefab The prefab to instantiate.
+       * @param world The world to create the entity in.
        * @return The created entity.
        */
-      auto instantiate_prefab(const Prefab &prefab) const -> afk::ecs::Entity;
+      auto instantiate_prefab(const Prefab &prefab, afk::World &world) const
+          -> afk::ecs::Entity;
 
       /**
        * Initializes this config manager.
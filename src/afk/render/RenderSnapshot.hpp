@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "afk/physics/Transform.hpp"
+#include "afk/render/Renderer.hpp"
+
+namespace afk {
+  namespace render {
+    /**
+     * A copy of everything needed to draw a frame. Drawing only reads the
+     * snapshot, which allows a frame to be drawn while the simulation advances.
+     */
+    struct RenderSnapshot {
+      /**
+       * A single model to draw.
+       */
+      struct DrawItem {
+        /**
+         * The model to draw, owned by the renderer rather than the component,
+         * as the simulation may move the component while the snapshot is drawn.
+         */
+        const ModelHandle *model_handle = nullptr;
+        /** The model's world transform. */
+        physics::Transform transform = {};
+      };
+
+      /** A collection of draw items. */
+      using DrawItems = std::vector<DrawItem>;
+
+      /** The models to draw. */
+      DrawItems draw_items = {};
+      /** The shader program to draw the models with. */
+      ShaderProgramHandle shader_program = {};
+      /** The camera projection matrix. */
+      glm::mat4 projection = {};
+      /** The camera view matrix. */
+      glm::mat4 view = {};
+    };
+  }
+}
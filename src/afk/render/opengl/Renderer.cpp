@@ -1,5 +1,6 @@
 #include "afk/render/opengl/Renderer.hpp"
 
+#include <algorithm>
 #include <filesystem>
 #include <limits>
 #include <memory>
@@ -22,6 +23,7 @@
 #include "afk/Engine.hpp"
 #include "afk/NumericTypes.hpp"
 #include "afk/debug/Assert.hpp"
+#include "afk/debug/Profiler.hpp"
 #include "afk/io/Log.hpp"
 #include "afk/io/Path.hpp"
 #include "afk/io/Time.hpp"
@@ -29,6 +31,7 @@
 #include "afk/render/Bone.hpp"
 #include "afk/render/Mesh.hpp"
 #include "afk/render/Model.hpp"
+#include "afk/render/RenderSnapshot.hpp"
 #include "afk/render/Shader.hpp"
 #include "afk/render/ShaderProgram.hpp"
 #include "afk/render/Texture.hpp"
@@ -96,7 +99,7 @@ static auto resize_window_callback([[maybe_unused]] GLFWwindow *window,
 }
 
 Renderer::Renderer()
-  : glfw_context(), models(0, PathHash{}, PathEquals{}),
+  : models(0, PathHash{}, PathEquals{}),
     textures(0, PathHash{}, PathEquals{}), shaders(0, PathHash{}, PathEquals{}),
     shader_programs(0, PathHash{}, PathEquals{}) {}
 
@@ -105,6 +108,8 @@ auto Renderer::initialize() -> void {
 
   afk_assert(!this->is_initialized, "Renderer already initialized");
 
+  this->glfw_context.emplace();
+
   const auto &config = afk.config_manager.config;
 
   const auto antialiasing_samples =
@@ -145,6 +150,18 @@ auto Renderer::initialize() -> void {
   afk::io::log << afk::io::get_date_time() << "Renderer subsystem initialized\n";
 }
 
+auto Renderer::initialize_headless() -> void {
+  afk_assert(!this->is_initialized, "Renderer already initialized");
+
+  this->is_headless    = true;
+  this->is_initialized = true;
+  afk::io::log << afk::io::get_date_time() << "Renderer subsystem initialized (headless)\n";
+}
+
+auto Renderer::get_is_headless() const -> bool {
+  return this->is_headless;
+}
+
 auto Renderer::set_option(GLenum option, bool state) const -> void {
   if (state) {
     glEnable(option);
@@ -188,13 +205,50 @@ auto Renderer::swap_buffers() -> void {
 auto Renderer::get_model(const path &file_path) -> const ModelHandle & {
   const auto is_loaded = this->models.count(file_path) == 1;
 
-  if (!is_loaded) {
+  if (!is_loaded && this->is_headless) {
+    // Nothing will ever be drawn, so skip loading the model entirely.
+    this->models[file_path] = ModelHandle{};
+  } else if (!is_loaded) {
     this->models[file_path] = this->load_model(Model{file_path});
   }
 
   return this->models.at(file_path);
 }
 
+auto Renderer::load_models(const vector<path> &file_paths) -> void {
+  afk_profile_scope("Renderer::load_models");
+
+  auto unloaded_paths = vector<path>{};
+
+  for (const auto &file_path : file_paths) {
+    const auto is_queued = std::find(unloaded_paths.begin(), unloaded_paths.end(),
+                                     file_path) != unloaded_paths.end();
+
+    if (this->models.count(file_path) == 0 && !is_queued) {
+      unloaded_paths.push_back(file_path);
+    }
+  }
+
+  // Nothing will ever be drawn, so skip loading the models entirely.
+  if (this->is_headless) {
+    for (const auto &file_path : unloaded_paths) {
+      this->models[file_path] = ModelHandle{};
+    }
+
+    return;
+  }
+
+  // Reading a model doesn't touch OpenGL, only uploading it does.
+  auto loaded_models = vector<Model>(unloaded_paths.size());
+  Engine::get().job_manager.parallel_for(
+      unloaded_paths.size(),
+      [&](usize i) { loaded_models[i] = Model{unloaded_paths[i]}; }, 1);
+
+  for (auto i = usize{0}; i < unloaded_paths.size(); ++i) {
+    this->models[unloaded_paths[i]] = this->load_model(loaded_models[i]);
+  }
+}
+
 auto Renderer::get_texture(const path &file_path) -> const TextureHandle & {
   const auto is_loaded = this->textures.count(file_path) == 1;
 
@@ -251,7 +305,29 @@ auto Renderer::draw_model(const ModelHandle &model, const ShaderProgramHandle &s
   glPolygonMode(GL_FRONT_AND_BACK, this->wireframe_enabled ? GL_LINE : GL_FILL);
   this->use_shader(shader_program);
   this->setup_view(shader_program);
+  this->draw_meshes(model, shader_program, std::move(transform));
+}
+
+auto Renderer::draw_snapshot(const RenderSnapshot &snapshot) const -> void {
+  const auto &shader_program = snapshot.shader_program;
+
+  glPolygonMode(GL_FRONT_AND_BACK, this->wireframe_enabled ? GL_LINE : GL_FILL);
+  this->use_shader(shader_program);
+  this->set_uniform(shader_program, "u_matrices.projection", snapshot.projection);
+  this->set_uniform(shader_program, "u_matrices.view", snapshot.view);
+
+  for (const auto &draw_item : snapshot.draw_items) {
+    // models given only a transform, such as those set by a scene, have nothing loaded to draw
+    if (draw_item.model_handle == nullptr) {
+      continue;
+    }
+
+    this->draw_meshes(*draw_item.model_handle, shader_program, draw_item.transform);
+  }
+}
 
+auto Renderer::draw_meshes(const ModelHandle &model, const ShaderProgramHandle &shader_program,
+                           Transform transform) const -> void {
   for (const auto &mesh : model.meshes) {
     auto material_bound = vector<bool>(static_cast<usize>(Texture::Type::Count));
 
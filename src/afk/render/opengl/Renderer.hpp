@@ -33,6 +33,7 @@ namespace afk {
     struct Model;
     struct Texture;
     struct ShaderProgram;
+    struct RenderSnapshot;
 
     namespace opengl {
       /**
@@ -115,8 +116,8 @@ namespace afk {
         using WindowHandle = Window::weak_type;
 
       private:
-        /** The GLFW context. */
-        GlfwContext glfw_context = {};
+        /** The GLFW context, only created when a window is needed. */
+        std::optional<GlfwContext> glfw_context = std::nullopt;
 
       public:
         /** The window being drawn to. */
@@ -133,6 +134,21 @@ namespace afk {
          */
         auto initialize() -> void;
 
+        /**
+         * Initializes this renderer without a window or graphics context.
+         *
+         * Resources requested from a headless renderer are never loaded, the
+         * returned handles are empty and nothing may be drawn with them.
+         */
+        auto initialize_headless() -> void;
+
+        /**
+         * Returns if this renderer is running without a window.
+         *
+         * @return True if this renderer is headless.
+         */
+        auto get_is_headless() const -> bool;
+
         /**
          * Sets a specified OpenGL option to the specified state.
          *
@@ -182,6 +198,14 @@ namespace afk {
         auto draw_model(const ModelHandle &model, const ShaderProgramHandle &shader_program,
                         physics::Transform transform) const -> void;
 
+        /**
+         * Draws every model in the specified snapshot, using the snapshot's
+         * camera rather than the current one.
+         *
+         * @param snapshot The snapshot to draw.
+         */
+        auto draw_snapshot(const RenderSnapshot &snapshot) const -> void;
+
         auto draw_wireframe_mesh(const WireframeMesh &mesh,
                                  const ShaderProgramHandle &shader_program) const -> void;
 
@@ -215,13 +239,23 @@ namespace afk {
 
         /**
          * Returns a model handle corresponding to the specified model path,
-         * if the model is not loaded it is loaded then returned.
+         * if the model is not loaded it is loaded then returned. Models are
+         * never unloaded, so the handle stays valid for the renderer's lifetime.
          *
          * @param file_path The model path.
          * @return The loaded model handle.
          */
         auto get_model(const std::filesystem::path &file_path) -> const ModelHandle &;
 
+        /**
+         * Loads each of the specified model files that isn't already loaded.
+         * The files are read and processed in parallel, then uploaded to the
+         * GPU one at a time on the calling thread.
+         *
+         * @param file_paths The model paths.
+         */
+        auto load_models(const std::vector<std::filesystem::path> &file_paths) -> void;
+
         /**
          * Returns a texture handle corresponding to the specified texture path,
          * if the model is not loaded it is loaded then returned.
@@ -347,6 +381,17 @@ namespace afk {
         auto get_shader_programs() const -> const ShaderPrograms &;
 
       private:
+        /**
+         * Draws each mesh of the specified model, assuming the shader program
+         * and view are already set up.
+         *
+         * @param model The model to draw.
+         * @param shader_program The shader program to use.
+         * @param transform The model transformation.
+         */
+        auto draw_meshes(const ModelHandle &model, const ShaderProgramHandle &shader_program,
+                         physics::Transform transform) const -> void;
+
         /** The OpenGL major version being used. */
         static constexpr i32 opengl_major_version = 4;
         /** The OpenGL minor version being used. */
@@ -354,6 +399,8 @@ namespace afk {
 
         /** Is the renderer initialized? */
         bool is_initialized = false;
+        /** Is the renderer running without a window? */
+        bool is_headless = false;
         /** Is the wireframe enabled? */
         bool wireframe_enabled = false;
 
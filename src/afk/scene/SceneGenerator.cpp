@@ -0,0 +1,261 @@
+#include "afk/scene/SceneGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "afk/debug/Assert.hpp"
+#include "afk/debug/Profiler.hpp"
+#include "afk/ecs/component/Component.hpp"
+#include "afk/io/JsonSerialization.hpp"
+#include "afk/utility/Visitor.hpp"
+
+using namespace std::string_literals;
+using std::string;
+using std::vector;
+
+using afk::io::Json;
+using afk::prefab::Prefab;
+using afk::scene::SceneGenerator;
+using afk::utility::Visitor;
+using namespace afk::ecs::component;
+
+/**
+ * An instance to be placed in the generated scene.
+ */
+struct Instance {
+  /** The instance position. */
+  glm::vec3 translation = {};
+  /** The instance's initial linear velocity. */
+  glm::vec3 linear_velocity = {};
+};
+
+/**
+ * Returns the number of instances along each side of a square holding the
+ * specified number of instances.
+ *
+ * @param count The number of instances.
+ * @return The side length.
+ */
+static auto get_square_side(i32 count) -> i32 {
+  return std::max(1, static_cast<i32>(std::ceil(std::sqrt(static_cast<f32>(count)))));
+}
+
+/**
+ * Returns the number of instances along each side of a cube holding the
+ * specified number of instances.
+ *
+ * @param count The number of instances.
+ * @return The side length.
+ */
+static auto get_cube_side(i32 count) -> i32 {
+  return std::max(1, static_cast<i32>(std::ceil(std::cbrt(static_cast<f32>(count)))));
+}
+
+auto SceneGenerator::parse_layout(const string &name) -> Layout {
+  if (name == "stack") {
+    return Layout::Stack;
+  } else if (name == "pile") {
+    return Layout::Pile;
+  } else if (name == "grid") {
+    return Layout::Grid;
+  } else if (name == "rain") {
+    return Layout::Rain;
+  }
+
+  afk_assert(false, "Unknown scene layout '"s + name + "'"s);
+  afk_unreachable();
+}
+
+auto SceneGenerator::get_name(const Settings &settings) -> string {
+  auto layout = string{};
+
+  switch (settings.layout) {
+    case Layout::Stack: layout = "stack"; break;
+    case Layout::Pile: layout = "pile"; break;
+    case Layout::Grid: layout = "grid"; break;
+    case Layout::Rain: layout = "rain"; break;
+  }
+
+  return layout + "_"s + settings.prefab + "_"s + std::to_string(settings.count);
+}
+
+auto SceneGenerator::get_half_extents(const Prefab &prefab) -> glm::vec3 {
+  const auto &transform = std::get<TransformComponent>(prefab.components.at("Transform"));
+  const auto &collider  = std::get<ColliderComponent>(prefab.components.at("Collider"));
+
+  auto half_extents = glm::vec3{0.0f};
+
+  for (const auto &body : collider.colliders) {
+    const auto &scale = body.transform.scale;
+
+    auto visitor = Visitor{
+        [&scale](const afk::physics::shape::Box &shape) { return shape * scale; },
+        [&scale](const afk::physics::shape::Sphere &shape) {
+          return glm::vec3{shape * std::max({scale.x, scale.y, scale.z})};
+        }};
+
+    // rotation is ignored, which is fine for the axis aligned prefabs this is used with
+    const auto extents = glm::abs(body.transform.translation) + std::visit(visitor, body.shape);
+    half_extents       = glm::max(half_extents, extents);
+  }
+
+  return half_extents * transform.scale;
+}
+
+auto SceneGenerator::generate(const Settings &settings, const Prefab &prefab) -> Json {
+  afk_profile_scope("SceneGenerator::generate");
+
+  afk_assert(settings.count > 0, "Generated scenes need at least one instance");
+  afk_assert(settings.static_ratio >= 0.0f && settings.static_ratio <= 1.0f,
+             "Static ratio must be between 0 and 1");
+  afk_assert(prefab.components.count("Transform") == 1 &&
+                 prefab.components.count("Collider") == 1 &&
+                 prefab.components.count("Physics") == 1,
+             "Prefab '"s + prefab.name + "' needs a transform, collider and physics component"s);
+
+  const auto size  = SceneGenerator::get_half_extents(prefab) * 2.0f;
+  const auto count = settings.count;
+
+  auto random    = std::mt19937{settings.seed};
+  auto instances = vector<Instance>{};
+  instances.reserve(static_cast<usize>(count));
+
+  switch (settings.layout) {
+    case Layout::Grid: {
+      // leave half an instance between each instance so nothing touches
+      const auto side    = get_square_side(count);
+      const auto spacing = size * 1.5f;
+      const auto offset  = static_cast<f32>(side - 1) * 0.5f;
+
+      for (auto i = i32{0}; i < count; ++i) {
+        const auto x = static_cast<f32>(i % side) - offset;
+        const auto z = static_cast<f32>(i / side) - offset;
+        instances.push_back({glm::vec3{x * spacing.x, size.y * 0.5f, z * spacing.z}});
+      }
+      break;
+    }
+    case Layout::Stack: {
+      // each column rests on the ground, and each instance on the one below it
+      const auto columns = (count + SceneGenerator::STACK_HEIGHT - 1) / SceneGenerator::STACK_HEIGHT;
+      const auto side    = get_square_side(columns);
+      const auto spacing = size * 1.5f;
+      const auto offset  = static_cast<f32>(side - 1) * 0.5f;
+
+      for (auto i = i32{0}; i < count; ++i) {
+        const auto column = i / SceneGenerator::STACK_HEIGHT;
+        const auto level  = i % SceneGenerator::STACK_HEIGHT;
+        const auto x      = static_cast<f32>(column % side) - offset;
+        const auto z      = static_cast<f32>(column / side) - offset;
+        const auto y      = (static_cast<f32>(level) + 0.5f) * size.y;
+        instances.push_back({glm::vec3{x * spacing.x, y, z * spacing.z}});
+      }
+      break;
+    }
+    case Layout::Pile: {
+      // pack instances slightly closer than their size so every instance
+      // starts out overlapping its neighbours
+      const auto side    = get_cube_side(count);
+      const auto spacing = size * 0.9f;
+      const auto offset  = static_cast<f32>(side - 1) * 0.5f;
+      auto jitter        = std::uniform_real_distribution<f32>{-0.05f, 0.05f};
+
+      for (auto i = i32{0}; i < count; ++i) {
+        const auto x     = static_cast<f32>(i % side) - offset;
+        const auto z     = static_cast<f32>((i / side) % side) - offset;
+        const auto y     = static_cast<f32>(i / (side * side)) + 0.5f;
+        const auto noise = glm::vec3{jitter(random), jitter(random), jitter(random)} * size;
+        instances.push_back({glm::vec3{x, y, z} * spacing + noise});
+      }
+      break;
+    }
+    case Layout::Rain: {
+      // scatter instances through a volume roughly twice as sparse as a pile
+      const auto extent = static_cast<f32>(get_cube_side(count)) * size * 2.0f;
+      auto x            = std::uniform_real_distribution<f32>{-extent.x * 0.5f, extent.x * 0.5f};
+      auto y            = std::uniform_real_distribution<f32>{size.y * 4.0f, size.y * 4.0f + extent.y};
+      auto z            = std::uniform_real_distribution<f32>{-extent.z * 0.5f, extent.z * 0.5f};
+      auto fall_speed   = std::uniform_real_distribution<f32>{0.0f, 10.0f};
+
+      for (auto i = i32{0}; i < count; ++i) {
+        const auto translation = glm::vec3{x(random), y(random), z(random)};
+        instances.push_back({translation, glm::vec3{0.0f, -fall_speed(random), 0.0f}});
+      }
+      break;
+    }
+  }
+
+  // the lowest instances are made static, so static instances end up at the
+  // base of stacks and piles rather than floating above dynamic ones
+  std::stable_sort(instances.begin(), instances.end(), [](const auto &a, const auto &b) {
+    return a.translation.y < b.translation.y;
+  });
+
+  const auto static_count = static_cast<i32>(
+      std::lround(static_cast<f32>(count) * settings.static_ratio));
+  const auto &transform = std::get<TransformComponent>(prefab.components.at("Transform"));
+
+  auto json     = Json{};
+  json["name"]  = SceneGenerator::get_name(settings);
+  auto entities = Json::array();
+
+  for (auto i = i32{0}; i < count; ++i) {
+    const auto &instance = instances[static_cast<usize>(i)];
+
+    auto entity             = Json{};
+    entity["name"]          = prefab.name;
+    auto &components        = entity["components"];
+    components["Transform"] = Json{{"translation", instance.translation},
+                                   {"scale", transform.scale},
+                                   {"rotation", glm::vec3{0.0f}}};
+
+    if (i < static_count) {
+      components["Physics"] = Json{{"is_static", true}};
+    } else {
+      components["Physics"] = Json{{"is_static", false},
+                                   {"linear_dampening", 0.1f},
+                                   {"angular_dampening", 0.1f},
+                                   {"linear_velocity", instance.linear_velocity}};
+    }
+
+    entities.push_back(std::move(entity));
+  }
+
+  // the ground's top is at zero, where the lowest instances rest, and it's
+  // twice as thick as an instance so fast instances don't pass straight through it
+  auto footprint_min = glm::vec3{std::numeric_limits<f32>::max()};
+  auto footprint_max = glm::vec3{std::numeric_limits<f32>::lowest()};
+
+  for (const auto &instance : instances) {
+    footprint_min = glm::min(footprint_min, instance.translation);
+    footprint_max = glm::max(footprint_max, instance.translation);
+  }
+
+  const auto margin       = size * SceneGenerator::GROUND_MARGIN;
+  const auto ground_scale = glm::vec3{(footprint_max.x - footprint_min.x) * 0.5f + margin.x, size.y,
+                                      (footprint_max.z - footprint_min.z) * 0.5f + margin.z};
+  const auto ground_translation =
+      glm::vec3{(footprint_min.x + footprint_max.x) * 0.5f, -size.y,
+                (footprint_min.z + footprint_max.z) * 0.5f};
+
+  // the ground prefab is a static unit box, both its model and its collider,
+  // so scaling it stretches both to the ground's half extents
+  auto ground                    = Json{};
+  ground["name"]                 = SceneGenerator::GROUND_PREFAB;
+  auto &ground_components        = ground["components"];
+  ground_components["Transform"] = Json{{"translation", ground_translation},
+                                        {"scale", ground_scale},
+                                        {"rotation", glm::vec3{0.0f}}};
+  ground_components["Physics"]   = Json{{"is_static", true}};
+
+  entities.push_back(std::move(ground));
+
+  json["entities"] = std::move(entities);
+
+  return json;
+}
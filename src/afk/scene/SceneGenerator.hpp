@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/io/Json.hpp"
+#include "afk/prefab/Prefab.hpp"
+
+namespace afk {
+  namespace scene {
+    /**
+     * Generates scenes made of many instances of a single prefab, for
+     * finding how the engine scales with the number of entities.
+     *
+     * Every generated scene has a static ground beneath the instances, made
+     * from the ground prefab, so instances have something to rest on
+     * regardless of the static ratio.
+     */
+    class SceneGenerator {
+    public:
+      /**
+       * Denotes how the instances are laid out.
+       */
+      enum class Layout {
+        /** Columns of instances resting on top of each other. */
+        Stack,
+        /** A dense, jittered block of overlapping instances. */
+        Pile,
+        /** A flat grid of instances that don't touch. */
+        Grid,
+        /** Instances scattered through the air, falling. */
+        Rain,
+      };
+
+      /**
+       * Encapsulates what to generate.
+       */
+      struct Settings {
+        /** How the instances are laid out. */
+        Layout layout = Layout::Grid;
+        /** The name of the prefab to instantiate. */
+        std::string prefab = "box";
+        /** The number of instances. */
+        i32 count = 1000;
+        /**
+         * The fraction of instances which are static. The lowest instances
+         * are made static first, so static instances support dynamic ones.
+         */
+        f32 static_ratio = 0.0f;
+        /** The seed used for any randomness, the same seed gives the same scene. */
+        u32 seed = 0;
+      };
+
+      /** The number of instances in each column of the stack layout. */
+      static constexpr i32 STACK_HEIGHT = 10;
+
+      /** The name of the prefab the ground is made from, a static unit box. */
+      static constexpr const char *GROUND_PREFAB = "ground";
+
+      /** How far the ground extends past the instances on each side, in instances. */
+      static constexpr f32 GROUND_MARGIN = 4.0f;
+
+      /**
+       * Parses a layout name, one of stack, pile, grid or rain.
+       *
+       * @param name The layout name.
+       * @return The layout.
+       */
+      static auto parse_layout(const std::string &name) -> Layout;
+
+      /**
+       * Returns the name of the scene generated with the specified settings.
+       *
+       * @param settings The generation settings.
+       * @return The scene name.
+       */
+      static auto get_name(const Settings &settings) -> std::string;
+
+      /**
+       * Generates a scene in the same JSON format as the scene files.
+       *
+       * @param settings The generation settings.
+       * @param prefab The prefab to instantiate, which must have a collider
+       * and physics component.
+       * @return The scene JSON.
+       */
+      static auto generate(const Settings &settings, const afk::prefab::Prefab &prefab)
+          -> afk::io::Json;
+
+    private:
+      /**
+       * Returns the half extents of a box that bounds each of the specified
+       * prefab's colliders, centred on the prefab's origin.
+       *
+       * @param prefab The prefab.
+       * @return The bounding half extents.
+       */
+      static auto get_half_extents(const afk::prefab::Prefab &prefab) -> glm::vec3;
+    };
+  }
+}
@@ -4,10 +4,13 @@
 #include <string>
 #include <unordered_map>
 
+#include "afk/io/Json.hpp"
 #include "afk/io/Unicode.hpp"
 #include "afk/scene/Scene.hpp"
 
 namespace afk {
+  class World;
+
   namespace scene {
     class SceneManager {
     public:
@@ -22,12 +25,20 @@ namespace afk {
        */
       auto initialize() -> void;
 
+      /**
+       * Adds a scene that wasn't loaded from a file, such as a generated one.
+       *
+       * @param json The scene JSON, in the same format as the scene files.
+       */
+      auto add_scene(const afk::io::Json &json) -> void;
+
       /**
        * Instantiates all prefabs contained the specified scene and destroys all current entities.
        *
        * @param name The scene name.
+       * @param world The world to instantiate the scene in.
        */
-      auto instantiate_scene(const std::string &name) const -> void;
+      auto instantiate_scene(const std::string &name, afk::World &world) const -> void;
 
       /** The map of loaded scenes. */
       SceneMap scene_map = {};
@@ -43,6 +54,24 @@ namespace afk {
        */
       auto load_scenes_from_dir(const std::filesystem::path &dir_path = afk::io::to_cstr(SCENE_DIR))
           -> void;
+
+      /**
+       * Loads the specified scene file. Only reads the prefab map, so scenes
+       * can be loaded concurrently.
+       *
+       * @param file_path The scene file path.
+       * @return The loaded scene.
+       */
+      static auto load_scene(const std::filesystem::path &file_path) -> afk::scene::Scene;
+
+      /**
+       * Parses the specified scene JSON. Only reads the prefab map, so scenes
+       * can be parsed concurrently.
+       *
+       * @param json The scene JSON.
+       * @return The parsed scene.
+       */
+      static auto parse_scene(const afk::io::Json &json) -> afk::scene::Scene;
     };
   }
 }
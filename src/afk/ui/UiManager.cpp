@@ -1,7 +1,14 @@
 #include "afk/ui/UiManager.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <ctime>
 #include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <imgui/examples/imgui_impl_glfw.h>
@@ -10,6 +17,7 @@
 
 #include "afk/Engine.hpp"
 #include "afk/debug/Assert.hpp"
+#include "afk/debug/Profiler.hpp"
 #include "afk/io/Log.hpp"
 #include "afk/io/Path.hpp"
 #include "afk/io/Time.hpp"
@@ -26,6 +34,11 @@ using std::filesystem::path;
 using WindowHandle = afk::render::Renderer::WindowHandle;
 
 UiManager::~UiManager() {
+  // the UI is never initialized when running headless
+  if (!this->is_initialized) {
+    return;
+  }
+
   ImGui_ImplOpenGL3_Shutdown();
   ImGui_ImplGlfw_Shutdown();
   ImGui::DestroyContext();
@@ -85,6 +98,7 @@ auto UiManager::draw() -> void {
   this->draw_about();
   this->draw_log();
   this->draw_model_viewer();
+  this->draw_profiler();
 
   if (this->show_imgui) {
     ImGui::ShowDemoWindow(&this->show_imgui);
@@ -121,7 +135,7 @@ auto UiManager::draw_menu_bar() -> void {
       for (auto it = scene_map.begin(); it != scene_map.end(); ++it) {
         const auto &key = it->first;
         if (ImGui::MenuItem(key.c_str())) {
-          scene_manager.instantiate_scene(key);
+          scene_manager.instantiate_scene(key, afk.world);
         }
       }
       ImGui::EndMenu();
@@ -134,8 +148,11 @@ auto UiManager::draw_menu_bar() -> void {
       if (ImGui::MenuItem("Model viewer", nullptr, this->show_model_viewer)) {
         this->show_model_viewer = !this->show_model_viewer;
       }
-      if (ImGui::MenuItem("Toggle Gravity", nullptr, afk.gravity_enabled)) {
-        afk.gravity_enabled = !afk.gravity_enabled;
+      if (ImGui::MenuItem("Profiler", nullptr, this->show_profiler)) {
+        this->show_profiler = !this->show_profiler;
+      }
+      if (ImGui::MenuItem("Toggle Gravity", nullptr, afk.world.gravity_enabled)) {
+        afk.world.gravity_enabled = !afk.world.gravity_enabled;
       }
       if (ImGui::MenuItem("Toggle Wireframe", nullptr, afk.renderer.get_wireframe())) {
         afk.renderer.set_wireframe(!afk.renderer.get_wireframe());
@@ -351,3 +368,119 @@ auto UiManager::draw_model_viewer() -> void {
   }
   ImGui::End();
 }
+
+auto UiManager::draw_profiler() -> void {
+  if (!this->show_profiler) {
+    return;
+  }
+
+  ImGui::SetNextWindowSize({900, 400}, ImGuiCond_FirstUseEver);
+
+  if (ImGui::Begin("Profiler", &this->show_profiler)) {
+#ifndef AFK_PROFILER
+    ImGui::TextWrapped(
+        "The profiler was compiled out, build with -D Profiler=ON to enable it.");
+#else
+    auto &profiler = afk::debug::profiler;
+
+    auto is_paused = profiler.get_is_paused();
+    if (ImGui::Checkbox("Pause", &is_paused)) {
+      profiler.set_is_paused(is_paused);
+    }
+
+    ImGui::SameLine();
+    if (ImGui::Button("Export trace")) {
+      auto t  = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+      auto ss = std::ostringstream{};
+      ss << "log/" << std::put_time(std::localtime(&t), "%FT%H%M%S") << "-trace.json";
+
+      const auto file_path = afk::io::get_resource_path(ss.str());
+      profiler.export_chrome_trace(file_path);
+      afk::io::log << afk::io::get_date_time() << "Exported profiler trace to "
+                   << file_path.lexically_relative(afk::io::get_resource_path()) << '\n';
+    }
+
+    const auto frames = profiler.get_frames();
+
+    // how many frames before the latest complete frame to show
+    static auto frame_offset = 0;
+    const auto max_offset    = std::max(static_cast<i32>(frames.size()) - 1, 0);
+    frame_offset             = std::min(frame_offset, max_offset);
+
+    ImGui::SameLine();
+    ImGui::SliderInt("Frames ago", &frame_offset, 0, max_offset);
+
+    if (frames.empty()) {
+      ImGui::Text("No frames recorded yet");
+    } else {
+      const auto &frame = frames[frames.size() - 1 - static_cast<usize>(frame_offset)];
+      const auto frame_duration = std::max(static_cast<f32>(frame.end - frame.start), 1.0f);
+      const auto threads        = profiler.get_threads(frame.start, frame.end);
+
+      ImGui::Text("Frame time %.3f ms", static_cast<f64>(frame_duration) / 1e6);
+      ImGui::Separator();
+
+      ImGui::BeginChild("timeline", {0, 0}, false, ImGuiWindowFlags_HorizontalScrollbar);
+
+      auto *draw_list        = ImGui::GetWindowDrawList();
+      const auto label_width = 120.0f;
+      const auto row_height  = ImGui::GetTextLineHeightWithSpacing();
+      const auto text_color  = ImGui::GetColorU32(ImGuiCol_Text);
+
+      for (const auto &thread : threads) {
+        if (thread.samples.empty()) {
+          continue;
+        }
+
+        auto max_depth = u32{0};
+        for (const auto &sample : thread.samples) {
+          max_depth = std::max(max_depth, sample.depth);
+        }
+
+        const auto origin = ImGui::GetCursorScreenPos();
+        const auto width  = std::max(ImGui::GetContentRegionAvail().x - label_width, 1.0f);
+        const auto height = static_cast<f32>(max_depth + 1) * row_height;
+
+        // reserve the thread's rows, then draw into them
+        ImGui::Dummy({label_width + width, height});
+        ImGui::Separator();
+        draw_list->AddText(origin, text_color, thread.name.c_str());
+
+        for (const auto &sample : thread.samples) {
+          // samples may have started before or ended after the frame
+          const auto to_x = [&](i64 time) {
+            const auto t = std::clamp(static_cast<f32>(time - frame.start) / frame_duration,
+                                      0.0f, 1.0f);
+            return origin.x + label_width + t * width;
+          };
+
+          const auto top_left     = ImVec2{to_x(sample.start),
+                                       origin.y + static_cast<f32>(sample.depth) * row_height};
+          const auto bottom_right = ImVec2{std::max(to_x(sample.end), top_left.x + 1.0f),
+                                           top_left.y + row_height - 1.0f};
+
+          // colour by name so a scope keeps its colour between frames
+          const auto hue =
+              static_cast<f32>(std::hash<std::string_view>{}(sample.name) % 360) / 360.0f;
+          draw_list->AddRectFilled(top_left, bottom_right, ImColor::HSV(hue, 0.5f, 0.6f));
+
+          draw_list->PushClipRect(top_left, bottom_right, true);
+          draw_list->AddText({top_left.x + 2.0f, top_left.y}, text_color, sample.name);
+          draw_list->PopClipRect();
+
+          if (ImGui::IsMouseHoveringRect(top_left, bottom_right)) {
+            ImGui::BeginTooltip();
+            ImGui::Text("%s", sample.name);
+            ImGui::Text("%.3f ms", static_cast<f64>(sample.end - sample.start) / 1e6);
+            ImGui::EndTooltip();
+          }
+        }
+      }
+
+      ImGui::EndChild();
+    }
+#endif
+  }
+
+  ImGui::End();
+}
@@ -69,6 +69,8 @@ namespace afk {
       bool show_log = false;
       /** Should the model viewer window be shown? */
       bool show_model_viewer = false;
+      /** Should the profiler window be shown? */
+      bool show_profiler = false;
       /** Is the UI manager initialized? */
       bool is_initialized = false;
       /** The UI scaling factor, where 1.0 is unscaled. */
@@ -106,6 +108,12 @@ namespace afk {
        * Draws the model viewer window.
        */
       auto draw_model_viewer() -> void;
+
+      /**
+       * Draws the profiler window, showing a timeline of each thread's
+       * scopes during a recent frame.
+       */
+      auto draw_profiler() -> void;
     };
   }
 }
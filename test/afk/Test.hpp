@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/ecs/Registry.hpp"
+#include "afk/ecs/component/PhysicsComponent.hpp"
+#include "afk/ecs/component/TransformComponent.hpp"
+#include "afk/physics/ContactBuffer.hpp"
+
+namespace afk {
+  namespace test {
+    /** How far apart two values can be and still be treated as equal. */
+    constexpr f32 EPSILON = 1e-4f;
+
+    /** Entities used by the tests, which don't need a registry. */
+    constexpr auto ENTITY_A = afk::ecs::Entity{1};
+    constexpr auto ENTITY_B = afk::ecs::Entity{2};
+    constexpr auto ENTITY_C = afk::ecs::Entity{3};
+
+    /** No rotation. */
+    inline const auto IDENTITY = glm::quat{1.0f, 0.0f, 0.0f, 0.0f};
+
+    /**
+     * Returns if two values are equal to within EPSILON.
+     *
+     * @param lhs The first value.
+     * @param rhs The second value.
+     * @return If they're equal.
+     */
+    inline auto is_near(f32 lhs, f32 rhs) -> bool {
+      return std::abs(lhs - rhs) <= EPSILON;
+    }
+
+    /**
+     * Returns if each component of two vectors is equal to within EPSILON.
+     *
+     * @param lhs The first vector.
+     * @param rhs The second vector.
+     * @return If they're equal.
+     */
+    inline auto is_near(const glm::vec3 &lhs, const glm::vec3 &rhs) -> bool {
+      return afk::test::is_near(lhs.x, rhs.x) && afk::test::is_near(lhs.y, rhs.y) &&
+             afk::test::is_near(lhs.z, rhs.z);
+    }
+
+    /**
+     * Returns a rotation about an axis.
+     *
+     * @param degrees The angle, in degrees.
+     * @param axis The axis.
+     * @return The rotation.
+     */
+    inline auto rotate(f32 degrees, const glm::vec3 &axis) -> glm::quat {
+      return glm::angleAxis(glm::radians(degrees), axis);
+    }
+
+    /**
+     * Returns a contact at the origin, facing up, told apart from others by
+     * its depth.
+     *
+     * @param depth The penetration depth.
+     * @return The contact.
+     */
+    inline auto make_contact(f32 depth) -> afk::physics::ContactBuffer::Contact {
+      return afk::physics::ContactBuffer::Contact{
+          glm::vec3{0.0f}, glm::vec3{0.0f}, {0.0f, 1.0f, 0.0f}, depth};
+    }
+
+    /**
+     * Adds a rigid body to a registry. Dynamic bodies have unit mass and are
+     * never rotated by contacts, so the expected velocities are simple to
+     * work out.
+     *
+     * @param registry The registry.
+     * @param position The position of the body's centre of mass.
+     * @param velocity The linear velocity, ignored for static bodies.
+     * @param is_static Is the body static?
+     * @return The body's entity.
+     */
+    inline auto add_body(afk::ecs::Registry &registry, const glm::vec3 &position,
+                         const glm::vec3 &velocity, bool is_static = false)
+        -> afk::ecs::Entity {
+      const auto entity = registry.create();
+
+      auto transform        = afk::ecs::component::TransformComponent{};
+      transform.translation = position;
+      transform.rotation    = IDENTITY;
+      registry.emplace<afk::ecs::component::TransformComponent>(entity, transform);
+
+      auto physics      = afk::ecs::component::PhysicsComponent{};
+      physics.is_static = is_static;
+
+      if (!is_static) {
+        physics.linear_velocity    = velocity;
+        physics.total_mass         = 1.0f;
+        physics.total_inverse_mass = 1.0f;
+      }
+
+      registry.emplace<afk::ecs::component::PhysicsComponent>(entity, physics);
+
+      return entity;
+    }
+  }
+}
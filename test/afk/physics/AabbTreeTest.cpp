@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/Test.hpp"
+#include "afk/debug/Assert.hpp"
+#include "afk/physics/AabbTree.hpp"
+#include "afk/physics/Geometry.hpp"
+
+using afk::physics::Aabb;
+using afk::physics::AabbTree;
+using afk::test::is_near;
+
+/** The number of boxes in the randomised tests. */
+static constexpr usize BOX_COUNT = 256;
+
+/**
+ * Returns a random box in a 100 unit cube, up to 4 units across.
+ *
+ * @param random The random number generator.
+ * @return The box.
+ */
+static auto make_box(std::mt19937 &random) -> Aabb {
+  auto position  = std::uniform_real_distribution<f32>{-50.0f, 50.0f};
+  auto size      = std::uniform_real_distribution<f32>{0.1f, 4.0f};
+  const auto min = glm::vec3{position(random), position(random), position(random)};
+
+  return Aabb{min, min + glm::vec3{size(random), size(random), size(random)}};
+}
+
+/**
+ * Fills a tree with random boxes.
+ *
+ * @param tree The tree.
+ * @param random The random number generator.
+ * @return The proxy of each box, indexed by the data it was inserted with.
+ */
+static auto fill(AabbTree &tree, std::mt19937 &random) -> std::vector<i32> {
+  auto proxies = std::vector<i32>{};
+
+  for (auto i = usize{0}; i < BOX_COUNT; ++i) {
+    proxies.push_back(tree.insert(make_box(random), i));
+  }
+
+  return proxies;
+}
+
+/**
+ * Querying finds every box whose leaf overlaps, the same as testing them all.
+ */
+static auto test_query() -> void {
+  auto random        = std::mt19937{398};
+  auto tree          = AabbTree{};
+  const auto proxies = fill(tree, random);
+
+  for (auto i = 0; i < 64; ++i) {
+    auto bounds = make_box(random);
+    bounds.max += glm::vec3{10.0f};
+
+    auto found = std::vector<usize>{};
+    tree.query(bounds, [&](usize data) {
+      found.push_back(data);
+      return true;
+    });
+
+    auto expected = std::vector<usize>{};
+
+    for (auto data = usize{0}; data < proxies.size(); ++data) {
+      if (afk::physics::is_overlapping(tree.get_fat_bounds(proxies[data]), bounds)) {
+        expected.push_back(data);
+      }
+    }
+
+    std::sort(found.begin(), found.end());
+    afk_assert(found == expected, "Query doesn't match testing every box");
+  }
+
+  auto count = 0;
+  tree.query(Aabb{glm::vec3{-100.0f}, glm::vec3{100.0f}}, [&](usize) {
+    ++count;
+    return false;
+  });
+  afk_assert(count == 1, "Query didn't stop when asked");
+}
+
+/**
+ * Raycasting finds every box whose grown leaf is crossed, the same as testing
+ * them all, and stops when asked.
+ */
+static auto test_raycast() -> void {
+  auto random        = std::mt19937{398};
+  auto tree          = AabbTree{};
+  const auto proxies = fill(tree, random);
+  const auto padding = glm::vec3{0.5f};
+
+  for (auto i = 0; i < 64; ++i) {
+    const auto from = make_box(random).min;
+    const auto to   = make_box(random).min;
+
+    auto found = std::vector<usize>{};
+    tree.raycast(from, to, padding, [&](usize data) {
+      found.push_back(data);
+      return 1.0f;
+    });
+
+    auto expected = std::vector<usize>{};
+
+    for (auto data = usize{0}; data < proxies.size(); ++data) {
+      const auto &fat = tree.get_fat_bounds(proxies[data]);
+
+      const auto grown = Aabb{fat.min - padding, fat.max + padding};
+
+      if (afk::physics::intersect_segment(from, to, grown)) {
+        expected.push_back(data);
+      }
+    }
+
+    std::sort(found.begin(), found.end());
+    afk_assert(found == expected, "Raycast doesn't match testing every box");
+  }
+
+  // a segment through the first box crosses at least that box
+  const auto &first = tree.get_fat_bounds(proxies[0]);
+  const auto from    = first.min - glm::vec3{1.0f};
+  const auto to      = first.max + glm::vec3{1.0f};
+  auto count         = 0;
+  tree.raycast(from, to, glm::vec3{0.0f}, [&](usize) {
+    ++count;
+    return -1.0f;
+  });
+  afk_assert(count == 1, "Raycast didn't stop when asked");
+}
+
+/**
+ * Raycasting skips boxes past the fraction returned so far.
+ */
+static auto test_raycast_clips() -> void {
+  auto tree = AabbTree{};
+  tree.set_fat_margin(0.0f);
+
+  for (auto i = usize{0}; i < 8; ++i) {
+    const auto x = static_cast<f32>(i) * 10.0f;
+    tree.insert(Aabb{{x, -1.0f, -1.0f}, {x + 1.0f, 1.0f, 1.0f}}, i);
+  }
+
+  // every box is hit, but none past the closest reported so far
+  auto closest      = 1.0f;
+  auto is_first_hit = false;
+  tree.raycast({-10.0f, 0.0f, 0.0f}, {90.0f, 0.0f, 0.0f}, glm::vec3{0.0f}, [&](usize data) {
+    const auto entry = (static_cast<f32>(data) * 10.0f + 10.0f) / 100.0f;
+    afk_assert(entry <= closest, "Raycast reported a box past the closest hit");
+
+    closest      = entry;
+    is_first_hit = is_first_hit || data == 0;
+    return closest;
+  });
+
+  afk_assert(is_first_hit, "Raycast missed the closest box");
+}
+
+/**
+ * Moving a box within its leaf keeps the leaf, and moving it out reinserts
+ * it with a leaf grown by the fat margin.
+ */
+static auto test_move() -> void {
+  auto tree         = AabbTree{};
+  const auto bounds = Aabb{glm::vec3{0.0f}, glm::vec3{1.0f}};
+  const auto proxy  = tree.insert(bounds, 7);
+  const auto margin = AabbTree::DEFAULT_FAT_MARGIN;
+  tree.insert(Aabb{glm::vec3{5.0f}, glm::vec3{6.0f}}, 8);
+
+  afk_assert(is_near(tree.get_fat_bounds(proxy).min, bounds.min - glm::vec3{margin}) &&
+                 is_near(tree.get_fat_bounds(proxy).max, bounds.max + glm::vec3{margin}),
+             "Leaf isn't grown by the fat margin");
+
+  const auto nudge = glm::vec3{margin * 0.5f, 0.0f, 0.0f};
+  afk_assert(!tree.move(proxy, Aabb{bounds.min + nudge, bounds.max + nudge}),
+             "Box moved within its leaf was reinserted");
+  afk_assert(is_near(tree.get_fat_bounds(proxy).min, bounds.min - glm::vec3{margin}),
+             "Leaf changed without being reinserted");
+
+  const auto moved = Aabb{glm::vec3{20.0f}, glm::vec3{21.0f}};
+  afk_assert(tree.move(proxy, moved), "Box moved out of its leaf wasn't reinserted");
+  afk_assert(is_near(tree.get_fat_bounds(proxy).min, moved.min - glm::vec3{margin}),
+             "Reinserted leaf isn't around the new box");
+  afk_assert(tree.get_data(proxy) == 7, "Reinserted box lost its data");
+
+  auto found = std::vector<usize>{};
+  tree.query(moved, [&](usize data) {
+    found.push_back(data);
+    return true;
+  });
+  afk_assert(found == std::vector<usize>{7}, "Moved box isn't found at its new position");
+
+  const auto stats = tree.get_stats();
+  afk_assert(stats.refit_count == 2 && stats.reinsert_count == 1, "Move counts are wrong");
+}
+
+/**
+ * Each tree has its own fat margin, used for every box inserted after it's set.
+ */
+static auto test_set_fat_margin() -> void {
+  auto tree = AabbTree{};
+  afk_assert(is_near(tree.get_fat_margin(), AabbTree::DEFAULT_FAT_MARGIN),
+             "Tree doesn't start with the default margin");
+
+  tree.set_fat_margin(0.5f);
+  afk_assert(is_near(tree.get_fat_margin(), 0.5f), "Margin wasn't set");
+
+  const auto proxy = tree.insert(Aabb{glm::vec3{0.0f}, glm::vec3{1.0f}}, 0);
+  afk_assert(is_near(tree.get_fat_bounds(proxy).min, glm::vec3{-0.5f}) &&
+                 is_near(tree.get_fat_bounds(proxy).max, glm::vec3{1.5f}),
+             "Leaf isn't grown by the tree's margin");
+
+  const auto other = AabbTree{};
+  afk_assert(is_near(other.get_fat_margin(), AabbTree::DEFAULT_FAT_MARGIN),
+             "Margin is shared between trees");
+}
+
+/**
+ * Removed boxes are no longer found, and their nodes are reused.
+ */
+static auto test_remove() -> void {
+  auto random  = std::mt19937{398};
+  auto tree    = AabbTree{};
+  auto proxies = fill(tree, random);
+
+  for (auto data = usize{0}; data < proxies.size(); data += 2) {
+    tree.remove(proxies[data]);
+  }
+
+  auto count = usize{0};
+  tree.query(Aabb{glm::vec3{-100.0f}, glm::vec3{100.0f}}, [&](usize data) {
+    afk_assert(data % 2 == 1, "Removed box was found");
+    ++count;
+    return true;
+  });
+  afk_assert(count == BOX_COUNT / 2, "Kept boxes weren't all found");
+
+  auto stats = tree.get_stats();
+  afk_assert(stats.proxy_count == BOX_COUNT / 2, "Proxy count is wrong after removing");
+  afk_assert(stats.node_count == BOX_COUNT - 1, "Removing didn't free the parent nodes");
+
+  for (auto data = usize{0}; data < proxies.size(); data += 2) {
+    proxies[data] = tree.insert(make_box(random), data);
+  }
+
+  const auto max_proxy = *std::max_element(proxies.begin(), proxies.end());
+  afk_assert(max_proxy < static_cast<i32>(2 * BOX_COUNT - 1), "Freed nodes weren't reused");
+
+  stats = tree.get_stats();
+  afk_assert(stats.proxy_count == BOX_COUNT && stats.node_count == 2 * BOX_COUNT - 1,
+             "Counts are wrong after reinserting");
+}
+
+/**
+ * Boxes inserted in order stay balanced, and the stats count every node in
+ * use.
+ */
+static auto test_stats() -> void {
+  auto tree = AabbTree{};
+  afk_assert(tree.get_stats().height == 0 && tree.get_stats().node_count == 0,
+             "Empty tree has nodes");
+
+  tree.set_fat_margin(0.0f);
+  tree.insert(Aabb{glm::vec3{0.0f}, glm::vec3{1.0f}}, 0);
+  afk_assert(is_near(tree.get_stats().area_ratio, 1.0f), "Single box area ratio is wrong");
+
+  for (auto i = usize{1}; i < BOX_COUNT; ++i) {
+    const auto x = static_cast<f32>(i) * 2.0f;
+    tree.insert(Aabb{{x, 0.0f, 0.0f}, {x + 1.0f, 1.0f, 1.0f}}, i);
+  }
+
+  const auto stats = tree.get_stats();
+  afk_assert(stats.proxy_count == BOX_COUNT && stats.node_count == 2 * BOX_COUNT - 1,
+             "Node counts are wrong");
+  // a balanced tree of 256 leaves is 8 levels, rotations keep it within twice that
+  afk_assert(stats.height >= 8 && stats.height <= 16, "Tree isn't balanced");
+  afk_assert(stats.rotation_count > 0, "Inserting in order didn't rotate the tree");
+  afk_assert(stats.area_ratio > 1.0f, "Area ratio doesn't count every node");
+}
+
+auto main() -> i32 {
+  test_query();
+  test_raycast();
+  test_raycast_clips();
+  test_move();
+  test_set_fat_margin();
+  test_remove();
+  test_stats();
+
+  return EXIT_SUCCESS;
+}
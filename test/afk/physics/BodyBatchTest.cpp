@@ -0,0 +1,206 @@
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/Test.hpp"
+#include "afk/debug/Assert.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/ecs/Registry.hpp"
+#include "afk/ecs/component/ColliderComponent.hpp"
+#include "afk/ecs/component/PhysicsComponent.hpp"
+#include "afk/ecs/component/TransformComponent.hpp"
+#include "afk/job/JobManager.hpp"
+#include "afk/physics/BodyBatch.hpp"
+
+using afk::ecs::Entity;
+using afk::ecs::Registry;
+using afk::ecs::component::ColliderComponent;
+using afk::ecs::component::PhysicsComponent;
+using afk::ecs::component::TransformComponent;
+using afk::job::JobManager;
+using afk::physics::BodyBatch;
+using afk::test::add_body;
+using afk::test::is_near;
+
+/** The time advanced by each step, in seconds. */
+static constexpr f32 DT = 0.1f;
+
+/**
+ * Adds an undampened rigid body with a collider, which the batch needs to
+ * integrate it.
+ *
+ * @param registry The registry to add to.
+ * @param position The position of the body.
+ * @param velocity The linear velocity of the body.
+ * @param is_static Is the body static?
+ * @return The entity of the body.
+ */
+static auto add_collider_body(Registry &registry, const glm::vec3 &position,
+                              const glm::vec3 &velocity, bool is_static = false) -> Entity {
+  const auto entity = add_body(registry, position, velocity, is_static);
+  registry.emplace<ColliderComponent>(entity);
+
+  auto &physics             = registry.get<PhysicsComponent>(entity);
+  physics.linear_dampening  = 0.0f;
+  physics.angular_dampening = 0.0f;
+
+  return entity;
+}
+
+/**
+ * Runs a step without gravity or contacts.
+ *
+ * @param batch The batch.
+ * @param registry The registry the bodies belong to.
+ */
+static auto step(BodyBatch &batch, Registry &registry) -> void {
+  batch.sync(registry);
+  batch.load_velocities(registry);
+  batch.integrate_velocities(DT, glm::vec3{0.0f});
+  batch.store_velocities(registry);
+  batch.integrate_positions(DT);
+  batch.store_transforms(registry);
+}
+
+/**
+ * Returns if every body in the batch is in the slot stored on it.
+ *
+ * @param batch The batch.
+ * @param registry The registry the bodies belong to.
+ * @return If every slot is right.
+ */
+static auto is_slotted(const BodyBatch &batch, const Registry &registry) -> bool {
+  const auto &entities = batch.get_entities();
+
+  for (auto slot = usize{0}; slot < entities.size(); ++slot) {
+    if (registry.get<PhysicsComponent>(entities[slot]).batch_slot != slot) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Only dynamic, awake bodies are synced into the batch. Bodies leave it when
+ * they fall asleep or are destroyed, and come back with their current
+ * transform when they wake.
+ */
+static auto test_sync() -> void {
+  auto job_manager = JobManager{};
+  auto batch       = BodyBatch{job_manager};
+  auto registry    = Registry{};
+
+  add_collider_body(registry, glm::vec3{0.0f}, glm::vec3{0.0f}, true);
+  auto bodies = std::vector<Entity>{};
+
+  // more than one lane's worth, so the arrays have to grow
+  for (auto i = usize{0}; i < BodyBatch::LANE_WIDTH * 2 + 1; ++i) {
+    bodies.push_back(
+        add_collider_body(registry, {static_cast<f32>(i), 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}));
+  }
+
+  step(batch, registry);
+  afk_assert(batch.get_count() == bodies.size(), "Dynamic bodies weren't added");
+  afk_assert(is_slotted(batch, registry), "Bodies aren't in their slots");
+
+  for (auto i = usize{0}; i < bodies.size(); ++i) {
+    afk_assert(is_near(registry.get<TransformComponent>(bodies[i]).translation,
+                       {static_cast<f32>(i), DT, 0.0f}),
+               "Body in a grown batch didn't move");
+  }
+
+  registry.get<PhysicsComponent>(bodies[1]).is_sleeping = true;
+  registry.destroy(bodies[0]);
+  step(batch, registry);
+  afk_assert(batch.get_count() == bodies.size() - 2, "Sleeping or destroyed bodies weren't removed");
+  afk_assert(is_slotted(batch, registry), "Removing bodies didn't move the last into their slots");
+  afk_assert(is_near(registry.get<TransformComponent>(bodies[1]).translation, {1.0f, DT, 0.0f}),
+             "Sleeping body moved");
+
+  // moved while asleep, such as by a scene loader
+  registry.get<TransformComponent>(bodies[1]).translation = glm::vec3{0.0f, 10.0f, 0.0f};
+  registry.get<PhysicsComponent>(bodies[1]).is_sleeping    = false;
+  step(batch, registry);
+  afk_assert(batch.get_count() == bodies.size() - 1, "Woken body wasn't added");
+  afk_assert(is_slotted(batch, registry), "Woken body isn't in its slot");
+  afk_assert(
+      is_near(registry.get<TransformComponent>(bodies[1]).translation, {0.0f, 10.0f + DT, 0.0f}),
+      "Woken body didn't start from where it was moved to");
+}
+
+/**
+ * A body copied along with its slot, such as from a prefab, is still added.
+ */
+static auto test_copied_slot() -> void {
+  auto job_manager = JobManager{};
+  auto batch       = BodyBatch{job_manager};
+  auto registry    = Registry{};
+
+  const auto original = add_collider_body(registry, glm::vec3{0.0f}, glm::vec3{0.0f});
+  step(batch, registry);
+
+  // copied before emplacing, as adding a component can move the others of its type
+  const auto transform = registry.get<TransformComponent>(original);
+  const auto physics   = registry.get<PhysicsComponent>(original);
+  const auto copy      = registry.create();
+  registry.emplace<TransformComponent>(copy, transform);
+  registry.emplace<PhysicsComponent>(copy, physics);
+  registry.emplace<ColliderComponent>(copy);
+
+  step(batch, registry);
+  afk_assert(batch.get_count() == 2 && is_slotted(batch, registry), "Copied body wasn't added");
+}
+
+/**
+ * A body moved outside of the batch and marked as moved carries on from where
+ * it was moved to.
+ */
+static auto test_external_move() -> void {
+  auto job_manager = JobManager{};
+  auto batch       = BodyBatch{job_manager};
+  auto registry    = Registry{};
+
+  const auto body = add_collider_body(registry, glm::vec3{0.0f}, {1.0f, 0.0f, 0.0f});
+  step(batch, registry);
+
+  auto &transform       = registry.get<TransformComponent>(body);
+  transform.translation = glm::vec3{5.0f, 0.0f, 0.0f};
+  batch.set_transform_dirty(body);
+  step(batch, registry);
+  afk_assert(is_near(transform.translation, {5.0f + DT, 0.0f, 0.0f}),
+             "Marked body didn't move from where it was moved to");
+}
+
+/**
+ * A spinning body's rotation stays unit length over many steps.
+ */
+static auto test_normalised_rotation() -> void {
+  auto job_manager = JobManager{};
+  auto batch       = BodyBatch{job_manager};
+  auto registry    = Registry{};
+
+  const auto body = add_collider_body(registry, glm::vec3{0.0f}, glm::vec3{0.0f});
+  registry.get<PhysicsComponent>(body).angular_velocity = glm::vec3{3.0f, 2.0f, 1.0f};
+
+  for (auto i = 0; i < 100; ++i) {
+    step(batch, registry);
+  }
+
+  const auto &rotation = registry.get<TransformComponent>(body).rotation;
+  const auto length    = std::sqrt(rotation.w * rotation.w + rotation.x * rotation.x +
+                                rotation.y * rotation.y + rotation.z * rotation.z);
+  afk_assert(is_near(length, 1.0f), "Rotation drifted from unit length");
+}
+
+auto main() -> i32 {
+  test_sync();
+  test_copied_slot();
+  test_external_move();
+  test_normalised_rotation();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+#include <cstdlib>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/Test.hpp"
+#include "afk/debug/Assert.hpp"
+#include "afk/physics/ContactBuffer.hpp"
+
+using afk::physics::ContactBuffer;
+using afk::test::ENTITY_A;
+using afk::test::ENTITY_B;
+using afk::test::ENTITY_C;
+using afk::test::is_near;
+using afk::test::make_contact;
+
+/**
+ * Fills a buffer with three pairs, the second of which has no contacts.
+ *
+ * @param buffer The buffer.
+ */
+static auto fill(ContactBuffer &buffer) -> void {
+  buffer.add_pair(ENTITY_A, ENTITY_B);
+  buffer.add_contact(make_contact(0.1f));
+  buffer.add_contact(make_contact(0.2f));
+  buffer.add_pair(ENTITY_B, ENTITY_C);
+  buffer.add_pair(ENTITY_C, ENTITY_A);
+  buffer.add_contact(make_contact(0.3f));
+}
+
+/**
+ * Each pair refers to the range of contacts added after it.
+ */
+static auto test_pairs_own_their_contacts() -> void {
+  auto buffer = ContactBuffer{};
+  afk_assert(buffer.is_empty(), "New buffer isn't empty");
+
+  fill(buffer);
+  afk_assert(!buffer.is_empty(), "Filled buffer is empty");
+
+  const auto pairs = buffer.get_pairs();
+  afk_assert(pairs.size() == 3, "Pair count is wrong");
+  afk_assert(pairs[0].entity1 == ENTITY_A && pairs[0].entity2 == ENTITY_B,
+             "Pair entities aren't kept in order");
+
+  const auto first = buffer.get_contacts(pairs[0]);
+  afk_assert(first.size() == 2 && is_near(first[0].penetration_depth, 0.1f) &&
+                 is_near(first[1].penetration_depth, 0.2f),
+             "First pair's contacts are wrong");
+  afk_assert(buffer.get_contacts(pairs[1]).empty(), "Pair without contacts has some");
+
+  const auto last = buffer.get_contacts(pairs[2]);
+  afk_assert(last.size() == 1 && is_near(last[0].penetration_depth, 0.3f),
+             "Last pair's contacts are wrong");
+}
+
+/**
+ * The event data refers to the same pairs and contacts as the buffer.
+ */
+static auto test_get_event_data() -> void {
+  auto buffer = ContactBuffer{};
+  fill(buffer);
+
+  const auto data = buffer.get_event_data();
+  afk_assert(data.pairs.size() == 3 && data.contacts.size() == 3,
+             "Event data doesn't hold every pair and contact");
+  afk_assert(data.pairs.data() == buffer.get_pairs().data(), "Event data copied the pairs");
+
+  const auto contacts = data.get_contacts(data.pairs[2]);
+  afk_assert(contacts.size() == 1 && is_near(contacts[0].penetration_depth, 0.3f),
+             "Event data's pair contacts are wrong");
+}
+
+/**
+ * Clearing removes every pair, and pairs added afterwards start from the
+ * first contact again.
+ */
+static auto test_clear() -> void {
+  auto buffer = ContactBuffer{};
+  fill(buffer);
+  buffer.clear();
+
+  afk_assert(buffer.is_empty(), "Cleared buffer isn't empty");
+  afk_assert(buffer.get_event_data().contacts.empty(), "Cleared buffer has contacts");
+
+  buffer.add_pair(ENTITY_A, ENTITY_C);
+  buffer.add_contact(make_contact(0.4f));
+
+  const auto pair = buffer.get_pairs()[0];
+  afk_assert(pair.first_contact == 0, "Pair after clearing doesn't start at the first contact");
+
+  const auto contacts = buffer.get_contacts(pair);
+  afk_assert(contacts.size() == 1 && is_near(contacts[0].penetration_depth, 0.4f),
+             "Pair after clearing has the wrong contacts");
+}
+
+auto main() -> i32 {
+  test_pairs_own_their_contacts();
+  test_get_event_data();
+  test_clear();
+
+  return EXIT_SUCCESS;
+}
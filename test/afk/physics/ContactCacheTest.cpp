@@ -0,0 +1,159 @@
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/Test.hpp"
+#include "afk/debug/Assert.hpp"
+#include "afk/physics/ContactBuffer.hpp"
+#include "afk/physics/ContactCache.hpp"
+
+using afk::physics::ContactBuffer;
+using afk::physics::ContactCache;
+using afk::test::ENTITY_A;
+using afk::test::ENTITY_B;
+using afk::test::ENTITY_C;
+using afk::test::is_near;
+using afk::test::make_contact;
+
+/**
+ * Pairs reported in either order are merged into one manifold, with the later
+ * pair's contacts flipped to match the first.
+ */
+static auto test_rebuild_merges_pairs() -> void {
+  auto buffer = ContactBuffer{};
+  buffer.add_pair(ENTITY_A, ENTITY_B);
+  buffer.add_contact({glm::vec3{0.0f}, glm::vec3{1.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, 0.1f});
+  buffer.add_pair(ENTITY_B, ENTITY_A);
+  buffer.add_contact({glm::vec3{5.0f, 0.0f, 0.0f}, glm::vec3{4.0f, 0.0f, 0.0f},
+                      {-1.0f, 0.0f, 0.0f}, 0.2f});
+
+  auto cache = ContactCache{};
+  cache.rebuild(buffer);
+
+  const auto &collisions = cache.get_collisions();
+  afk_assert(collisions.size() == 1, "Pairs of the same entities weren't merged");
+  afk_assert(collisions[0].entity1 == ENTITY_A && collisions[0].entity2 == ENTITY_B,
+             "Manifold isn't ordered by the first pair");
+
+  const auto &contacts = collisions[0].contacts;
+  afk_assert(contacts.size() == 2, "Merged manifold lost a contact");
+  afk_assert(is_near(contacts[1].collider1_point, {4.0f, 0.0f, 0.0f}) &&
+                 is_near(contacts[1].collider2_point, {5.0f, 0.0f, 0.0f}),
+             "Flipped contact points weren't swapped");
+  afk_assert(is_near(contacts[1].normal, {1.0f, 0.0f, 0.0f}), "Flipped normal wasn't negated");
+  afk_assert(is_near(contacts[1].penetration_depth, 0.2f), "Flipped depth changed");
+}
+
+/**
+ * Pairs of an entity with itself are discarded.
+ */
+static auto test_rebuild_discards_self_pairs() -> void {
+  auto buffer = ContactBuffer{};
+  buffer.add_pair(ENTITY_A, ENTITY_A);
+  buffer.add_contact(make_contact(0.1f));
+
+  auto cache = ContactCache{};
+  cache.rebuild(buffer);
+
+  afk_assert(cache.get_collisions().empty(), "Self pair was cached");
+  afk_assert(cache.get_entities().empty(), "Self pair entity was listed");
+  afk_assert(cache.find(ENTITY_A, ENTITY_A) == nullptr, "Self pair was found");
+}
+
+/**
+ * Every entity is listed once, and manifolds are found in either order.
+ */
+static auto test_rebuild_indexes_entities() -> void {
+  auto buffer = ContactBuffer{};
+  buffer.add_pair(ENTITY_A, ENTITY_B);
+  buffer.add_contact(make_contact(0.1f));
+  buffer.add_pair(ENTITY_B, ENTITY_C);
+  buffer.add_contact(make_contact(0.1f));
+
+  auto cache = ContactCache{};
+  cache.rebuild(buffer);
+
+  const auto &entities = cache.get_entities();
+  afk_assert(entities.size() == 3, "Entities weren't each listed once");
+  afk_assert(cache.find(ENTITY_C, ENTITY_B) != nullptr, "Reversed pair wasn't found");
+  afk_assert(cache.find(ENTITY_A, ENTITY_C) == nullptr, "Untouching pair was found");
+  afk_assert(ContactCache::get_pair_key(ENTITY_A, ENTITY_B) ==
+                 ContactCache::get_pair_key(ENTITY_B, ENTITY_A),
+             "Pair key depends on order");
+}
+
+/**
+ * Rebuilding replaces every manifold from the previous step.
+ */
+static auto test_rebuild_replaces_manifolds() -> void {
+  auto buffer = ContactBuffer{};
+  buffer.add_pair(ENTITY_A, ENTITY_B);
+  buffer.add_contact(make_contact(0.1f));
+
+  auto cache = ContactCache{};
+  cache.rebuild(buffer);
+  buffer.clear();
+  cache.rebuild(buffer);
+
+  afk_assert(cache.get_collisions().empty(), "Old manifold survived a rebuild");
+  afk_assert(cache.get_entities().empty(), "Old entity survived a rebuild");
+  afk_assert(cache.find(ENTITY_A, ENTITY_B) == nullptr, "Old pair survived a rebuild");
+}
+
+/**
+ * Rebuilding with the same pairs reuses the manifolds' memory rather than
+ * allocating it again.
+ */
+static auto test_rebuild_reuses_memory() -> void {
+  auto buffer = ContactBuffer{};
+  buffer.add_pair(ENTITY_A, ENTITY_B);
+  buffer.add_contact(make_contact(0.1f));
+  buffer.add_contact(make_contact(0.2f));
+
+  auto cache = ContactCache{};
+  cache.rebuild(buffer);
+  const auto *contacts = cache.get_collisions()[0].contacts.data();
+
+  cache.rebuild(ContactBuffer{});
+  cache.rebuild(buffer);
+
+  afk_assert(cache.get_collisions().size() == 1, "Rebuilt manifold is missing");
+  afk_assert(cache.get_collisions()[0].contacts.data() == contacts,
+             "Rebuilt manifold didn't reuse its contacts' memory");
+  afk_assert(is_near(cache.get_collisions()[0].contacts[1].penetration_depth, 0.2f),
+             "Rebuilt manifold's contacts are wrong");
+}
+
+/**
+ * Translating either entity moves its contact points and updates the depth.
+ */
+static auto test_translate() -> void {
+  auto buffer = ContactBuffer{};
+  buffer.add_pair(ENTITY_A, ENTITY_B);
+  buffer.add_contact(make_contact(0.5f));
+
+  auto cache = ContactCache{};
+  cache.rebuild(buffer);
+
+  // moving the first entity against the normal separates the pair
+  cache.translate(ENTITY_A, {0.0f, -0.2f, 0.0f});
+  // moving the second entity along the normal also separates it
+  cache.translate(ENTITY_B, {0.0f, 0.1f, 0.0f});
+
+  const auto &contact = cache.get_collisions()[0].contacts[0];
+  afk_assert(is_near(contact.collider1_point, {0.0f, -0.2f, 0.0f}), "First point didn't move");
+  afk_assert(is_near(contact.collider2_point, {0.0f, 0.1f, 0.0f}), "Second point didn't move");
+  afk_assert(is_near(contact.penetration_depth, 0.2f), "Depth wasn't updated");
+}
+
+auto main() -> i32 {
+  test_rebuild_merges_pairs();
+  test_rebuild_discards_self_pairs();
+  test_rebuild_indexes_entities();
+  test_rebuild_replaces_manifolds();
+  test_rebuild_reuses_memory();
+  test_translate();
+
+  return EXIT_SUCCESS;
+}
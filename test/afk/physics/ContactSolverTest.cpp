@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/Test.hpp"
+#include "afk/debug/Assert.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/ecs/Registry.hpp"
+#include "afk/ecs/component/PhysicsComponent.hpp"
+#include "afk/job/JobManager.hpp"
+#include "afk/physics/ContactBuffer.hpp"
+#include "afk/physics/ContactCache.hpp"
+#include "afk/physics/ContactSolver.hpp"
+#include "afk/physics/Islands.hpp"
+
+using afk::ecs::Entity;
+using afk::ecs::Registry;
+using afk::ecs::component::PhysicsComponent;
+using afk::job::JobManager;
+using afk::physics::ContactBuffer;
+using afk::physics::ContactCache;
+using afk::physics::ContactSolver;
+using afk::physics::Islands;
+using afk::test::add_body;
+using afk::test::is_near;
+
+/**
+ * Adds a contact where the upper body rests on the lower body.
+ *
+ * @param contacts The buffer to add to.
+ * @param lower The body underneath.
+ * @param upper The body on top.
+ * @param point The contact point.
+ * @param is_flipped Report the pair with the upper body first.
+ */
+static auto add_resting_contact(ContactBuffer &contacts, Entity lower, Entity upper,
+                                const glm::vec3 &point, bool is_flipped = false) -> void {
+  if (is_flipped) {
+    contacts.add_pair(upper, lower);
+    contacts.add_contact({point, point, {0.0f, -1.0f, 0.0f}, 0.01f});
+  } else {
+    contacts.add_pair(lower, upper);
+    contacts.add_contact({point, point, {0.0f, 1.0f, 0.0f}, 0.01f});
+  }
+}
+
+/**
+ * Solves a step of contacts.
+ *
+ * @param solver The solver.
+ * @param registry The registry the bodies belong to.
+ * @param contacts The contacts.
+ */
+static auto solve(ContactSolver &solver, Registry &registry, const ContactBuffer &contacts)
+    -> void {
+  auto cache = ContactCache{};
+  cache.rebuild(contacts);
+
+  auto islands = Islands{};
+  islands.build(registry, cache);
+
+  solver.solve(registry, cache, islands);
+}
+
+/**
+ * A body approaching slowly is stopped, one approaching quickly bounces, and
+ * one already moving away is left alone.
+ */
+static auto test_normal_impulse() -> void {
+  auto job_manager = JobManager{};
+  auto solver      = ContactSolver{job_manager};
+  auto registry    = Registry{};
+
+  const auto ground  = add_body(registry, glm::vec3{0.0f}, glm::vec3{0.0f}, true);
+  const auto slow    = add_body(registry, {0.0f, 1.0f, 0.0f}, {0.0f, -0.5f, 0.0f});
+  const auto fast    = add_body(registry, {5.0f, 1.0f, 0.0f}, {0.0f, -4.0f, 0.0f});
+  const auto leaving = add_body(registry, {10.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f});
+
+  auto contacts = ContactBuffer{};
+  add_resting_contact(contacts, ground, slow, {0.0f, 0.0f, 0.0f});
+  add_resting_contact(contacts, ground, fast, {5.0f, 0.0f, 0.0f});
+  add_resting_contact(contacts, ground, leaving, {10.0f, 0.0f, 0.0f});
+  solve(solver, registry, contacts);
+
+  afk_assert(is_near(registry.get<PhysicsComponent>(slow).linear_velocity, glm::vec3{0.0f}),
+             "Slow body wasn't stopped");
+  afk_assert(is_near(registry.get<PhysicsComponent>(fast).linear_velocity,
+                     {0.0f, 4.0f * ContactSolver::COEFFICIENT_OF_RESTITUTION, 0.0f}),
+             "Fast body didn't bounce");
+  afk_assert(is_near(registry.get<PhysicsComponent>(leaving).linear_velocity, {0.0f, 1.0f, 0.0f}),
+             "Body moving away was pulled back");
+}
+
+/**
+ * A body sliding diagonally loses speed along its direction of travel, by no
+ * more than the friction cone allows. Clamping each tangent on its own would
+ * take off more.
+ */
+static auto test_friction_cone() -> void {
+  auto job_manager = JobManager{};
+  auto solver      = ContactSolver{job_manager};
+  auto registry    = Registry{};
+
+  const auto ground = add_body(registry, glm::vec3{0.0f}, glm::vec3{0.0f}, true);
+  const auto box    = add_body(registry, {0.0f, 1.0f, 0.0f}, {2.0f, -0.5f, 2.0f});
+
+  auto contacts = ContactBuffer{};
+  add_resting_contact(contacts, ground, box, glm::vec3{0.0f});
+  solve(solver, registry, contacts);
+
+  // the normal impulse stops the 0.5 m/s approach, so friction takes off at most 0.5 times that
+  const auto velocity = registry.get<PhysicsComponent>(box).linear_velocity;
+  const auto expected = 2.0f * std::sqrt(2.0f) - ContactSolver::COEFFICIENT_OF_FRICTION * 0.5f;
+
+  afk_assert(is_near(velocity.y, 0.0f), "Sliding body wasn't stopped against the ground");
+  afk_assert(is_near(velocity.x, velocity.z), "Friction changed the direction of travel");
+  afk_assert(is_near(glm::length(glm::vec3{velocity.x, 0.0f, velocity.z}), expected),
+             "Friction isn't clamped to the cone");
+}
+
+/**
+ * A stack pressed down each step by gravity settles over a few steps, as each
+ * step starts from the impulses of the last, even when its pairs are reported
+ * the other way around on every other step.
+ */
+static auto test_warm_start() -> void {
+  static constexpr auto box_count = usize{8};
+  static constexpr auto gravity   = 0.2f;
+
+  auto job_manager = JobManager{};
+  auto solver      = ContactSolver{job_manager};
+  auto registry    = Registry{};
+
+  const auto ground = add_body(registry, glm::vec3{0.0f}, glm::vec3{0.0f}, true);
+  auto boxes        = std::vector<Entity>{};
+
+  for (auto i = usize{0}; i < box_count; ++i) {
+    boxes.push_back(add_body(registry, {0.0f, static_cast<f32>(i) * 2.0f + 1.0f, 0.0f},
+                             glm::vec3{0.0f}));
+  }
+
+  // the fastest any box is still moving after a step
+  const auto step = [&](bool is_flipped) {
+    auto contacts = ContactBuffer{};
+
+    for (auto i = usize{0}; i < box_count; ++i) {
+      const auto lower = i == 0 ? ground : boxes[i - 1];
+      add_resting_contact(contacts, lower, boxes[i],
+                          {0.0f, static_cast<f32>(i) * 2.0f, 0.0f}, is_flipped);
+      registry.get<PhysicsComponent>(boxes[i]).linear_velocity.y -= gravity;
+    }
+
+    solve(solver, registry, contacts);
+
+    auto speed = 0.0f;
+
+    for (const auto box : boxes) {
+      speed = std::max(speed, glm::length(registry.get<PhysicsComponent>(box).linear_velocity));
+    }
+
+    return speed;
+  };
+
+  const auto first_speed = step(false);
+  afk_assert(first_speed > 0.01f, "Stack settled without being warm started");
+
+  auto speed = first_speed;
+
+  for (auto i = 1; i < 32; ++i) {
+    speed = step(i % 2 == 1);
+  }
+
+  afk_assert(speed < first_speed * 0.1f, "Warm started stack didn't settle");
+
+  // forgetting the impulses starts over
+  solver.clear();
+  afk_assert(step(false) > speed, "Cleared solver still warm started");
+}
+
+/**
+ * Islands solved across the job manager's threads come out exactly the same
+ * as islands solved one after another, even though they all rest on the same
+ * static ground.
+ */
+static auto test_parallel_islands() -> void {
+  static constexpr auto stack_count = usize{32};
+  static constexpr auto box_count   = usize{4};
+
+  // the velocities of every box after a few warm started steps
+  const auto solve_stacks = [](JobManager &job_manager) {
+    auto solver   = ContactSolver{job_manager};
+    auto registry = Registry{};
+
+    const auto ground = add_body(registry, glm::vec3{0.0f}, glm::vec3{0.0f}, true);
+    auto contacts     = ContactBuffer{};
+    auto boxes        = std::vector<Entity>{};
+
+    for (auto s = usize{0}; s < stack_count; ++s) {
+      const auto x = static_cast<f32>(s) * 5.0f;
+
+      for (auto b = usize{0}; b < box_count; ++b) {
+        const auto y     = static_cast<f32>(b) * 2.0f;
+        const auto lower = b == 0 ? ground : boxes.back();
+        const auto box   = add_body(registry, {x, y + 1.0f, 0.0f},
+                                    {static_cast<f32>(s) * 0.1f, -0.5f - static_cast<f32>(b), 0.0f});
+
+        add_resting_contact(contacts, lower, box, {x - 0.5f, y, 0.0f});
+        add_resting_contact(contacts, lower, box, {x + 0.5f, y, 0.0f}, b % 2 == 1);
+        boxes.push_back(box);
+      }
+    }
+
+    for (auto i = 0; i < 4; ++i) {
+      solve(solver, registry, contacts);
+    }
+
+    auto velocities = std::vector<glm::vec3>{};
+
+    for (const auto box : boxes) {
+      velocities.push_back(registry.get<PhysicsComponent>(box).linear_velocity);
+    }
+
+    return velocities;
+  };
+
+  auto sequential = JobManager{};
+  auto parallel   = JobManager{};
+  parallel.initialize();
+
+  afk_assert(solve_stacks(sequential) == solve_stacks(parallel),
+             "Islands solved in parallel don't match solving them in order");
+}
+
+auto main() -> i32 {
+  test_normal_impulse();
+  test_friction_cone();
+  test_warm_start();
+  test_parallel_islands();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+#include <cstdlib>
+#include <initializer_list>
+#include <optional>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/Test.hpp"
+#include "afk/debug/Assert.hpp"
+#include "afk/physics/ContinuousCollision.hpp"
+#include "afk/physics/Geometry.hpp"
+
+using afk::physics::ContinuousStop;
+using afk::physics::SegmentHit;
+using afk::physics::WorldBox;
+using afk::physics::WorldShape;
+using afk::test::IDENTITY;
+using afk::test::is_near;
+
+/** The time advanced by each step, in seconds. */
+static constexpr f32 DT = 0.1f;
+
+/** The radius of the swept sphere. */
+static constexpr f32 RADIUS = 0.5f;
+
+/** A floor the sphere rests on, with its top face at zero. */
+static const auto FLOOR = WorldShape{WorldBox{{0.0f, -1.0f, 0.0f}, IDENTITY, {50.0f, 1.0f, 50.0f}}};
+
+/** A wall much thinner than the sphere moves in one step, with its near face at 4.95. */
+static const auto WALL = WorldShape{WorldBox{{5.0f, 5.0f, 0.0f}, IDENTITY, {0.05f, 5.0f, 50.0f}}};
+
+/**
+ * Moves a sphere by its velocity for a step, stopping it at the first shape
+ * in its path the same way continuous collision does. Shapes the sphere
+ * starts inside are passed through.
+ *
+ * @param from Where the sphere starts.
+ * @param linear_velocity The sphere's velocity.
+ * @param shapes The shapes in the way.
+ * @return Where the sphere ends up, and its velocity.
+ */
+static auto step(const glm::vec3 &from, const glm::vec3 &linear_velocity,
+                 std::initializer_list<WorldShape> shapes) -> ContinuousStop {
+  const auto motion = linear_velocity * DT;
+  auto closest      = std::optional<SegmentHit>{};
+
+  for (const auto &shape : shapes) {
+    const auto hit = afk::physics::sweep_sphere(from, from + motion, RADIUS, shape);
+
+    if (hit.has_value() && hit->fraction > 0.0f &&
+        (!closest.has_value() || hit->fraction < closest->fraction)) {
+      closest = hit;
+    }
+  }
+
+  if (!closest.has_value()) {
+    return ContinuousStop{from + motion, linear_velocity};
+  }
+
+  return afk::physics::stop_at_hit(from, motion, linear_velocity, *closest);
+}
+
+/**
+ * A sphere sliding along the floor it rests on, slightly sunk into it, isn't
+ * stopped by it, even though its sweep starts inside the floor.
+ */
+static auto test_slide() -> void {
+  const auto velocity = glm::vec3{20.0f, 0.0f, 0.0f};
+  auto position       = glm::vec3{-20.0f, RADIUS - 0.05f, 0.0f};
+
+  const auto start_hit =
+      afk::physics::sweep_sphere(position, position + velocity * DT, RADIUS, FLOOR);
+  afk_assert(start_hit.has_value() && start_hit->fraction == 0.0f,
+             "Resting sphere's sweep doesn't start inside the floor");
+
+  const auto ignored = afk::physics::stop_at_hit(position, velocity * DT, velocity, *start_hit);
+  afk_assert(is_near(ignored.translation, position + velocity * DT) &&
+                 is_near(ignored.linear_velocity, velocity),
+             "Hit at the start of the sweep stopped the sphere");
+
+  for (auto i = 0; i < 10; ++i) {
+    const auto stop = step(position, velocity, {FLOOR});
+    afk_assert(is_near(stop.translation, position + velocity * DT) &&
+                   is_near(stop.linear_velocity, velocity),
+               "Sliding sphere was stopped by the floor");
+    position = stop.translation;
+  }
+}
+
+/**
+ * A sphere sliding along the floor at an angle to a thin wall stops at the
+ * wall rather than passing through it, and keeps sliding along it.
+ */
+static auto test_thin_wall() -> void {
+  auto velocity = glm::vec3{20.0f, 0.0f, 5.0f};
+  auto position = glm::vec3{0.0f, RADIUS - 0.05f, 0.0f};
+  auto is_hit   = false;
+
+  for (auto i = 0; i < 10; ++i) {
+    const auto stop = step(position, velocity, {FLOOR, WALL});
+    afk_assert(stop.translation.x <= 4.95f - RADIUS + afk::test::EPSILON,
+               "Sphere passed through the thin wall");
+    afk_assert(stop.translation.z > position.z, "Sphere stopped sliding");
+
+    is_hit   = is_hit || stop.linear_velocity.x != velocity.x;
+    position = stop.translation;
+    velocity = stop.linear_velocity;
+  }
+
+  afk_assert(is_hit, "Sphere never reached the wall");
+  afk_assert(is_near(position.x, 4.95f - RADIUS), "Sphere didn't stop against the wall");
+  afk_assert(is_near(velocity, {0.0f, 0.0f, 5.0f}),
+             "Only the velocity into the wall should be taken out");
+}
+
+auto main() -> i32 {
+  test_slide();
+  test_thin_wall();
+
+  return EXIT_SUCCESS;
+}
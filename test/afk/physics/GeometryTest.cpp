@@ -0,0 +1,211 @@
+#include <cmath>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/Test.hpp"
+#include "afk/debug/Assert.hpp"
+#include "afk/physics/Geometry.hpp"
+
+using afk::physics::Aabb;
+using afk::physics::WorldBox;
+using afk::physics::WorldShape;
+using afk::physics::WorldSphere;
+using afk::test::IDENTITY;
+using afk::test::is_near;
+using afk::test::rotate;
+
+/**
+ * A rotated box's bounds hold its corners on each world axis.
+ */
+static auto test_get_bounds() -> void {
+  const auto sphere_bounds = afk::physics::get_bounds(WorldSphere{{1.0f, 2.0f, 3.0f}, 0.5f});
+  afk_assert(is_near(sphere_bounds.min, {0.5f, 1.5f, 2.5f}) &&
+                 is_near(sphere_bounds.max, {1.5f, 2.5f, 3.5f}),
+             "Sphere bounds are wrong");
+
+  const auto box = WorldBox{glm::vec3{0.0f}, rotate(45.0f, {0.0f, 1.0f, 0.0f}), glm::vec3{1.0f}};
+  const auto box_bounds = afk::physics::get_bounds(box);
+  const auto diagonal   = std::sqrt(2.0f);
+  afk_assert(is_near(box_bounds.min, {-diagonal, -1.0f, -diagonal}) &&
+                 is_near(box_bounds.max, {diagonal, 1.0f, diagonal}),
+             "Rotated box bounds are wrong");
+}
+
+/**
+ * The closest point in a box is clamped to its surface in its own space.
+ */
+static auto test_get_closest_point() -> void {
+  const auto box = WorldBox{{1.0f, 0.0f, 0.0f}, rotate(90.0f, {0.0f, 1.0f, 0.0f}),
+                            {2.0f, 1.0f, 1.0f}};
+
+  afk_assert(is_near(afk::physics::get_closest_point(box, {5.0f, 0.0f, 3.0f}),
+                     {2.0f, 0.0f, 2.0f}),
+             "Outside point isn't clamped to the box");
+  afk_assert(is_near(afk::physics::get_closest_point(box, {1.5f, 0.5f, -1.0f}),
+                     {1.5f, 0.5f, -1.0f}),
+             "Inside point was moved");
+}
+
+/**
+ * Bounding boxes and spheres overlap when touching, but not when apart.
+ */
+static auto test_is_overlapping_simple() -> void {
+  const auto aabb = Aabb{glm::vec3{0.0f}, glm::vec3{1.0f}};
+  afk_assert(afk::physics::is_overlapping(aabb, Aabb{{1.0f, 0.0f, 0.0f}, {2.0f, 1.0f, 1.0f}}),
+             "Touching bounding boxes don't overlap");
+  afk_assert(!afk::physics::is_overlapping(aabb, Aabb{{1.1f, 0.0f, 0.0f}, {2.0f, 1.0f, 1.0f}}),
+             "Separate bounding boxes overlap");
+
+  const auto sphere = WorldSphere{glm::vec3{0.0f}, 1.0f};
+  afk_assert(afk::physics::is_overlapping(sphere, WorldSphere{{2.0f, 0.0f, 0.0f}, 1.0f}),
+             "Touching spheres don't overlap");
+  afk_assert(!afk::physics::is_overlapping(sphere, WorldSphere{{2.1f, 0.0f, 0.0f}, 1.0f}),
+             "Separate spheres overlap");
+}
+
+/**
+ * A sphere only touches a rotated box's corner once the box is rotated.
+ */
+static auto test_is_overlapping_sphere_box() -> void {
+  const auto sphere  = WorldSphere{{1.5f, 0.0f, 0.0f}, 0.1f};
+  const auto box     = WorldBox{glm::vec3{0.0f}, IDENTITY, glm::vec3{1.0f}};
+  const auto rotated =
+      WorldBox{glm::vec3{0.0f}, rotate(45.0f, {0.0f, 0.0f, 1.0f}), glm::vec3{1.0f}};
+
+  afk_assert(!afk::physics::is_overlapping(sphere, box), "Sphere overlaps a box it's beside");
+  afk_assert(afk::physics::is_overlapping(sphere, rotated),
+             "Sphere doesn't overlap a rotated box's corner");
+
+  // either way around, as shapes of any type
+  afk_assert(!afk::physics::is_overlapping(WorldShape{box}, WorldShape{sphere}) &&
+                 afk::physics::is_overlapping(WorldShape{rotated}, WorldShape{sphere}),
+             "Shapes don't overlap the same as the sphere and box they hold");
+}
+
+/**
+ * Two cubes rotated about z and y have crossed edges facing each other, which
+ * meet when their centres are 2 * sqrt(2) apart. Past that they're only
+ * separated by the cross product of those edges, not by any face normal.
+ */
+static auto test_is_overlapping_boxes() -> void {
+  const auto box1 = WorldBox{glm::vec3{0.0f}, rotate(45.0f, {0.0f, 0.0f, 1.0f}), glm::vec3{1.0f}};
+  auto box2 =
+      WorldBox{{2.7f, 0.0f, 0.0f}, rotate(45.0f, {0.0f, 1.0f, 0.0f}), glm::vec3{1.0f}};
+
+  afk_assert(afk::physics::is_overlapping(box1, box2), "Crossed edges don't overlap");
+
+  box2.center.x = 2.9f;
+  afk_assert(!afk::physics::is_overlapping(box1, box2),
+             "Boxes separated by an edge axis overlap");
+
+  box2.center.x   = 2.1f;
+  box2.rotation   = IDENTITY;
+  const auto cube = WorldBox{glm::vec3{0.0f}, IDENTITY, glm::vec3{1.0f}};
+  afk_assert(!afk::physics::is_overlapping(cube, box2),
+             "Boxes separated by a face axis overlap");
+}
+
+/**
+ * A segment enters a bounding box at the fraction along it, at zero if it
+ * starts inside, and not at all if it misses.
+ */
+static auto test_intersect_segment_aabb() -> void {
+  const auto aabb = Aabb{glm::vec3{-1.0f}, glm::vec3{1.0f}};
+
+  const auto hit = afk::physics::intersect_segment({-2.0f, 0.0f, 0.0f}, {2.0f, 0.0f, 0.0f}, aabb);
+  afk_assert(hit.has_value() && is_near(*hit, 0.25f), "Segment doesn't enter the box");
+
+  const auto inside = afk::physics::intersect_segment(glm::vec3{0.0f}, {2.0f, 0.0f, 0.0f}, aabb);
+  afk_assert(inside.has_value() && is_near(*inside, 0.0f), "Segment doesn't start inside");
+
+  afk_assert(!afk::physics::intersect_segment({-2.0f, 2.0f, 0.0f}, {2.0f, 2.0f, 0.0f}, aabb),
+             "Segment beside the box hits it");
+  afk_assert(!afk::physics::intersect_segment({-4.0f, 0.0f, 0.0f}, {-2.0f, 0.0f, 0.0f}, aabb),
+             "Segment ending before the box hits it");
+}
+
+/**
+ * A segment hits a sphere where it first crosses its surface, facing against
+ * the segment.
+ */
+static auto test_intersect_segment_sphere() -> void {
+  const auto sphere = WorldSphere{glm::vec3{0.0f}, 1.0f};
+
+  const auto hit =
+      afk::physics::intersect_segment({-3.0f, 0.0f, 0.0f}, {3.0f, 0.0f, 0.0f}, sphere);
+  afk_assert(hit.has_value() && is_near(hit->fraction, 1.0f / 3.0f) &&
+                 is_near(hit->normal, {-1.0f, 0.0f, 0.0f}),
+             "Segment doesn't hit the sphere's surface");
+
+  const auto inside = afk::physics::intersect_segment(glm::vec3{0.0f}, {0.0f, 2.0f, 0.0f}, sphere);
+  afk_assert(inside.has_value() && is_near(inside->fraction, 0.0f) &&
+                 is_near(inside->normal, {0.0f, -1.0f, 0.0f}),
+             "Segment starting inside doesn't hit at the start");
+
+  afk_assert(!afk::physics::intersect_segment({2.0f, 0.0f, 0.0f}, {3.0f, 0.0f, 0.0f}, sphere),
+             "Segment moving away hits the sphere");
+  afk_assert(!afk::physics::intersect_segment({-3.0f, 0.0f, 0.0f}, {-2.0f, 0.0f, 0.0f}, sphere),
+             "Segment ending before the sphere hits it");
+  afk_assert(!afk::physics::intersect_segment({-3.0f, 1.5f, 0.0f}, {3.0f, 1.5f, 0.0f}, sphere),
+             "Segment beside the sphere hits it");
+}
+
+/**
+ * A segment hits a rotated box on the face it enters through, with the
+ * face's normal rotated into world space.
+ */
+static auto test_intersect_segment_box() -> void {
+  // rotated so the long side lies along z
+  const auto box = WorldBox{glm::vec3{0.0f}, rotate(90.0f, {0.0f, 1.0f, 0.0f}),
+                            {2.0f, 1.0f, 1.0f}};
+
+  const auto x_hit = afk::physics::intersect_segment({-3.0f, 0.0f, 0.0f}, {3.0f, 0.0f, 0.0f}, box);
+  afk_assert(x_hit.has_value() && is_near(x_hit->fraction, 1.0f / 3.0f) &&
+                 is_near(x_hit->normal, {-1.0f, 0.0f, 0.0f}),
+             "Segment along x doesn't hit the long side");
+
+  const auto z_hit = afk::physics::intersect_segment({0.0f, 0.0f, 4.0f}, {0.0f, 0.0f, -4.0f}, box);
+  afk_assert(z_hit.has_value() && is_near(z_hit->fraction, 0.25f) &&
+                 is_near(z_hit->normal, {0.0f, 0.0f, 1.0f}),
+             "Segment along z doesn't hit the end");
+
+  afk_assert(!afk::physics::intersect_segment({1.5f, 0.0f, 4.0f}, {1.5f, 0.0f, -4.0f}, box),
+             "Segment beside the box hits it");
+}
+
+/**
+ * A swept sphere hits a shape where the sphere first touches it, the same as
+ * a segment hitting the shape grown by the sphere's radius.
+ */
+static auto test_sweep_sphere() -> void {
+  const auto sphere_hit = afk::physics::sweep_sphere(
+      {-4.0f, 0.0f, 0.0f}, {4.0f, 0.0f, 0.0f}, 0.5f, WorldSphere{glm::vec3{0.0f}, 1.5f});
+  afk_assert(sphere_hit.has_value() && is_near(sphere_hit->fraction, 0.25f) &&
+                 is_near(sphere_hit->normal, {-1.0f, 0.0f, 0.0f}),
+             "Swept sphere doesn't touch the sphere at its surface");
+
+  const auto box     = WorldBox{glm::vec3{0.0f}, IDENTITY, {1.0f, 1.0f, 1.0f}};
+  const auto box_hit = afk::physics::sweep_sphere({0.0f, 4.0f, 0.0f}, {0.0f, -4.0f, 0.0f}, 1.0f, box);
+  afk_assert(box_hit.has_value() && is_near(box_hit->fraction, 0.25f) &&
+                 is_near(box_hit->normal, {0.0f, 1.0f, 0.0f}),
+             "Swept sphere doesn't touch the box at its face");
+
+  afk_assert(!afk::physics::sweep_sphere({-4.0f, 2.5f, 0.0f}, {4.0f, 2.5f, 0.0f}, 1.0f, box),
+             "Swept sphere passing beside the box hits it");
+}
+
+auto main() -> i32 {
+  test_get_bounds();
+  test_get_closest_point();
+  test_is_overlapping_simple();
+  test_is_overlapping_sphere_box();
+  test_is_overlapping_boxes();
+  test_intersect_segment_aabb();
+  test_intersect_segment_sphere();
+  test_intersect_segment_box();
+  test_sweep_sphere();
+
+  return EXIT_SUCCESS;
+}
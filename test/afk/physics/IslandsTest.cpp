@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cstdlib>
+#include <initializer_list>
+#include <utility>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/Test.hpp"
+#include "afk/debug/Assert.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/ecs/Registry.hpp"
+#include "afk/physics/ContactBuffer.hpp"
+#include "afk/physics/ContactCache.hpp"
+#include "afk/physics/Islands.hpp"
+
+using afk::ecs::Entity;
+using afk::ecs::Registry;
+using afk::physics::ContactBuffer;
+using afk::physics::ContactCache;
+using afk::physics::Islands;
+using afk::test::add_body;
+using afk::test::make_contact;
+
+/**
+ * Returns if an island holds the specified body.
+ *
+ * @param islands The islands.
+ * @param island The island index.
+ * @param entity The entity of the body.
+ * @return If the body is in the island.
+ */
+static auto is_in_island(const Islands &islands, usize island, Entity entity) -> bool {
+  const auto bodies = islands.get_bodies(island);
+
+  return std::find(bodies.begin(), bodies.end(), entity) != bodies.end();
+}
+
+/**
+ * Touching dynamic bodies share an island, while bodies that only touch the
+ * same static body, or nothing at all, get their own.
+ */
+static auto test_build() -> void {
+  auto registry = Registry{};
+
+  const auto ground   = add_body(registry, glm::vec3{0.0f}, glm::vec3{0.0f}, true);
+  const auto lower    = add_body(registry, {0.0f, 1.0f, 0.0f}, glm::vec3{0.0f});
+  const auto upper    = add_body(registry, {0.0f, 3.0f, 0.0f}, glm::vec3{0.0f});
+  const auto beside   = add_body(registry, {5.0f, 1.0f, 0.0f}, glm::vec3{0.0f});
+  const auto floating = add_body(registry, {0.0f, 10.0f, 0.0f}, glm::vec3{0.0f});
+
+  auto contacts = ContactBuffer{};
+
+  for (const auto &[entity1, entity2] :
+       {std::pair{ground, lower}, std::pair{upper, lower}, std::pair{ground, beside}}) {
+    contacts.add_pair(entity1, entity2);
+    contacts.add_contact(make_contact(0.01f));
+  }
+
+  auto cache = ContactCache{};
+  cache.rebuild(contacts);
+
+  auto islands = Islands{};
+  islands.build(registry, cache);
+
+  afk_assert(islands.get_count() == 3, "Wrong number of islands");
+  afk_assert(!islands.get_island(ground).has_value(), "Static body joined an island");
+
+  const auto island = islands.get_island(lower);
+  afk_assert(island.has_value() && islands.get_island(upper) == island,
+             "Touching bodies aren't in the same island");
+  afk_assert(islands.get_bodies(*island).size() == 2 && is_in_island(islands, *island, lower) &&
+                 is_in_island(islands, *island, upper),
+             "Island doesn't hold its bodies");
+
+  afk_assert(islands.get_island(beside) != island,
+             "Bodies on the same static body share an island");
+  afk_assert(islands.get_island(floating).has_value() &&
+                 islands.get_island(floating) != island &&
+                 islands.get_island(floating) != islands.get_island(beside),
+             "Body touching nothing doesn't have its own island");
+
+  for (auto i = usize{0}; i < islands.get_count(); ++i) {
+    for (const auto entity : islands.get_bodies(i)) {
+      afk_assert(islands.get_island(entity) == i, "Body's island doesn't hold it");
+    }
+  }
+}
+
+/**
+ * Rebuilding replaces the islands, splitting bodies that stopped touching.
+ */
+static auto test_rebuild() -> void {
+  auto registry = Registry{};
+
+  const auto first  = add_body(registry, glm::vec3{0.0f}, glm::vec3{0.0f});
+  const auto second = add_body(registry, {0.0f, 2.0f, 0.0f}, glm::vec3{0.0f});
+
+  auto contacts = ContactBuffer{};
+  contacts.add_pair(first, second);
+  contacts.add_contact(make_contact(0.01f));
+
+  auto cache = ContactCache{};
+  cache.rebuild(contacts);
+
+  auto islands = Islands{};
+  islands.build(registry, cache);
+  afk_assert(islands.get_count() == 1, "Touching bodies aren't in one island");
+
+  cache.rebuild(ContactBuffer{});
+  islands.build(registry, cache);
+  afk_assert(islands.get_count() == 2 && islands.get_island(first) != islands.get_island(second),
+             "Bodies that stopped touching still share an island");
+}
+
+auto main() -> i32 {
+  test_build();
+  test_rebuild();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,274 @@
+#include <cmath>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/Test.hpp"
+#include "afk/debug/Assert.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/physics/ContactBuffer.hpp"
+#include "afk/physics/Geometry.hpp"
+#include "afk/physics/NarrowPhase.hpp"
+
+using afk::ecs::Entity;
+using afk::physics::ContactBuffer;
+using afk::physics::NarrowPhase;
+using afk::physics::WorldBox;
+using afk::physics::WorldShape;
+using afk::physics::WorldSphere;
+using afk::test::ENTITY_A;
+using afk::test::ENTITY_B;
+using afk::test::IDENTITY;
+using afk::test::is_near;
+using afk::test::rotate;
+
+/**
+ * Generates the contacts between two shapes, belonging to ENTITY_A and
+ * ENTITY_B respectively.
+ *
+ * @param shape1 The first shape.
+ * @param shape2 The second shape.
+ * @param contacts The buffer to add to.
+ */
+static auto collide(const WorldShape &shape1, const WorldShape &shape2,
+                    ContactBuffer &contacts) -> void {
+  auto narrow_phase = NarrowPhase{};
+  narrow_phase.add_pair(ENTITY_A, shape1, ENTITY_B, shape2);
+  narrow_phase.generate(contacts);
+}
+
+/**
+ * Returns if a buffer has a single pair, and every contact of it has the
+ * specified normal and depth.
+ *
+ * @param contacts The buffer.
+ * @param normal The normal.
+ * @param depth The penetration depth.
+ * @return If every contact matches.
+ */
+static auto is_every_contact(const ContactBuffer &contacts, const glm::vec3 &normal, f32 depth)
+    -> bool {
+  if (contacts.get_pairs().size() != 1) {
+    return false;
+  }
+
+  for (const auto &contact : contacts.get_contacts(contacts.get_pairs()[0])) {
+    if (!is_near(contact.normal, normal) || !is_near(contact.penetration_depth, depth)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * A box resting on a wider box touches it at the small box's four corners,
+ * with the normal facing from the first box to the second.
+ */
+static auto test_boxes_face() -> void {
+  const auto ground = WorldBox{glm::vec3{0.0f}, IDENTITY, {5.0f, 1.0f, 5.0f}};
+  const auto box    = WorldBox{{0.0f, 1.9f, 0.0f}, IDENTITY, glm::vec3{1.0f}};
+
+  auto contacts = ContactBuffer{};
+  collide(ground, box, contacts);
+
+  afk_assert(is_every_contact(contacts, {0.0f, 1.0f, 0.0f}, 0.1f),
+             "Resting box contacts are wrong");
+  afk_assert(contacts.get_pairs()[0].entity1 == ENTITY_A, "Pair isn't kept in order");
+  afk_assert(contacts.get_contacts(contacts.get_pairs()[0]).size() == 4,
+             "Resting box doesn't touch at each corner");
+
+  for (const auto &contact : contacts.get_contacts(contacts.get_pairs()[0])) {
+    afk_assert(is_near(contact.collider1_point.y, 1.0f) &&
+                   is_near(contact.collider2_point.y, 0.9f),
+               "Contact points aren't on each box's face");
+  }
+
+  contacts.clear();
+  collide(box, ground, contacts);
+
+  afk_assert(is_every_contact(contacts, {0.0f, -1.0f, 0.0f}, 0.1f),
+             "Reversed normal doesn't face from the first box to the second");
+  afk_assert(contacts.get_contacts(contacts.get_pairs()[0]).size() == 4,
+             "Reversed resting box doesn't touch at each corner");
+}
+
+/**
+ * Two cubes rotated about z and y, with crossed edges facing each other,
+ * touch at a single point between those edges.
+ */
+static auto test_boxes_edges() -> void {
+  const auto box1 = WorldBox{glm::vec3{0.0f}, rotate(45.0f, {0.0f, 0.0f, 1.0f}), glm::vec3{1.0f}};
+  const auto box2 =
+      WorldBox{{2.7f, 0.0f, 0.0f}, rotate(45.0f, {0.0f, 1.0f, 0.0f}), glm::vec3{1.0f}};
+
+  auto contacts = ContactBuffer{};
+  collide(box1, box2, contacts);
+
+  const auto diagonal = std::sqrt(2.0f);
+  afk_assert(is_every_contact(contacts, {1.0f, 0.0f, 0.0f}, 2.0f * diagonal - 2.7f),
+             "Crossed edge contact is wrong");
+  afk_assert(contacts.get_contacts(contacts.get_pairs()[0]).size() == 1,
+             "Crossed edges don't touch at one point");
+
+  const auto &contact = contacts.get_contacts(contacts.get_pairs()[0])[0];
+  afk_assert(is_near(contact.collider1_point, {diagonal, 0.0f, 0.0f}) &&
+                 is_near(contact.collider2_point, {2.7f - diagonal, 0.0f, 0.0f}),
+             "Crossed edge contact points aren't on the edges");
+}
+
+/**
+ * Within a group of axes, the axis of least overlap is picked exactly, even
+ * when another axis overlaps by barely more.
+ */
+static auto test_boxes_least_overlap() -> void {
+  const auto box1 = WorldBox{glm::vec3{0.0f}, IDENTITY, glm::vec3{1.0f}};
+  const auto box2 = WorldBox{{1.9f, 1.901f, 0.0f}, IDENTITY, glm::vec3{1.0f}};
+
+  auto contacts = ContactBuffer{};
+  collide(box1, box2, contacts);
+
+  afk_assert(is_every_contact(contacts, {0.0f, 1.0f, 0.0f}, 0.099f),
+             "Box contacts aren't along the axis of least overlap");
+}
+
+/**
+ * A cube tilted on another, and off to one side, overlaps it slightly less
+ * along its own face normal. It's still pushed out along the lower cube's
+ * face, as the first box's faces are preferred when they overlap about as
+ * much.
+ */
+static auto test_boxes_prefer_first_faces() -> void {
+  const auto box1 = WorldBox{glm::vec3{0.0f}, IDENTITY, glm::vec3{1.0f}};
+  const auto box2 =
+      WorldBox{{-0.2f, 1.9f, 0.0f}, rotate(0.5f, {0.0f, 0.0f, 1.0f}), glm::vec3{1.0f}};
+
+  auto contacts = ContactBuffer{};
+  collide(box1, box2, contacts);
+
+  afk_assert(contacts.get_pairs().size() == 1, "Tilted box isn't touching");
+
+  for (const auto &contact : contacts.get_contacts(contacts.get_pairs()[0])) {
+    afk_assert(is_near(contact.normal, {0.0f, 1.0f, 0.0f}),
+               "Tilted box isn't pushed out along the first box's face");
+  }
+}
+
+/**
+ * Boxes apart along any axis don't touch.
+ */
+static auto test_boxes_separate() -> void {
+  const auto box1 = WorldBox{glm::vec3{0.0f}, IDENTITY, glm::vec3{1.0f}};
+
+  auto contacts = ContactBuffer{};
+  collide(box1, WorldBox{{2.1f, 0.0f, 0.0f}, IDENTITY, glm::vec3{1.0f}}, contacts);
+  collide(box1,
+          WorldBox{{2.9f, 0.0f, 0.0f}, rotate(45.0f, {0.0f, 1.0f, 0.0f}), glm::vec3{1.0f}},
+          contacts);
+
+  afk_assert(contacts.is_empty(), "Separate boxes touch");
+}
+
+/**
+ * A sphere on a box touches it at the closest point, in either order.
+ */
+static auto test_sphere_box() -> void {
+  const auto sphere = WorldSphere{{0.0f, 1.5f, 0.0f}, 1.0f};
+  const auto box    = WorldBox{glm::vec3{0.0f}, IDENTITY, glm::vec3{1.0f}};
+
+  auto contacts = ContactBuffer{};
+  collide(sphere, box, contacts);
+
+  afk_assert(is_every_contact(contacts, {0.0f, -1.0f, 0.0f}, 0.5f),
+             "Sphere contact is wrong");
+
+  const auto pair = contacts.get_pairs()[0];
+  afk_assert(pair.entity1 == ENTITY_A && pair.entity2 == ENTITY_B, "Pair isn't kept in order");
+
+  const auto &contact = contacts.get_contacts(pair)[0];
+  afk_assert(is_near(contact.collider1_point, {0.0f, 0.5f, 0.0f}) &&
+                 is_near(contact.collider2_point, {0.0f, 1.0f, 0.0f}),
+             "Sphere contact points are wrong");
+
+  contacts.clear();
+  collide(box, sphere, contacts);
+
+  afk_assert(is_every_contact(contacts, {0.0f, 1.0f, 0.0f}, 0.5f),
+             "Flipped sphere contact is wrong");
+
+  const auto flipped = contacts.get_pairs()[0];
+  afk_assert(flipped.entity1 == ENTITY_A && flipped.entity2 == ENTITY_B,
+             "Flipped pair isn't kept in order");
+
+  const auto &flipped_contact = contacts.get_contacts(flipped)[0];
+  afk_assert(is_near(flipped_contact.collider1_point, {0.0f, 1.0f, 0.0f}) &&
+                 is_near(flipped_contact.collider2_point, {0.0f, 0.5f, 0.0f}),
+             "Flipped sphere contact points weren't swapped");
+}
+
+/**
+ * A sphere whose centre is inside a box is pushed out through the nearest
+ * face, and a sphere only touches a rotated box's corner once it's rotated.
+ */
+static auto test_sphere_box_inside_and_rotated() -> void {
+  const auto box = WorldBox{glm::vec3{0.0f}, IDENTITY, glm::vec3{1.0f}};
+
+  auto contacts = ContactBuffer{};
+  collide(WorldSphere{{0.0f, 0.8f, 0.0f}, 0.5f}, box, contacts);
+
+  afk_assert(is_every_contact(contacts, {0.0f, -1.0f, 0.0f}, 0.7f),
+             "Sphere inside isn't pushed out through the nearest face");
+
+  const auto sphere  = WorldSphere{{1.5f, 0.0f, 0.0f}, 0.1f};
+  const auto rotated =
+      WorldBox{glm::vec3{0.0f}, rotate(45.0f, {0.0f, 0.0f, 1.0f}), glm::vec3{1.0f}};
+
+  contacts.clear();
+  collide(sphere, box, contacts);
+  afk_assert(contacts.is_empty(), "Sphere beside a box touches it");
+
+  collide(sphere, rotated, contacts);
+  afk_assert(is_every_contact(contacts, {-1.0f, 0.0f, 0.0f}, 0.1f - (1.5f - std::sqrt(2.0f))),
+             "Sphere doesn't touch the rotated box's corner");
+}
+
+/**
+ * Only the touching pairs of more sphere-box pairs than fit in one set of
+ * lanes get contacts, with the padding lanes ignored.
+ */
+static auto test_sphere_box_lanes() -> void {
+  const auto box = WorldBox{glm::vec3{0.0f}, IDENTITY, glm::vec3{1.0f}};
+
+  auto narrow_phase = NarrowPhase{};
+
+  for (auto i = u32{0}; i < 7; ++i) {
+    // every other sphere is out of reach
+    const auto x = i % 2 == 0 ? 1.5f : 3.0f;
+    narrow_phase.add_pair(Entity{i + 10}, WorldSphere{{x, 0.0f, 0.0f}, 1.0f}, ENTITY_A, box);
+  }
+
+  auto contacts = ContactBuffer{};
+  narrow_phase.generate(contacts);
+
+  const auto pairs = contacts.get_pairs();
+  afk_assert(pairs.size() == 4, "Wrong number of sphere-box pairs touch");
+
+  for (auto i = usize{0}; i < pairs.size(); ++i) {
+    afk_assert(pairs[i].entity1 == Entity{static_cast<u32>(i * 2 + 10)},
+               "Out of reach sphere touches the box");
+  }
+}
+
+auto main() -> i32 {
+  test_boxes_face();
+  test_boxes_edges();
+  test_boxes_least_overlap();
+  test_boxes_prefer_first_faces();
+  test_boxes_separate();
+  test_sphere_box();
+  test_sphere_box_inside_and_rotated();
+  test_sphere_box_lanes();
+
+  return EXIT_SUCCESS;
+}
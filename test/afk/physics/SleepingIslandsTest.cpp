@@ -0,0 +1,221 @@
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "afk/NumericTypes.hpp"
+#include "afk/Test.hpp"
+#include "afk/debug/Assert.hpp"
+#include "afk/ecs/Entity.hpp"
+#include "afk/ecs/Registry.hpp"
+#include "afk/ecs/component/ColliderComponent.hpp"
+#include "afk/ecs/component/PhysicsComponent.hpp"
+#include "afk/physics/ContactBuffer.hpp"
+#include "afk/physics/ContactCache.hpp"
+#include "afk/physics/Islands.hpp"
+#include "afk/physics/SleepingIslands.hpp"
+
+using afk::ecs::Entity;
+using afk::ecs::Registry;
+using afk::ecs::component::ColliderComponent;
+using afk::ecs::component::PhysicsComponent;
+using afk::physics::ContactBuffer;
+using afk::physics::ContactCache;
+using afk::physics::Islands;
+using afk::physics::SleepingIslands;
+using afk::test::add_body;
+using afk::test::make_contact;
+
+/** The time advanced by each step, in seconds. */
+static constexpr f32 DT = 0.1f;
+
+/** The number of steps a body at rest takes to fall asleep, with one to spare. */
+static constexpr i32 STEPS_TO_SLEEP = static_cast<i32>(SleepingIslands::TIME_TO_SLEEP / DT) + 2;
+
+/**
+ * A static ground with a stack of boxes resting on it, and the bodies that
+ * fell asleep or woke.
+ */
+struct Scene {
+  /** The registry the bodies belong to. */
+  Registry registry = {};
+  /** The static ground. */
+  Entity ground = {};
+  /** The boxes, each resting on the one before it. */
+  std::vector<Entity> boxes = {};
+  /** The contacts of the last step. */
+  ContactCache contact_cache = {};
+  /** The islands of the last step. */
+  Islands islands = {};
+  /** The sleeping islands. */
+  SleepingIslands sleeping_islands = {};
+  /** Each body that fell asleep or woke, in order. */
+  std::vector<std::pair<Entity, bool>> changes = {};
+
+  /**
+   * Constructs a stack of boxes at rest on the ground.
+   *
+   * @param box_count The number of boxes.
+   */
+  explicit Scene(usize box_count) {
+    this->ground = add_body(this->registry, glm::vec3{0.0f}, glm::vec3{0.0f}, true);
+    this->registry.emplace<ColliderComponent>(this->ground);
+
+    for (auto i = usize{0}; i < box_count; ++i) {
+      const auto box =
+          add_body(this->registry, {0.0f, static_cast<f32>(i) * 2.0f + 1.0f, 0.0f}, glm::vec3{0.0f});
+      this->registry.emplace<ColliderComponent>(box);
+      this->boxes.push_back(box);
+    }
+  }
+
+  /**
+   * Runs a step, waking islands before the contacts are found and putting
+   * them to sleep afterwards. Contacts between two sleeping boxes aren't
+   * found, the same as resting colliders.
+   *
+   * @param is_waking_all Wake every island.
+   */
+  auto step(bool is_waking_all = false) -> void {
+    const auto on_change = [this](Entity entity, bool is_sleeping) {
+      this->changes.emplace_back(entity, is_sleeping);
+    };
+
+    this->islands.build(this->registry, this->contact_cache);
+    this->sleeping_islands.wake(this->registry, this->islands, is_waking_all, on_change);
+
+    auto contacts = ContactBuffer{};
+
+    for (auto i = usize{0}; i < this->boxes.size(); ++i) {
+      const auto lower = i == 0 ? this->ground : this->boxes[i - 1];
+
+      if (!this->registry.valid(lower) || (i > 0 && this->is_sleeping(lower) &&
+                                           this->is_sleeping(this->boxes[i]))) {
+        continue;
+      }
+
+      contacts.add_pair(lower, this->boxes[i]);
+      contacts.add_contact(make_contact(0.01f));
+    }
+
+    this->contact_cache.rebuild(contacts);
+    this->islands.build(this->registry, this->contact_cache);
+    this->sleeping_islands.sleep(this->registry, this->islands, this->contact_cache, DT, on_change);
+  }
+
+  /**
+   * Returns if a body is asleep.
+   *
+   * @param entity The entity of the body.
+   * @return If it's asleep.
+   */
+  auto is_sleeping(Entity entity) const -> bool {
+    return this->registry.get<PhysicsComponent>(entity).is_sleeping;
+  }
+
+  /**
+   * Runs steps until the boxes have been still for long enough to sleep.
+   */
+  auto settle() -> void {
+    for (auto i = 0; i < STEPS_TO_SLEEP; ++i) {
+      this->step();
+    }
+  }
+};
+
+/**
+ * A box at rest, or barely moving, falls asleep once it's been still for long
+ * enough, with its velocity zeroed, while a moving box stays awake.
+ */
+static auto test_sleep() -> void {
+  auto scene = Scene{1};
+  auto &box  = scene.registry.get<PhysicsComponent>(scene.boxes[0]);
+
+  scene.step();
+  afk_assert(!box.is_sleeping, "Box fell asleep straight away");
+
+  box.linear_velocity = glm::vec3{0.01f, 0.0f, 0.0f};
+  scene.settle();
+  afk_assert(box.is_sleeping, "Box at rest didn't fall asleep");
+  afk_assert(box.linear_velocity == glm::vec3{0.0f}, "Sleeping box is still moving");
+
+  auto moving = Scene{1};
+  moving.registry.get<PhysicsComponent>(moving.boxes[0]).linear_velocity =
+      glm::vec3{1.0f, 0.0f, 0.0f};
+  moving.settle();
+  afk_assert(!moving.is_sleeping(moving.boxes[0]), "Moving box fell asleep");
+}
+
+/**
+ * A sleeping box reports falling asleep once, and wakes when a force is
+ * queued on it.
+ */
+static auto test_wake_when_pushed() -> void {
+  auto scene     = Scene{1};
+  const auto box = scene.boxes[0];
+  scene.settle();
+
+  const auto fell_asleep = std::vector{std::pair{box, true}};
+  afk_assert(scene.changes == fell_asleep, "Falling asleep wasn't reported once");
+
+  scene.changes.clear();
+  scene.step();
+  afk_assert(scene.is_sleeping(box) && scene.changes.empty(), "Sleeping box woke by itself");
+
+  scene.registry.get<PhysicsComponent>(box).external_forces = {1.0f, 0.0f, 0.0f};
+  scene.step();
+  afk_assert(!scene.is_sleeping(box), "Pushed box didn't wake");
+  const auto woke = std::vector{std::pair{box, false}};
+  afk_assert(scene.changes == woke, "Waking wasn't reported");
+}
+
+/**
+ * Pushing the top of a sleeping stack wakes the whole stack, even though the
+ * contacts holding the stack together stopped being found when it fell
+ * asleep.
+ */
+static auto test_wake_whole_island() -> void {
+  auto scene = Scene{3};
+  scene.settle();
+
+  for (const auto box : scene.boxes) {
+    afk_assert(scene.is_sleeping(box), "Stack didn't fall asleep");
+  }
+
+  scene.registry.get<PhysicsComponent>(scene.boxes.back()).external_forces = {1.0f, 0.0f, 0.0f};
+  scene.step();
+
+  for (const auto box : scene.boxes) {
+    afk_assert(!scene.is_sleeping(box), "Pushing the stack didn't wake all of it");
+  }
+}
+
+/**
+ * Sleeping boxes wake when what they rest on is destroyed, or when told to
+ * wake, such as when gravity changes.
+ */
+static auto test_wake_when_support_lost() -> void {
+  auto scene = Scene{1};
+  scene.settle();
+  afk_assert(scene.is_sleeping(scene.boxes[0]), "Box didn't fall asleep");
+
+  scene.step(true);
+  afk_assert(!scene.is_sleeping(scene.boxes[0]), "Box wasn't woken with every island");
+
+  scene.settle();
+  afk_assert(scene.is_sleeping(scene.boxes[0]), "Box didn't fall asleep again");
+
+  scene.registry.destroy(scene.ground);
+  scene.step();
+  afk_assert(!scene.is_sleeping(scene.boxes[0]), "Box didn't wake when its support was destroyed");
+}
+
+auto main() -> i32 {
+  test_sleep();
+  test_wake_when_pushed();
+  test_wake_whole_island();
+  test_wake_when_support_lost();
+
+  return EXIT_SUCCESS;
+}